@@ -0,0 +1,241 @@
+// Host benchmark of the InkHUD render path: a text-heavy frame drawn per pixel (before the span fast paths) and per span
+// (after), with the buffers compared byte for byte. Each stage lives in its own translation unit in the firmware, so the
+// calls are kept out of line here too.
+//
+//   g++ -std=gnu++17 -Os -o /tmp/inkhud-render-bench bin/inkhud-render-bench.cpp && /tmp/inkhud-render-bench
+//
+// The per pixel path models AdafruitGFX's defaults without the writeLine() overhead, so its times are a lower bound.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Just enough of AdafruitGFX's gfxfont.h for the font below
+#define PROGMEM
+typedef struct {
+    uint16_t bitmapOffset;
+    uint8_t width, height, xAdvance;
+    int8_t xOffset, yOffset;
+} GFXglyph;
+typedef struct {
+    uint8_t *bitmap;
+    GFXglyph *glyph;
+    uint16_t first, last;
+    uint8_t yAdvance;
+} GFXfont;
+
+#include "../src/graphics/niche/Fonts/FreeSans6pt7b.h"
+#define NOINLINE __attribute__((noinline))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? ((value) |= (1UL << (bit))) : ((value) &= ~(1UL << (bit))))
+using std::max;
+using std::min;
+typedef bool Color;
+
+static const uint16_t DW = 296, DH = 128; // Driver size, e.g. Vision Master E290
+static const uint16_t BW = (DW + 7) / 8;
+static uint8_t imageBuffer[BW * DH];
+static uint8_t rotation;
+
+struct Renderer {
+    NOINLINE void rotatePixelCoords(int16_t *x, int16_t *y)
+    {
+        int16_t x1 = 0, y1 = 0;
+        switch (rotation) {
+        case 0: x1 = *x; y1 = *y; break;
+        case 1: x1 = (DW - 1) - *y; y1 = *x; break;
+        case 2: x1 = (DW - 1) - *x; y1 = (DH - 1) - *y; break;
+        case 3: x1 = *y; y1 = (DH - 1) - *x; break;
+        }
+        *x = x1; *y = y1;
+    }
+    NOINLINE void handlePixel(int16_t x, int16_t y, Color c)
+    {
+        rotatePixelCoords(&x, &y);
+        uint32_t byteNum = (y * BW) + (x / 8);
+        uint8_t bitNum = 7 - (x % 8);
+        bitWrite(imageBuffer[byteNum], bitNum, c);
+    }
+    void fillBufferRow(uint16_t x, uint16_t y, uint16_t w, Color c)
+    {
+        uint8_t *row = imageBuffer + (y * BW);
+        uint16_t end = x + w;
+        while ((x % 8) && x < end) { bitWrite(row[x / 8], 7 - (x % 8), c); x++; }
+        uint16_t wholeBytes = (end - x) / 8;
+        memset(row + (x / 8), c ? 0xFF : 0x00, wholeBytes);
+        x += wholeBytes * 8;
+        while (x < end) { bitWrite(row[x / 8], 7 - (x % 8), c); x++; }
+    }
+    void fillBufferColumn(uint16_t x, uint16_t y, uint16_t h, Color c)
+    {
+        uint8_t *byte = imageBuffer + (y * BW) + (x / 8);
+        uint8_t mask = 1 << (7 - (x % 8));
+        for (uint16_t i = 0; i < h; i++) {
+            if (c) *byte |= mask; else *byte &= ~mask;
+            byte += BW;
+        }
+    }
+    NOINLINE void handleSpan(int16_t x, int16_t y, uint16_t w, Color c)
+    {
+        if (w == 0) return;
+        switch (rotation) {
+        case 0: fillBufferRow(x, y, w, c); break;
+        case 1: fillBufferColumn((DW - 1) - y, x, w, c); break;
+        case 2: fillBufferRow((DW - 1) - (x + w - 1), (DH - 1) - y, w, c); break;
+        case 3: fillBufferColumn(y, (DH - 1) - (x + w - 1), w, c); break;
+        }
+    }
+} renderer;
+
+struct InkHUD {
+    NOINLINE void drawPixel(int16_t x, int16_t y, Color c) { renderer.handlePixel(x, y, c); }
+    NOINLINE void drawSpan(int16_t x, int16_t y, uint16_t w, Color c) { renderer.handleSpan(x, y, w, c); }
+} inkhud;
+
+struct Tile {
+    int16_t left, top, width, height;
+    NOINLINE void handleAppletPixel(int16_t x, int16_t y, Color c)
+    {
+        x += left; y += top;
+        if (x >= left && x < (left + width) && y >= top && y < (top + height))
+            inkhud.drawPixel(x, y, c);
+    }
+    NOINLINE void handleAppletSpan(int16_t x, int16_t y, int16_t w, Color c)
+    {
+        x += left; y += top;
+        if (y < top || y >= top + height) return;
+        int16_t x0 = max(x, left);
+        int16_t x1 = min((int16_t)(x + w), (int16_t)(left + width));
+        if (x1 > x0) inkhud.drawSpan(x0, y, x1 - x0, c);
+    }
+} tile;
+
+static const GFXfont *gfxFont = &FreeSans6pt7b;
+
+// The AdafruitGFX side, both ways: virtual dispatch as in the library
+struct Applet {
+    int16_t cropLeft = 0, cropTop = 0, cropWidth, cropHeight;
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color)
+    {
+        if (x >= cropLeft && x < (cropLeft + cropWidth) && y >= cropTop && y < (cropTop + cropHeight))
+            tile.handleAppletPixel(x, y, (Color)color);
+    }
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) = 0;
+    virtual void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color) = 0;
+    void print(int16_t x, int16_t y, const char *s, uint16_t color)
+    {
+        for (; *s; s++) {
+            drawChar(x, y, *s, color);
+            x += gfxFont->glyph[*s - gfxFont->first].xAdvance;
+        }
+    }
+    virtual ~Applet() {}
+};
+
+// Before: AdafruitGFX's defaults, every set bit or filled pixel is a writePixel()
+struct PixelApplet : Applet {
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override
+    {
+        for (int16_t i = x; i < x + w; i++) // writeFastVLine() per column, then writeLine() per pixel
+            for (int16_t j = y; j < y + h; j++)
+                drawPixel(i, j, color);
+    }
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color) override
+    {
+        const GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+        const uint8_t *bitmap = gfxFont->bitmap;
+        uint16_t bo = glyph->bitmapOffset;
+        uint8_t bits = 0, bit = 0;
+        for (uint8_t yy = 0; yy < glyph->height; yy++)
+            for (uint8_t xx = 0; xx < glyph->width; xx++) {
+                if (!(bit++ & 7)) bits = bitmap[bo++];
+                if (bits & 0x80) drawPixel(x + glyph->xOffset + xx, y + glyph->yOffset + yy, color);
+                bits <<= 1;
+            }
+    }
+};
+
+// After: the span and glyph overrides of InkHUD::Applet
+struct SpanApplet : Applet {
+    NOINLINE void drawSpan(int16_t x, int16_t y, int16_t w, Color c)
+    {
+        if (y < cropTop || y >= cropTop + cropHeight) return;
+        int16_t x0 = max(x, cropLeft);
+        int16_t x1 = min((int16_t)(x + w), (int16_t)(cropLeft + cropWidth));
+        if (x1 > x0) tile.handleAppletSpan(x0, y, x1 - x0, c);
+    }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override
+    {
+        for (int16_t row = max(y, cropTop); row < min((int16_t)(y + h), (int16_t)(cropTop + cropHeight)); row++)
+            drawSpan(x, row, w, (Color)color);
+    }
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color) override
+    {
+        const GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+        const uint8_t *bitmap = gfxFont->bitmap + glyph->bitmapOffset;
+        uint8_t bits = 0;
+        uint16_t bit = 0;
+        x += glyph->xOffset;
+        y += glyph->yOffset;
+        for (uint8_t yy = 0; yy < glyph->height; yy++) {
+            int16_t runStart = -1;
+            for (uint8_t xx = 0; xx < glyph->width; xx++) {
+                if (!(bit++ & 7)) bits = *bitmap++;
+                if (bits & 0x80) {
+                    if (runStart < 0) runStart = xx;
+                } else if (runStart >= 0) {
+                    drawSpan(x + runStart, y + yy, xx - runStart, color);
+                    runStart = -1;
+                }
+                bits <<= 1;
+            }
+            if (runStart >= 0) drawSpan(x + runStart, y + yy, glyph->width - runStart, color);
+        }
+    }
+};
+
+// A message-list style frame: header bar with inverted title, a line of text per row, a highlighted row, a divider
+static void frame(Applet &a, int16_t w, int16_t h)
+{
+    memset(imageBuffer, 0xFF, sizeof(imageBuffer)); // clearBuffer()
+    a.cropWidth = w; a.cropHeight = h;
+    a.fillRect(0, 0, w, 12, 0);
+    a.print(2, 9, "Messages  3 of 17  12:41", 1);
+    int16_t row = 0;
+    for (int16_t y = 24; y < h; y += 12, row++) {
+        if (row == 2) a.fillRect(0, y - 9, w, 12, 0);
+        a.print(2, y, "!a1b2c3d4: Nearly there, ETA 20 minutes via the ridge", row == 2 ? 1 : 0);
+    }
+    a.fillRect(0, h - 1, w, 1, 0);
+}
+
+int main()
+{
+    static uint8_t before[sizeof(imageBuffer)];
+    PixelApplet pixel;
+    SpanApplet span;
+    const int iterations = 2000;
+    for (rotation = 0; rotation < 4; rotation++) {
+        int16_t w = rotation & 1 ? DH : DW, h = rotation & 1 ? DW : DH;
+        tile = {0, 0, w, h};
+        frame(pixel, w, h);
+        memcpy(before, imageBuffer, sizeof(imageBuffer));
+        frame(span, w, h);
+        bool same = !memcmp(before, imageBuffer, sizeof(imageBuffer));
+
+        double us[2];
+        Applet *applets[2] = {&pixel, &span};
+        for (int i = 0; i < 2; i++) {
+            us[i] = 1e9;
+            for (int repeat = 0; repeat < 7; repeat++) { // Best of, to keep other load on the host out of it
+                auto start = std::chrono::steady_clock::now();
+                for (int n = 0; n < iterations; n++)
+                    frame(*applets[i], w, h);
+                double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+                us[i] = std::min(us[i], elapsed / iterations);
+            }
+        }
+        printf("rotation %d (%dx%d): per pixel %.1f us, per span %.1f us, %.1fx, buffers %s\n", rotation, w, h, us[0], us[1],
+               us[0] / us[1], same ? "identical" : "DIFFER");
+    }
+}
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Decode binary packet traces written by meshtasticd (Logging: BinaryTraceFile in config.yaml).
+
+Converts a trace to JSON lines or CSV, or replays the decoded packets into a simulator build of meshtasticd over TCP.
+Decoding the packets themselves needs the meshtastic python package, without it the raw protobuf is printed as hex.
+
+Usage:
+    meshtastic-trace.py trace.bin                       # JSON, one record per line
+    meshtastic-trace.py --format csv trace.bin > trace.csv
+    meshtastic-trace.py --replay localhost --speed 0 trace.bin
+"""
+
+import argparse
+import csv
+import json
+import struct
+import sys
+import time
+
+MAGIC = b"MTTRACE1"
+HEADER = struct.Struct("<BBQI")  # event, reason, monotonic usec, unix time
+
+EVENTS = {1: "rx", 2: "decode", 3: "route", 4: "tx", 5: "drop", 6: "radio", 7: "enqueue"}
+REASONS = {
+    0: "",
+    1: "ignore_list",
+    2: "ignored_node",
+    3: "from_broadcast",
+    4: "ignore_mqtt",
+    5: "filtered",
+    6: "decode_failure",
+}
+
+try:
+    from google.protobuf.json_format import MessageToDict
+    from meshtastic.protobuf import mesh_pb2, portnums_pb2
+except ImportError:
+    mesh_pb2 = None
+
+
+def read_trace(f):
+    """Yield (event, reason, usec, unix_time, packet bytes) for every record in the file"""
+    data = f.read()
+    pos = 0
+    while pos + 2 <= len(data):
+        # Every time meshtasticd opens the file it appends the magic again
+        if data[pos : pos + len(MAGIC)] == MAGIC:
+            pos += len(MAGIC)
+            continue
+        (length,) = struct.unpack_from("<H", data, pos)
+        pos += 2
+        if length < HEADER.size or pos + length > len(data):
+            print(f"Truncated record at offset {pos - 2}", file=sys.stderr)
+            break
+        event, reason, usec, unix_time = HEADER.unpack_from(data, pos)
+        yield event, reason, usec, unix_time, data[pos + HEADER.size : pos + length]
+        pos += length
+
+
+def parse_packet(raw):
+    if mesh_pb2 is None:
+        return None
+    p = mesh_pb2.MeshPacket()
+    p.ParseFromString(raw)
+    return p
+
+
+def to_dict(record):
+    event, reason, usec, unix_time, raw = record
+    d = {
+        "event": EVENTS.get(event, str(event)),
+        "reason": REASONS.get(reason, str(reason)),
+        "usec": usec,
+        "time": unix_time,
+    }
+    p = parse_packet(raw)
+    if p is None:
+        d["packet"] = raw.hex()
+    else:
+        d["packet"] = MessageToDict(p)
+    return d
+
+
+def write_json(records, out):
+    for r in records:
+        out.write(json.dumps(to_dict(r)) + "\n")
+
+
+def write_csv(records, out):
+    w = csv.writer(out)
+    w.writerow(["usec", "time", "event", "reason", "from", "to", "id", "channel", "hop_limit", "hop_start", "rssi", "snr",
+                "portnum", "size"])
+    for event, reason, usec, unix_time, raw in records:
+        p = parse_packet(raw)
+        row = [usec, unix_time, EVENTS.get(event, event), REASONS.get(reason, reason)]
+        if p is None:
+            row += [""] * 9 + [len(raw)]
+        else:
+            decoded = p.WhichOneof("payload_variant") == "decoded"
+            row += [f"!{getattr(p, 'from'):08x}", f"!{p.to:08x}", f"0x{p.id:08x}", p.channel, p.hop_limit, p.hop_start,
+                    p.rx_rssi, p.rx_snr, p.decoded.portnum if decoded else "",
+                    len(p.decoded.payload) if decoded else len(p.encrypted)]
+        w.writerow(row)
+
+
+def replay(records, host, speed):
+    """Inject decoded packets into a simulator build, the same way the python simulator test does"""
+    if mesh_pb2 is None:
+        sys.exit("Replaying needs the meshtastic python package")
+    from meshtastic.tcp_interface import TCPInterface
+
+    iface = TCPInterface(hostname=host)
+    first_usec = None
+    start = time.monotonic()
+    sent = 0
+    try:
+        for event, _reason, usec, _unix_time, raw in records:
+            if EVENTS.get(event) != "decode":
+                continue
+            if first_usec is None:
+                first_usec = usec
+            if speed > 0:
+                delay = (usec - first_usec) / 1e6 / speed - (time.monotonic() - start)
+                if delay > 0:
+                    time.sleep(delay)
+
+            p = parse_packet(raw)
+            c = mesh_pb2.Compressed(portnum=p.decoded.portnum, data=p.decoded.payload)
+            p.decoded.portnum = portnums_pb2.PortNum.SIMULATOR_APP
+            p.decoded.payload = c.SerializeToString()
+            iface._sendToRadio(mesh_pb2.ToRadio(packet=p))
+            sent += 1
+    finally:
+        iface.close()
+    print(f"Replayed {sent} packets in {time.monotonic() - start:.1f}s", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode meshtasticd binary packet traces")
+    parser.add_argument("trace", help="trace file written by meshtasticd")
+    parser.add_argument("--format", choices=["json", "csv"], default="json")
+    parser.add_argument("--replay", metavar="HOST", help="replay decoded packets into a simulator build on HOST")
+    parser.add_argument("--speed", type=float, default=1.0, help="replay speed factor, 0 for as fast as possible")
+    args = parser.parse_args()
+
+    with open(args.trace, "rb") as f:
+        records = read_trace(f)
+        if args.replay:
+            replay(records, args.replay, args.speed)
+        elif args.format == "csv":
+            write_csv(records, sys.stdout)
+        else:
+            write_json(records, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,60 @@
+#include "BootTimeline.h"
+#include "configuration.h"
+
+namespace BootTimeline
+{
+
+struct Phase {
+    const char *name;
+    uint32_t start, end; // msec since reset
+};
+
+static Phase phases[BOOT_TIMELINE_MAX_PHASES];
+static uint8_t numPhases = 0;
+static uint32_t lastMark = 0;
+static bool printed = false;
+
+static void add(const char *name, uint32_t start, uint32_t end)
+{
+    if (numPhases < BOOT_TIMELINE_MAX_PHASES)
+        phases[numPhases++] = {name, start, end};
+}
+
+void mark(const char *phase)
+{
+    uint32_t now = millis();
+    add(phase, lastMark, now);
+    lastMark = now;
+}
+
+void span(const char *name, uint32_t startMsec)
+{
+    uint32_t now = millis();
+    add(name, startMsec, now);
+    // The timeline has been logged already, so report this one on its own
+    if (printed)
+        LOG_INFO("Boot: %s took %u ms, done %u ms after reset", name, now - startMsec, now);
+}
+
+void print()
+{
+    uint32_t total = 1;
+    for (uint8_t i = 0; i < numPhases; i++)
+        if (phases[i].end > total)
+            total = phases[i].end;
+
+    LOG_INFO("Boot timeline, %u ms since reset:", millis());
+    for (uint8_t i = 0; i < numPhases; i++) {
+        // Draw each phase as a bar on a common time axis, so overlapping work and the long poles stand out
+        char bar[BOOT_TIMELINE_BAR_WIDTH + 1];
+        uint32_t from = (uint64_t)phases[i].start * BOOT_TIMELINE_BAR_WIDTH / total;
+        uint32_t to = (uint64_t)phases[i].end * BOOT_TIMELINE_BAR_WIDTH / total;
+        for (uint32_t c = 0; c < BOOT_TIMELINE_BAR_WIDTH; c++)
+            bar[c] = (c >= from && (c < to || c == from)) ? '#' : '.';
+        bar[BOOT_TIMELINE_BAR_WIDTH] = '\0';
+        LOG_INFO("  %-16s |%s| %6u ms  +%u ms", phases[i].name, bar, phases[i].start, phases[i].end - phases[i].start);
+    }
+    printed = true;
+}
+
+} // namespace BootTimeline
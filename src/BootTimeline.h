@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifndef BOOT_TIMELINE_MAX_PHASES
+#define BOOT_TIMELINE_MAX_PHASES 24
+#endif
+
+// Width of the waterfall bars in the log
+#ifndef BOOT_TIMELINE_BAR_WIDTH
+#define BOOT_TIMELINE_BAR_WIDTH 32
+#endif
+
+/**
+ * Records how long each part of the boot takes, so that startup regressions show up in the log.
+ *
+ * setup() marks the end of each phase in turn. Work that carries on in the background after setup() (like finding the
+ * GPS) adds a span of its own once it is done.
+ */
+namespace BootTimeline
+{
+
+/// End the current phase of setup() and start the next one
+void mark(const char *phase);
+
+/// Record something that ran from startMsec until now, in parallel with the rest of the boot
+void span(const char *name, uint32_t startMsec);
+
+/// Log every phase recorded so far as a waterfall
+void print();
+
+} // namespace BootTimeline
@@ -24,6 +24,12 @@
 #define MESHTASTIC_LOG_LEVEL_CRIT "CRIT "
 #define MESHTASTIC_LOG_LEVEL_TRACE "TRACE"
 
+// Compile time log level gate: calls below this level compile to nothing, so their arguments are never formatted.
+// 0 = TRACE, 1 = DEBUG, 2 = INFO, 3 = WARN, 4 = ERROR, 5 = CRIT
+#ifndef MESHTASTIC_LOG_LEVEL_MIN
+#define MESHTASTIC_LOG_LEVEL_MIN 0
+#endif
+
 #include "SerialConsole.h"
 
 // If defined we will include support for ARM ICE "semihosting" for a virtual
@@ -46,13 +52,33 @@
 #define LOG_TRACE(...) SEGGER_RTT_printf(0, __VA_ARGS__)
 #else
 #if defined(DEBUG_PORT) && !defined(DEBUG_MUTE)
+#if MESHTASTIC_LOG_LEVEL_MIN <= 1
 #define LOG_DEBUG(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...)
+#endif
+#if MESHTASTIC_LOG_LEVEL_MIN <= 2
 #define LOG_INFO(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...)
+#endif
+#if MESHTASTIC_LOG_LEVEL_MIN <= 3
 #define LOG_WARN(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...)
+#endif
+#if MESHTASTIC_LOG_LEVEL_MIN <= 4
 #define LOG_ERROR(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...)
+#endif
 #define LOG_CRIT(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_CRIT, __VA_ARGS__)
+#if MESHTASTIC_LOG_LEVEL_MIN <= 0
 #define LOG_TRACE(...) DEBUG_PORT.log(MESHTASTIC_LOG_LEVEL_TRACE, __VA_ARGS__)
 #else
+#define LOG_TRACE(...)
+#endif
+#else
 #define LOG_DEBUG(...)
 #define LOG_INFO(...)
 #define LOG_WARN(...)
@@ -167,6 +193,7 @@ class Syslog
 
     bool vlogf(uint16_t pri, const char *fmt, va_list args) __attribute__((format(printf, 3, 0)));
     bool vlogf(uint16_t pri, const char *appName, const char *fmt, va_list args) __attribute__((format(printf, 3, 0)));
+    bool log(uint16_t pri, const char *appName, const char *message); // Already formatted message
 };
 
 #endif // HAS_NETWORKING
\ No newline at end of file
@@ -47,15 +47,63 @@ size_t RedirectablePrint::write(uint8_t c)
               // serial port said (which could be zero)
 }
 
+// ANSI color for each log level. Levels are told apart by their first character, which is unique
+static const char *levelColor(const char *logLevel)
+{
+    switch (logLevel[0]) {
+    case 'D':
+        return "\u001b[34m";
+    case 'I':
+        return "\u001b[32m";
+    case 'W':
+        return "\u001b[33m";
+    case 'E':
+        return "\u001b[31m";
+    case 'T':
+        return "\u001b[35m";
+    default:
+        return "";
+    }
+}
+
 size_t RedirectablePrint::vprintf(const char *logLevel, const char *format, va_list arg)
 {
-    va_list copy;
-#if ENABLE_JSON_LOGGING || ARCH_PORTDUINO
-    static char printBuf[512];
+    size_t len = 0;
+
+#ifdef HAS_FREE_RTOS
+    if (inDebugPrint == nullptr) {
+        // Before rpInit(), nothing else can be printing yet
+        len = printFormatted(line.text, sizeof(line.text), logLevel, format, arg);
+    } else if (debugPrintOwner == xTaskGetCurrentTaskHandle()) {
+        // Printed by a sink, while 'line' holds the message being printed. Rare, so a short line on the stack does
+        char buf[LOG_NESTED_PRINT_MAX];
+        len = printFormatted(buf, sizeof(buf), logLevel, format, arg);
+    } else if (xSemaphoreTake(inDebugPrint, portMAX_DELAY) == pdTRUE) {
+        debugPrintOwner = xTaskGetCurrentTaskHandle();
+        len = printFormatted(line.text, sizeof(line.text), logLevel, format, arg);
+        debugPrintOwner = nullptr;
+        xSemaphoreGive(inDebugPrint);
+    }
 #else
-    static char printBuf[160];
+    if (inDebugPrint) {
+        char buf[LOG_NESTED_PRINT_MAX];
+        len = printFormatted(buf, sizeof(buf), logLevel, format, arg);
+    } else {
+        inDebugPrint = true;
+        len = printFormatted(line.text, sizeof(line.text), logLevel, format, arg);
+        inDebugPrint = false;
+    }
 #endif
 
+    return len;
+}
+
+// 'line' is free between log messages, so vprintf() formats into it while holding inDebugPrint
+size_t RedirectablePrint::printFormatted(char *printBuf, size_t printBufSize, const char *logLevel, const char *format,
+                                         va_list arg)
+{
+    va_list copy;
+
 #ifdef ARCH_PORTDUINO
     bool color = !settingsMap[ascii_logs];
 #else
@@ -63,30 +111,22 @@ size_t RedirectablePrint::vprintf(const char *logLevel, const char *format, va_l
 #endif
 
     va_copy(copy, arg);
-    size_t len = vsnprintf(printBuf, sizeof(printBuf), format, copy);
+    size_t len = vsnprintf(printBuf, printBufSize, format, copy);
     va_end(copy);
 
-    // If the resulting string is longer than sizeof(printBuf)-1 characters, the remaining characters are still counted for the
+    // If the resulting string is longer than printBufSize-1 characters, the remaining characters are still counted for the
     // return value
 
-    if (len > sizeof(printBuf) - 1) {
-        len = sizeof(printBuf) - 1;
-        printBuf[sizeof(printBuf) - 2] = '\n';
+    if (len > printBufSize - 1) {
+        len = printBufSize - 1;
+        printBuf[printBufSize - 2] = '\n';
     }
     for (size_t f = 0; f < len; f++) {
         if (!std::isprint(static_cast<unsigned char>(printBuf[f])) && printBuf[f] != '\n')
             printBuf[f] = '#';
     }
-    if (color && logLevel != nullptr) {
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0)
-            Print::write("\u001b[34m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0)
-            Print::write("\u001b[32m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0)
-            Print::write("\u001b[33m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_ERROR) == 0)
-            Print::write("\u001b[31m", 5);
-    }
+    if (color && logLevel != nullptr && logLevel[0] != 'T')
+        Print::write(levelColor(logLevel));
     len = Print::write(printBuf, len);
     if (color && logLevel != nullptr) {
         Print::write("\u001b[0m", 4);
@@ -94,10 +134,8 @@ size_t RedirectablePrint::vprintf(const char *logLevel, const char *format, va_l
     return len;
 }
 
-void RedirectablePrint::log_to_serial(const char *logLevel, const char *format, va_list arg)
+void RedirectablePrint::log_to_serial(const LogLine &line)
 {
-    size_t r = 0;
-
 #ifdef ARCH_PORTDUINO
     bool color = !settingsMap[ascii_logs];
 #else
@@ -105,18 +143,8 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
 #endif
 
     // include the header
-    if (color) {
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0)
-            Print::write("\u001b[34m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0)
-            Print::write("\u001b[32m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0)
-            Print::write("\u001b[33m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_ERROR) == 0)
-            Print::write("\u001b[31m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0)
-            Print::write("\u001b[35m", 5);
-    }
+    if (color)
+        Print::write(levelColor(line.level));
 
     uint32_t rtc_sec = getValidTime(RTCQuality::RTCQualityDevice, true); // display local time on logfile
     if (rtc_sec > 0) {
@@ -131,13 +159,13 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
         int min = (hms % SEC_PER_HOUR) / SEC_PER_MIN;
         int sec = (hms % SEC_PER_HOUR) % SEC_PER_MIN; // or hms % SEC_PER_MIN
 #ifdef ARCH_PORTDUINO
-        ::printf("%s ", logLevel);
+        ::printf("%s ", line.level);
         if (color) {
             ::printf("\u001b[0m");
         }
         ::printf("| %02d:%02d:%02d %u ", hour, min, sec, millis() / 1000);
 #else
-        printf("%s ", logLevel);
+        printf("%s ", line.level);
         if (color) {
             printf("\u001b[0m");
         }
@@ -145,37 +173,41 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
 #endif
     } else {
 #ifdef ARCH_PORTDUINO
-        ::printf("%s ", logLevel);
+        ::printf("%s ", line.level);
         if (color) {
             ::printf("\u001b[0m");
         }
         ::printf("| ??:??:?? %u ", millis() / 1000);
 #else
-        printf("%s ", logLevel);
+        printf("%s ", line.level);
         if (color) {
             printf("\u001b[0m");
         }
         printf("| ??:??:?? %u ", millis() / 1000);
 #endif
     }
-    auto thread = concurrency::OSThread::currentThread;
-    if (thread) {
+    if (line.source[0]) {
         print("[");
-        // printf("%p ", thread);
-        // assert(thread->ThreadName.length());
-        print(thread->ThreadName);
+        print(line.source);
         print("] ");
     }
-    r += vprintf(logLevel, format, arg);
+
+    // The message itself was already formatted and sanitized by formatLine()
+    if (color && line.level[0] != 'T')
+        Print::write(levelColor(line.level));
+    Print::write(line.text, line.len);
+    if (color && line.level[0] != 'T')
+        Print::write("\u001b[0m", 4);
+    Print::write('\n');
 }
 
-void RedirectablePrint::log_to_syslog(const char *logLevel, const char *format, va_list arg)
+void RedirectablePrint::log_to_syslog(const LogLine &line)
 {
 #if HAS_NETWORKING && !defined(ARCH_PORTDUINO)
     // if syslog is in use, collect the log messages and send them to syslog
     if (syslog.isEnabled()) {
         int ll = 0;
-        switch (logLevel[0]) {
+        switch (line.level[0]) {
         case 'D':
             ll = SYSLOG_DEBUG;
             break;
@@ -194,17 +226,14 @@ void RedirectablePrint::log_to_syslog(const char *logLevel, const char *format,
         default:
             ll = 0;
         }
-        auto thread = concurrency::OSThread::currentThread;
-        if (thread) {
-            syslog.vlogf(ll, thread->ThreadName.c_str(), format, arg);
-        } else {
-            syslog.vlogf(ll, format, arg);
-        }
+        syslog.log(ll, line.source[0] ? line.source : nullptr, line.text);
     }
+#else
+    (void)line;
 #endif
 }
 
-void RedirectablePrint::log_to_ble(const char *logLevel, const char *format, va_list arg)
+void RedirectablePrint::log_to_ble(const LogLine &line)
 {
 #if !MESHTASTIC_EXCLUDE_BLUETOOTH
     if (config.security.debug_log_api_enabled && !pauseBluetoothLogging) {
@@ -215,23 +244,10 @@ void RedirectablePrint::log_to_ble(const char *logLevel, const char *format, va_
         isBleConnected = nrf52Bluetooth != nullptr && nrf52Bluetooth->isConnected();
 #endif
         if (isBleConnected) {
-            char *message;
-            size_t initialLen;
-            size_t len;
-            initialLen = strlen(format);
-            message = new char[initialLen + 1];
-            len = vsnprintf(message, initialLen + 1, format, arg);
-            if (len > initialLen) {
-                delete[] message;
-                message = new char[len + 1];
-                vsnprintf(message, len + 1, format, arg);
-            }
-            auto thread = concurrency::OSThread::currentThread;
             meshtastic_LogRecord logRecord = meshtastic_LogRecord_init_zero;
-            logRecord.level = getLogLevel(logLevel);
-            strcpy(logRecord.message, message);
-            if (thread)
-                strcpy(logRecord.source, thread->ThreadName.c_str());
+            logRecord.level = getLogLevel(line.level);
+            strncpy(logRecord.message, line.text, sizeof(logRecord.message) - 1);
+            strncpy(logRecord.source, line.source, sizeof(logRecord.source) - 1);
             logRecord.time = getValidTime(RTCQuality::RTCQualityDevice, true);
 
             uint8_t *buffer = new uint8_t[meshtastic_LogRecord_size];
@@ -241,14 +257,11 @@ void RedirectablePrint::log_to_ble(const char *logLevel, const char *format, va_
 #elif defined(ARCH_NRF52)
             nrf52Bluetooth->sendLog(buffer, size);
 #endif
-            delete[] message;
             delete[] buffer;
         }
     }
 #else
-    (void)logLevel;
-    (void)format;
-    (void)arg;
+    (void)line;
 #endif
 }
 
@@ -275,73 +288,133 @@ meshtastic_LogRecord_Level RedirectablePrint::getLogLevel(const char *logLevel)
     return ll;
 }
 
-void RedirectablePrint::log(const char *logLevel, const char *format, ...)
+bool RedirectablePrint::isLevelEnabled(const char *logLevel)
+{
+#if ARCH_PORTDUINO
+    switch (logLevel[0]) {
+    case 'T':
+        return settingsMap[logoutputlevel] >= level_trace;
+    case 'D':
+        if (settingsMap[logoutputlevel] < level_debug)
+            return false;
+        break;
+    case 'I':
+        return settingsMap[logoutputlevel] >= level_info;
+    case 'W':
+        return settingsMap[logoutputlevel] >= level_warn;
+    }
+#endif
+    return !(moduleConfig.serial.override_console_serial_port && logLevel[0] == 'D');
+}
+
+// Format a message once, so the sinks don't each have to
+void RedirectablePrint::formatLine(LogLine &l, const char *logLevel, const char *format, va_list arg)
 {
+    auto thread = concurrency::OSThread::currentThread;
+    l.level = logLevel;
+    l.source = thread ? thread->ThreadName.c_str() : "";
 
-    // append \n to format
-    size_t len = strlen(format);
-    char *newFormat = new char[len + 2];
-    strcpy(newFormat, format);
-    newFormat[len] = '\n';
-    newFormat[len + 1] = '\0';
+    int len = vsnprintf(l.text, sizeof(l.text), format, arg);
+    if (len < 0)
+        len = 0;
+    l.len = min((size_t)len, sizeof(l.text) - 1); // Truncated if longer
 
-#if ARCH_PORTDUINO
-    // level trace is special, two possible ways to handle it.
-    if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0) {
-        if (settingsStrings[traceFilename] != "") {
-            va_list arg;
-            va_start(arg, format);
-            try {
-                traceFile << va_arg(arg, char *) << std::endl;
-            } catch (const std::ios_base::failure &e) {
-            }
-            va_end(arg);
-        }
-        if (settingsMap[logoutputlevel] < level_trace && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0) {
-            delete[] newFormat;
-            return;
-        }
+    while (l.len && l.text[l.len - 1] == '\n')
+        l.text[--l.len] = '\0';
+    for (size_t f = 0; f < l.len; f++) {
+        if (!std::isprint(static_cast<unsigned char>(l.text[f])) && l.text[f] != '\n')
+            l.text[f] = '#';
     }
-    if (settingsMap[logoutputlevel] < level_debug && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0) {
-        delete[] newFormat;
-        return;
-    } else if (settingsMap[logoutputlevel] < level_info && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0) {
-        delete[] newFormat;
-        return;
-    } else if (settingsMap[logoutputlevel] < level_warn && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0) {
-        delete[] newFormat;
-        return;
+}
+
+void RedirectablePrint::emitLine(const LogLine &l)
+{
+    log_to_serial(l);
+    log_to_syslog(l);
+    log_to_ble(l);
+
+#if LOG_PENDING_LINES
+    // Sinks may have logged something themselves meanwhile, which is now printed in order
+    while (pendingCount) {
+        LogLine &p = pending[pendingHead];
+        log_to_serial(p);
+        log_to_syslog(p);
+        log_to_ble(p);
+        pendingHead = (pendingHead + 1) % LOG_PENDING_LINES;
+        pendingCount--;
     }
 #endif
-    if (moduleConfig.serial.override_console_serial_port && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0) {
-        delete[] newFormat;
-        return;
+    if (pendingDropped) {
+        uint32_t dropped = pendingDropped;
+        pendingDropped = 0;
+        snprintf(line.text, sizeof(line.text), "%u log messages dropped", dropped);
+        line.level = MESHTASTIC_LOG_LEVEL_WARN;
+        line.source = "";
+        line.len = strlen(line.text);
+        emitLine(line);
     }
+}
 
-#ifdef HAS_FREE_RTOS
-    if (inDebugPrint != nullptr && xSemaphoreTake(inDebugPrint, portMAX_DELAY) == pdTRUE) {
+void RedirectablePrint::queuePending(const char *logLevel, const char *format, va_list arg)
+{
+#if LOG_PENDING_LINES
+    if (pendingCount < LOG_PENDING_LINES) {
+        formatLine(pending[(pendingHead + pendingCount++) % LOG_PENDING_LINES], logLevel, format, arg);
+        return;
+    }
 #else
-    if (!inDebugPrint) {
-        inDebugPrint = true;
+    (void)logLevel;
+    (void)format;
+    (void)arg;
 #endif
+    pendingDropped++;
+}
 
+void RedirectablePrint::log(const char *logLevel, const char *format, ...)
+{
+#if ARCH_PORTDUINO
+    // level trace is special, two possible ways to handle it.
+    if (logLevel[0] == 'T' && settingsStrings[traceFilename] != "") {
         va_list arg;
         va_start(arg, format);
+        try {
+            traceFile << va_arg(arg, char *) << std::endl;
+        } catch (const std::ios_base::failure &e) {
+        }
+        va_end(arg);
+    }
+#endif
+    // Filter before doing any work
+    if (!isLevelEnabled(logLevel))
+        return;
 
-        log_to_serial(logLevel, newFormat, arg);
-        log_to_syslog(logLevel, newFormat, arg);
-        log_to_ble(logLevel, newFormat, arg);
+    va_list arg;
+    va_start(arg, format);
 
-        va_end(arg);
 #ifdef HAS_FREE_RTOS
+    if (inDebugPrint != nullptr && debugPrintOwner == xTaskGetCurrentTaskHandle()) {
+        // Logged by a sink, while we are printing a message. Queue it, rather than deadlock
+        queuePending(logLevel, format, arg);
+    } else if (inDebugPrint != nullptr && xSemaphoreTake(inDebugPrint, portMAX_DELAY) == pdTRUE) {
+        debugPrintOwner = xTaskGetCurrentTaskHandle();
+        formatLine(line, logLevel, format, arg);
+        emitLine(line);
+        debugPrintOwner = nullptr;
         xSemaphoreGive(inDebugPrint);
+    }
 #else
+    if (inDebugPrint) {
+        // Logged by a sink, while we are printing a message. Queue it, rather than drop it
+        queuePending(logLevel, format, arg);
+    } else {
+        inDebugPrint = true;
+        formatLine(line, logLevel, format, arg);
+        emitLine(line);
         inDebugPrint = false;
-#endif
     }
+#endif
 
-    delete[] newFormat;
-    return;
+    va_end(arg);
 }
 
 void RedirectablePrint::hexDump(const char *logLevel, unsigned char *buf, uint16_t len)
@@ -6,6 +6,33 @@
 #include <stdarg.h>
 #include <string>
 
+/// Longest log message we print, longer ones are truncated in every sink. Where there is BLE it is the size of a
+/// LogRecord message, so the phone gets those whole
+#ifndef LOG_LINE_MAX
+#if ENABLE_JSON_LOGGING || ARCH_PORTDUINO
+#define LOG_LINE_MAX 512
+#elif defined(ARCH_ESP32) || defined(ARCH_NRF52)
+#define LOG_LINE_MAX sizeof(meshtastic_LogRecord::message)
+#else
+#define LOG_LINE_MAX 256
+#endif
+#endif
+
+/// Messages logged from inside a sink (e.g. by a serial or BLE driver) wait here until the current message is done, with 0
+/// they are only counted as dropped. Each one costs LOG_LINE_MAX of RAM, so only portduino keeps them by default
+#ifndef LOG_PENDING_LINES
+#ifdef ARCH_PORTDUINO
+#define LOG_PENDING_LINES 2
+#else
+#define LOG_PENDING_LINES 0
+#endif
+#endif
+
+/// vprintf() from inside a sink can't use the line being printed, it formats into this much stack instead
+#ifndef LOG_NESTED_PRINT_MAX
+#define LOG_NESTED_PRINT_MAX 128
+#endif
+
 /**
  * A Printable that can be switched to squirt its bytes to a different sink.
  * This class is mostly useful to allow debug printing to be redirected away from Serial
@@ -13,14 +40,35 @@
  */
 class RedirectablePrint : public Print
 {
+  public:
+    /// A log message, formatted once into preallocated memory and then handed to every sink
+    struct LogLine {
+        const char *level;  // One of MESHTASTIC_LOG_LEVEL_*
+        const char *source; // Name of the thread which logged it, or empty
+        uint16_t len;
+        char text[LOG_LINE_MAX]; // Without trailing newline
+    };
+
+  private:
     Print *dest;
 
 #ifdef HAS_FREE_RTOS
     SemaphoreHandle_t inDebugPrint = nullptr;
     StaticSemaphore_t _MutexStorageSpace;
+    volatile TaskHandle_t debugPrintOwner = nullptr; // Task which holds inDebugPrint
 #else
     volatile bool inDebugPrint = false;
 #endif
+
+    // Only ever touched while holding inDebugPrint. vprintf() formats into 'line' too, rather than having its own buffer
+    LogLine line;
+#if LOG_PENDING_LINES
+    LogLine pending[LOG_PENDING_LINES];
+    uint8_t pendingHead = 0;
+    uint8_t pendingCount = 0;
+#endif
+    uint32_t pendingDropped = 0;
+
   public:
     explicit RedirectablePrint(Print *_dest) : dest(_dest) {}
 
@@ -50,10 +98,20 @@ class RedirectablePrint : public Print
 
   protected:
     /// Subclasses can override if they need to change how we format over the serial port
-    virtual void log_to_serial(const char *logLevel, const char *format, va_list arg);
+    virtual void log_to_serial(const LogLine &line);
     meshtastic_LogRecord_Level getLogLevel(const char *logLevel);
 
   private:
-    void log_to_syslog(const char *logLevel, const char *format, va_list arg);
-    void log_to_ble(const char *logLevel, const char *format, va_list arg);
+    void log_to_syslog(const LogLine &line);
+    void log_to_ble(const LogLine &line);
+    /// The body of vprintf(), formatting into 'buf'
+    size_t printFormatted(char *buf, size_t size, const char *logLevel, const char *format, va_list arg);
+
+    /// Is this level enabled at runtime (portduino config, serial override)
+    bool isLevelEnabled(const char *logLevel);
+    void formatLine(LogLine &l, const char *logLevel, const char *format, va_list arg);
+    /// Keep a message logged by a sink for after the current one, or count it as dropped
+    void queuePending(const char *logLevel, const char *format, va_list arg);
+    /// Send a line to all sinks, followed by any lines which were logged meanwhile
+    void emitLine(const LogLine &l);
 };
\ No newline at end of file
@@ -96,12 +96,11 @@ bool SerialConsole::handleToRadio(const uint8_t *buf, size_t len)
     }
 }
 
-void SerialConsole::log_to_serial(const char *logLevel, const char *format, va_list arg)
+void SerialConsole::log_to_serial(const LogLine &line)
 {
     if (usingProtobufs && config.security.debug_log_api_enabled) {
-        meshtastic_LogRecord_Level ll = RedirectablePrint::getLogLevel(logLevel);
-        auto thread = concurrency::OSThread::currentThread;
-        emitLogRecord(ll, thread ? thread->ThreadName.c_str() : "", format, arg);
+        meshtastic_LogRecord_Level ll = RedirectablePrint::getLogLevel(line.level);
+        emitLogRecord(ll, line.source, line.text);
     } else
-        RedirectablePrint::log_to_serial(logLevel, format, arg);
+        RedirectablePrint::log_to_serial(line);
 }
\ No newline at end of file
@@ -38,7 +38,7 @@ class SerialConsole : public StreamAPI, public RedirectablePrint, private concur
     virtual bool checkIsConnected() override;
 
     /// Possibly switch to protobufs if we see a valid protobuf message
-    virtual void log_to_serial(const char *logLevel, const char *format, va_list arg);
+    virtual void log_to_serial(const LogLine &line) override;
 };
 
 // A simple wrapper to allow non class aware code write to the console
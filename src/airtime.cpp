@@ -18,6 +18,11 @@ void AirTime::logAirtime(reportTypes reportType, uint32_t airtime_ms)
         air_period_tx[0] = air_period_tx[0] + airtime_ms;
 
         this->utilizationTX[this->getPeriodUtilHour()] = this->utilizationTX[this->getPeriodUtilHour()] + airtime_ms;
+
+        if (hasDutyCycleLimit()) {
+            refillTxBudget();
+            txBudgetMs -= airtime_ms; // may go negative, the budget then first has to recover
+        }
     } else if (reportType == RX_LOG) {
         LOG_DEBUG("Packet RX: %ums", airtime_ms);
         this->airtimes.periodRX[0] = this->airtimes.periodRX[0] + airtime_ms;
@@ -31,6 +36,36 @@ void AirTime::logAirtime(reportTypes reportType, uint32_t airtime_ms)
     this->channelUtilization[this->getPeriodUtilMinute()] = channelUtilization[this->getPeriodUtilMinute()] + airtime_ms;
 }
 
+void AirTime::logAirtime(reportTypes reportType, uint32_t airtime_ms, const meshtastic_MeshPacket *p)
+{
+    logAirtime(reportType, airtime_ms);
+
+    if (reportType == TX_LOG) {
+        if (isFromUs(p))
+            breakdown.originTX_ms += airtime_ms;
+        else
+            breakdown.relayTX_ms += airtime_ms;
+    } else if (reportType == RX_LOG) {
+        // Without hop_start (firmware <2.3) we can't tell, so count it as heard from the origin
+        if (p->hop_start != 0 && p->hop_start != p->hop_limit)
+            breakdown.relayRX_ms += airtime_ms;
+        else
+            breakdown.originRX_ms += airtime_ms;
+    } else {
+        return;
+    }
+    breakdown.nodes.add(getFrom(p), airtime_ms);
+}
+
+void AirTime::logPortnumAirtime(reportTypes reportType, meshtastic_PortNum portnum, uint32_t airtime_ms)
+{
+    if (reportType == TX_LOG) {
+        breakdown.portnumTX.add(portnum, airtime_ms);
+    } else if (reportType == RX_LOG) {
+        breakdown.portnumRX.add(portnum, airtime_ms);
+    }
+}
+
 uint8_t AirTime::currentPeriodIndex()
 {
     return ((getSecondsSinceBoot() / SECONDS_PER_PERIOD) % PERIODS_TO_LOG);
@@ -68,6 +103,14 @@ void AirTime::airtimeRotatePeriod()
         air_period_tx[0] = 0;
         air_period_rx[0] = 0;
 
+        LOG_DEBUG("Airtime last period: origin TX=%ums, relay TX=%ums, origin RX=%ums, relay RX=%ums", breakdown.originTX_ms,
+                  breakdown.relayTX_ms, breakdown.originRX_ms, breakdown.relayRX_ms);
+        int8_t topNode = breakdown.nodes.top();
+        if (topNode >= 0)
+            LOG_DEBUG("Airtime last period: top node 0x%x %ums", breakdown.nodes.get(topNode).key,
+                      breakdown.nodes.get(topNode).airtime_ms);
+        breakdown = {};
+
         this->airtimes.lastPeriodIndex = this->currentPeriodIndex();
     }
 }
@@ -144,6 +187,54 @@ bool AirTime::isTxAllowedAirUtil()
     return true;
 }
 
+bool AirTime::hasDutyCycleLimit()
+{
+    return !config.lora.override_duty_cycle && myRegion->dutyCycle < 100;
+}
+
+float AirTime::getTxBudgetCapacityMs()
+{
+    return myRegion->dutyCycle * MS_IN_HOUR / 100;
+}
+
+void AirTime::refillTxBudget()
+{
+    uint32_t now = millis();
+    if (!txBudgetSeeded) {
+        // Seed from the TX we already did within the last hour
+        txBudgetMs = getTxBudgetCapacityMs() - utilizationTXPercent() * MS_IN_HOUR / 100;
+        txBudgetSeeded = true;
+    } else {
+        txBudgetMs += (now - lastTxBudgetUpdate) * myRegion->dutyCycle / 100;
+    }
+    txBudgetMs = min(txBudgetMs, getTxBudgetCapacityMs());
+    lastTxBudgetUpdate = now;
+}
+
+float AirTime::getTxBudgetFloorMs(bool lowPriority)
+{
+    // Low priority traffic has to leave the polite share of the bucket to the important stuff
+    return lowPriority ? getTxBudgetCapacityMs() * (100 - polite_duty_cycle_percent) / 100 : 0;
+}
+
+bool AirTime::isTxAllowedBudget(uint32_t airtime_ms, bool lowPriority)
+{
+    if (!hasDutyCycleLimit())
+        return true;
+
+    refillTxBudget();
+    return txBudgetMs - airtime_ms >= getTxBudgetFloorMs(lowPriority);
+}
+
+uint32_t AirTime::getMsUntilTxBudget(uint32_t airtime_ms, bool lowPriority)
+{
+    if (isTxAllowedBudget(airtime_ms, lowPriority))
+        return 0;
+
+    float missingMs = getTxBudgetFloorMs(lowPriority) + airtime_ms - txBudgetMs;
+    return missingMs * 100 / myRegion->dutyCycle;
+}
+
 // Get the amount of minutes we have to be silent before we can send again
 uint8_t AirTime::getSilentMinutes(float txPercent, float dutyCycle)
 {
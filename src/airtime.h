@@ -33,8 +33,75 @@
 #define MS_IN_MINUTE (SECONDS_IN_MINUTE * 1000)
 #define MS_IN_HOUR (MINUTES_IN_HOUR * SECONDS_IN_MINUTE * 1000)
 
+// Number of portnums and originating nodes we keep airtime for in the current period
+#define AIRTIME_TOP_PORTNUMS 12
+#define AIRTIME_TOP_NODES 10
+
 enum reportTypes { TX_LOG, RX_LOG, RX_ALL_LOG };
 
+/*
+  Fixed size "space-saving" sketch for the heaviest airtime users. When all slots are in use a new key takes over the
+  slot with the least airtime and inherits its airtime as (over)estimation error, so memory stays bounded while the
+  top-K keys are still reported with guaranteed error bounds.
+*/
+template <typename K, uint8_t N> class AirtimeTopK
+{
+  public:
+    struct Entry {
+        K key;
+        uint32_t airtime_ms; // Estimated airtime, never lower than the real value
+        uint32_t error_ms;   // Maximum overestimation of airtime_ms
+    };
+
+    void add(K key, uint32_t airtime_ms)
+    {
+        uint8_t minIndex = 0;
+        for (uint8_t i = 0; i < used; i++) {
+            if (entries[i].key == key) {
+                entries[i].airtime_ms += airtime_ms;
+                return;
+            }
+            if (entries[i].airtime_ms < entries[minIndex].airtime_ms)
+                minIndex = i;
+        }
+        if (used < N) {
+            entries[used++] = {key, airtime_ms, 0};
+        } else {
+            entries[minIndex] = {key, entries[minIndex].airtime_ms + airtime_ms, entries[minIndex].airtime_ms};
+        }
+    }
+
+    void clear() { used = 0; }
+    uint8_t size() const { return used; }
+    const Entry &get(uint8_t i) const { return entries[i]; }
+
+    /// Index of the entry with the most airtime, or -1 if empty
+    int8_t top() const
+    {
+        int8_t best = -1;
+        for (uint8_t i = 0; i < used; i++) {
+            if (best < 0 || entries[i].airtime_ms > entries[best].airtime_ms)
+                best = i;
+        }
+        return best;
+    }
+
+  private:
+    Entry entries[N];
+    uint8_t used = 0;
+};
+
+/*
+  Breakdown of the airtime of the current period (SECONDS_PER_PERIOD), attributing TX and RX (valid mesh packets only)
+  to portnum, originating node and whether the packet was transmitted by its origin or rebroadcast.
+*/
+struct AirtimeBreakdown {
+    AirtimeTopK<uint16_t, AIRTIME_TOP_PORTNUMS> portnumTX, portnumRX;
+    AirtimeTopK<NodeNum, AIRTIME_TOP_NODES> nodes; // TX + RX by originating node
+    uint32_t originTX_ms, relayTX_ms;              // TX of our own packets vs. rebroadcasts
+    uint32_t originRX_ms, relayRX_ms;              // RX heard from the originator vs. from a relayer
+};
+
 void logAirtime(reportTypes reportType, uint32_t airtime_ms);
 
 uint32_t *airtimeReport(reportTypes reportType);
@@ -46,6 +113,11 @@ class AirTime : private concurrency::OSThread
     AirTime();
 
     void logAirtime(reportTypes reportType, uint32_t airtime_ms);
+    /// Log airtime and attribute it to the originating node and origin/rebroadcast of the packet
+    void logAirtime(reportTypes reportType, uint32_t airtime_ms, const meshtastic_MeshPacket *p);
+    /// Attribute airtime to a portnum, only known once the packet is decoded (meshtastic_PortNum_UNKNOWN_APP if it can't be)
+    void logPortnumAirtime(reportTypes reportType, meshtastic_PortNum portnum, uint32_t airtime_ms);
+    const AirtimeBreakdown &getBreakdown() { return breakdown; }
     float channelUtilizationPercent();
     float utilizationTXPercent();
 
@@ -61,6 +133,17 @@ class AirTime : private concurrency::OSThread
     uint8_t getSilentMinutes(float txPercent, float dutyCycle);
     bool isTxAllowedChannelUtil(bool polite = false);
     bool isTxAllowedAirUtil();
+    /// Channel utilization above which we don't send anything that can wait
+    uint8_t getPoliteChannelUtilPercent() { return polite_channel_util_percent; }
+
+    /**
+     * Token bucket budget for the regional duty cycle: the bucket holds dutyCycle% of an hour of airtime and refills
+     * continuously at the duty cycle rate. Low priority traffic may only spend the part above the polite reserve, so
+     * ACKs and text messages still find budget after a burst of telemetry.
+     */
+    bool isTxAllowedBudget(uint32_t airtime_ms, bool lowPriority);
+    /// Milliseconds until isTxAllowedBudget() will allow a packet of airtime_ms
+    uint32_t getMsUntilTxBudget(uint32_t airtime_ms, bool lowPriority);
 
   private:
     bool firstTime = true;
@@ -70,6 +153,9 @@ class AirTime : private concurrency::OSThread
     uint8_t max_channel_util_percent = 40;
     uint8_t polite_channel_util_percent = 25;
     uint8_t polite_duty_cycle_percent = 50; // half of Duty Cycle allowance is ok for metadata
+    bool txBudgetSeeded = false;
+    float txBudgetMs = 0; // Available duty cycle budget, negative after overspending it
+    uint32_t lastTxBudgetUpdate = 0;
 
     struct airtimeStruct {
         uint32_t periodTX[PERIODS_TO_LOG];     // AirTime transmitted
@@ -78,6 +164,13 @@ class AirTime : private concurrency::OSThread
         uint8_t lastPeriodIndex;
     } airtimes;
 
+    AirtimeBreakdown breakdown = {};
+
+    bool hasDutyCycleLimit();
+    float getTxBudgetCapacityMs();
+    void refillTxBudget();
+    float getTxBudgetFloorMs(bool lowPriority);
+
     uint8_t getPeriodUtilMinute();
     uint8_t getPeriodUtilHour();
     uint8_t currentPeriodIndex();
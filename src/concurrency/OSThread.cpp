@@ -20,6 +20,10 @@ const OSThread *OSThread::currentThread;
 ThreadController mainController, timerController;
 InterruptableDelay mainDelay;
 
+#ifdef ARCH_PORTDUINO
+std::mutex OSThread::threadListLock;
+#endif
+
 void OSThread::setup()
 {
     mainController.ThreadName = "mainController";
@@ -34,6 +38,9 @@ OSThread::OSThread(const char *_name, uint32_t period, ThreadController *_contro
     ThreadName = _name;
 
     if (controller) {
+#ifdef ARCH_PORTDUINO
+        std::lock_guard<std::mutex> guard(threadListLock);
+#endif
         bool added = controller->add(this);
         assert(added);
     }
@@ -41,8 +48,12 @@ OSThread::OSThread(const char *_name, uint32_t period, ThreadController *_contro
 
 OSThread::~OSThread()
 {
-    if (controller)
+    if (controller) {
+#ifdef ARCH_PORTDUINO
+        std::lock_guard<std::mutex> guard(threadListLock);
+#endif
         controller->remove(this);
+    }
 }
 
 /**
@@ -82,7 +93,14 @@ void OSThread::run()
     auto heap = memGet.getFreeHeap();
 #endif
     currentThread = this;
+#ifdef ARCH_PORTDUINO
+    uint32_t start = micros();
+#endif
     auto newDelay = runOnce();
+#ifdef ARCH_PORTDUINO
+    runtimeUsec += micros() - start;
+    runCount++;
+#endif
 #ifdef DEBUG_HEAP
     auto newHeap = memGet.getFreeHeap();
     if (newHeap < heap)
@@ -6,6 +6,9 @@
 #include "Thread.h"
 #include "ThreadController.h"
 #include "concurrency/InterruptableDelay.h"
+#ifdef ARCH_PORTDUINO
+#include <mutex>
+#endif
 
 namespace concurrency
 {
@@ -60,6 +63,26 @@ class OSThread : public Thread
      */
     void setIntervalFromNow(unsigned long _interval);
 
+#ifdef ARCH_PORTDUINO
+    /// CPU time spent in runOnce, for the metrics endpoint
+    uint64_t getRuntimeUsec() const { return runtimeUsec; }
+    uint32_t getRunCount() const { return runCount; }
+
+    /**
+     * Call f(const OSThread &) for each thread of mainController, from a real thread other than the main loop (e.g. the web
+     * server). Threads can't be added or removed meanwhile.
+     */
+    template <typename F> static void forEachThread(F f)
+    {
+        std::lock_guard<std::mutex> guard(threadListLock);
+        for (int i = 0; i < MAX_THREADS; i++) {
+            auto t = static_cast<const OSThread *>(mainController.get(i));
+            if (t)
+                f(*t);
+        }
+    }
+#endif
+
   protected:
     /**
      * The method that will be called each time our thread gets a chance to run
@@ -71,6 +94,15 @@ class OSThread : public Thread
 
     // Do not override this
     virtual void run();
+
+  private:
+#ifdef ARCH_PORTDUINO
+    uint64_t runtimeUsec = 0;
+    uint32_t runCount = 0;
+
+    /// Held while a thread is added to or removed from its controller
+    static std::mutex threadListLock;
+#endif
 };
 
 /**
@@ -14,6 +14,15 @@
 
 #include "../concurrency/Lock.h"
 
+// Scan both buses at the same time, they are separate peripherals
+#ifndef I2C_PARALLEL_SCAN
+#ifdef ARCH_ESP32
+#define I2C_PARALLEL_SCAN 1
+#else
+#define I2C_PARALLEL_SCAN 0
+#endif
+#endif
+
 class ScanI2CTwoWire : public ScanI2C
 {
   public:
@@ -21,6 +30,12 @@ class ScanI2CTwoWire : public ScanI2C
 
     void scanPort(ScanI2C::I2CPort, uint8_t *, uint8_t) override;
 
+    /**
+     * Find the devices on all the given buses, for use at boot.
+     * With I2C_PARALLEL_SCAN, two buses are scanned at the same time.
+     */
+    void scanPorts(const ScanI2C::I2CPort *ports, uint8_t count);
+
     ScanI2C::FoundDevice find(ScanI2C::DeviceType) const override;
 
     TwoWire *fetchI2CBus(ScanI2C::DeviceAddress) const;
@@ -57,6 +72,18 @@ class ScanI2CTwoWire : public ScanI2C
 
     DeviceType probeOLED(ScanI2C::DeviceAddress) const;
 
+    /// Ping an address, returns the error code of endTransmission()
+    uint8_t probeAddress(TwoWire *, uint8_t address) const;
+
+    /// Work out which device answered at an address
+    DeviceType identify(ScanI2C::DeviceAddress, TwoWire *);
+
+    void addDevice(ScanI2C::DeviceAddress, ScanI2C::DeviceType);
+
+#if I2C_PARALLEL_SCAN
+    static void scanPortTask(void *);
+#endif
+
     static void logFoundDevice(const char *device, uint8_t address);
 };
 #endif
\ No newline at end of file
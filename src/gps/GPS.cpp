@@ -4,6 +4,7 @@
 
 #include "configuration.h"
 #if !MESHTASTIC_EXCLUDE_GPS
+#include "BootTimeline.h"
 #include "Default.h"
 #include "GPS.h"
 #include "GpioLogic.h"
@@ -224,38 +225,8 @@ uint8_t GPS::makeCASPacket(uint8_t class_id, uint8_t msg_id, uint8_t payload_siz
 
 GPS_RESPONSE GPS::getACK(const char *message, uint32_t waitMillis)
 {
-    uint8_t buffer[768] = {0};
-    uint8_t b;
-    int bytesRead = 0;
-    uint32_t startTimeout = millis() + waitMillis;
-#ifdef GPS_DEBUG
-    std::string debugmsg = "";
-#endif
-    while (millis() < startTimeout) {
-        if (_serial_gps->available()) {
-            b = _serial_gps->read();
-
-#ifdef GPS_DEBUG
-            debugmsg += vformat("%c", (b >= 32 && b <= 126) ? b : '.');
-#endif
-            buffer[bytesRead] = b;
-            bytesRead++;
-            if ((bytesRead == 767) || (b == '\r')) {
-                if (strnstr((char *)buffer, message, bytesRead) != nullptr) {
-#ifdef GPS_DEBUG
-                    LOG_DEBUG("Found: %s", message); // Log the found message
-#endif
-                    return GNSS_RESPONSE_OK;
-                } else {
-                    bytesRead = 0;
-#ifdef GPS_DEBUG
-                    LOG_DEBUG(debugmsg.c_str());
-#endif
-                }
-            }
-        }
-    }
-    return GNSS_RESPONSE_NONE;
+    expectText(message, waitMillis);
+    return waitAck();
 }
 
 GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
@@ -321,153 +292,141 @@ GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMilli
 
 GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
 {
-    uint8_t b;
-    uint8_t ack = 0;
-    const uint8_t ackP[2] = {class_id, msg_id};
-    uint8_t buf[10] = {0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
-    uint32_t startTime = millis();
-    const char frame_errors[] = "More than 100 frame errors";
-    int sCounter = 0;
-#ifdef GPS_DEBUG
-    std::string debugmsg = "";
-#endif
+    expectAck(class_id, msg_id, waitMillis);
+    return waitAck();
+}
 
-    for (int j = 2; j < 6; j++) {
-        buf[8] += buf[j];
-        buf[9] += buf[8];
-    }
+/**
+ * @brief
+ * @note   New method, this method can wait for the specified class and message ID, and return the payload
+ * @param  *buffer: The message buffer, if there is a response payload message, it will be returned through the buffer parameter
+ * @param  size:    size of buffer
+ * @param  requestedClass:  request class constant
+ * @param  requestedID:     request message ID constant
+ * @retval length of payload message
+ */
+int GPS::getACK(uint8_t *buffer, uint16_t size, uint8_t requestedClass, uint8_t requestedID, uint32_t waitMillis)
+{
+    expectMessage(buffer, size, requestedClass, requestedID, waitMillis);
+    return waitAck() == GNSS_RESPONSE_OK ? pendingAck.payloadLen : 0;
+}
 
-    for (int j = 0; j < 2; j++) {
-        buf[6 + j] = ackP[j];
-        buf[8] += buf[6 + j];
-        buf[9] += buf[8];
-    }
+void GPS::expectAck(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
+{
+    pendingAck = PendingAck();
+    pendingAck.kind = PendingAck::UBX_ACK;
+    pendingAck.cls = class_id;
+    pendingAck.id = msg_id;
+    pendingAck.start = millis();
+    pendingAck.timeout = waitMillis;
+}
 
-    while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (ack > 9) {
+void GPS::expectMessage(uint8_t *buffer, uint16_t size, uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
+{
+    expectAck(class_id, msg_id, waitMillis);
+    pendingAck.kind = PendingAck::UBX_MESSAGE;
+    pendingAck.buffer = buffer;
+    pendingAck.size = size;
+}
+
+void GPS::expectText(const char *message, uint32_t waitMillis)
+{
+    pendingAck = PendingAck();
+    pendingAck.kind = PendingAck::TEXT;
+    pendingAck.text = message;
+    pendingAck.start = millis();
+    pendingAck.timeout = waitMillis;
+}
+
+bool GPS::pollAck()
+{
+    PendingAck &a = pendingAck;
+    while (a.kind != PendingAck::NONE && readFrame()) {
+        const GPSStreamParser::Frame &f = parser.frame();
 #ifdef GPS_DEBUG
-            LOG_INFO("Got ACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
-#endif
-            return GNSS_RESPONSE_OK; // ACK received
-        }
-        if (_serial_gps->available()) {
-            b = _serial_gps->read();
-            if (b == frame_errors[sCounter]) {
-                sCounter++;
-                if (sCounter == 26) {
+        if (f.type == GPSStreamParser::FRAME_NMEA)
+            LOG_DEBUG("%.*s", f.len, f.data);
+#endif
+        bool isUbx = f.type == GPSStreamParser::FRAME_UBX && f.valid;
+        bool isNmea = f.type == GPSStreamParser::FRAME_NMEA;
+        switch (a.kind) {
+        case PendingAck::UBX_ACK:
+            // UBX-ACK-ACK and UBX-ACK-NAK carry the class and id of the command
+            if (isUbx && f.ubxClass == 0x05 && f.payloadLen() >= 2 && f.payload()[0] == a.cls && f.payload()[1] == a.id) {
+                if (f.ubxId == 0x01) {
 #ifdef GPS_DEBUG
-
-                    LOG_DEBUG(debugmsg.c_str());
+                    LOG_INFO("Got ACK for class %02X message %02X in %dms", a.cls, a.id, millis() - a.start);
 #endif
-                    return GNSS_RESPONSE_FRAME_ERRORS;
+                    a.result = GNSS_RESPONSE_OK;
+                } else {
+                    LOG_WARN("Got NAK for class %02X message %02X", a.cls, a.id);
+                    a.result = GNSS_RESPONSE_NAK;
                 }
-            } else {
-                sCounter = 0;
+                a.kind = PendingAck::NONE;
+            } else if (isNmea && strnstr((const char *)f.data, "More than 100 frame errors", f.len)) {
+                a.result = GNSS_RESPONSE_FRAME_ERRORS;
+                a.kind = PendingAck::NONE;
             }
+            break;
+        case PendingAck::UBX_MESSAGE:
+            if (isUbx && f.ubxClass == a.cls && f.ubxId == a.id && (!a.buffer || f.payloadLen() < a.size)) {
 #ifdef GPS_DEBUG
-            debugmsg += vformat("%02X", b);
+                LOG_INFO("Got ACK for class %02X message %02X in %dms", a.cls, a.id, millis() - a.start);
 #endif
-            if (b == buf[ack]) {
-                ack++;
-            } else {
-                if (ack == 3 && b == 0x00) { // UBX-ACK-NAK message
+                if (a.buffer)
+                    memcpy(a.buffer, f.payload(), f.payloadLen());
+                a.payloadLen = f.payloadLen();
+                a.result = GNSS_RESPONSE_OK;
+                a.kind = PendingAck::NONE;
+            }
+            break;
+        case PendingAck::TEXT:
+            if (isNmea && strnstr((const char *)f.data, a.text, f.len)) {
 #ifdef GPS_DEBUG
-                    LOG_DEBUG(debugmsg.c_str());
+                LOG_DEBUG("Found: %s", a.text);
 #endif
-                    LOG_WARN("Got NAK for class %02X message %02X", class_id, msg_id);
-                    return GNSS_RESPONSE_NAK; // NAK received
-                }
-                ack = 0; // Reset the acknowledgement counter
+                a.result = GNSS_RESPONSE_OK;
+                a.kind = PendingAck::NONE;
             }
+            break;
+        default:
+            break;
         }
     }
+    if (a.kind != PendingAck::NONE && !Throttle::isWithinTimespanMs(a.start, a.timeout)) {
 #ifdef GPS_DEBUG
-    LOG_DEBUG(debugmsg.c_str());
-    LOG_WARN("No response for class %02X message %02X", class_id, msg_id);
+        if (a.kind != PendingAck::TEXT)
+            LOG_WARN("No response for class %02X message %02X", a.cls, a.id);
 #endif
-    return GNSS_RESPONSE_NONE; // No response received within timeout
+        a.result = GNSS_RESPONSE_NONE;
+        a.kind = PendingAck::NONE;
+    }
+    return a.kind == PendingAck::NONE;
 }
 
-/**
- * @brief
- * @note   New method, this method can wait for the specified class and message ID, and return the payload
- * @param  *buffer: The message buffer, if there is a response payload message, it will be returned through the buffer parameter
- * @param  size:    size of buffer
- * @param  requestedClass:  request class constant
- * @param  requestedID:     request message ID constant
- * @retval length of payload message
- */
-int GPS::getACK(uint8_t *buffer, uint16_t size, uint8_t requestedClass, uint8_t requestedID, uint32_t waitMillis)
+GPS_RESPONSE GPS::waitAck()
 {
-    uint16_t ubxFrameCounter = 0;
-    uint32_t startTime = millis();
-    uint16_t needRead = 0;
-
-    while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (_serial_gps->available()) {
-            int c = _serial_gps->read();
-            switch (ubxFrameCounter) {
-            case 0:
-                // ubxFrame 'μ'
-                if (c == 0xB5) {
-                    ubxFrameCounter++;
-                }
-                break;
-            case 1:
-                // ubxFrame 'b'
-                if (c == 0x62) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 2:
-                // Class
-                if (c == requestedClass) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 3:
-                // Message ID
-                if (c == requestedID) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 4:
-                // Payload length lsb
-                needRead = c;
-                ubxFrameCounter++;
-                break;
-            case 5:
-                // Payload length msb
-                needRead |= (c << 8);
-                ubxFrameCounter++;
-                // Check for buffer overflow
-                if (needRead >= size) {
-                    ubxFrameCounter = 0;
-                    break;
-                }
-                if (_serial_gps->readBytes(buffer, needRead) != needRead) {
-                    ubxFrameCounter = 0;
-                } else {
-                    // return payload length
-#ifdef GPS_DEBUG
-                    LOG_INFO("Got ACK for class %02X message %02X in %dms", requestedClass, requestedID, millis() - startTime);
-#endif
-                    return needRead;
-                }
-                break;
+    while (!pollAck())
+        delay(1);
+    return pendingAck.result;
+}
 
-            default:
-                break;
-            }
+bool GPS::readFrame()
+{
+    while (true) {
+        if (rxPos == rxLen) {
+            int available = _serial_gps->available();
+            if (available <= 0)
+                return false;
+            rxLen = _serial_gps->readBytes(rxBuf, min(available, (int)sizeof(rxBuf)));
+            rxPos = 0;
+            if (!rxLen)
+                return false;
         }
+        rxPos += parser.feed(rxBuf + rxPos, rxLen - rxPos);
+        if (parser.frame().type != GPSStreamParser::FRAME_NONE)
+            return true;
     }
-    return 0;
 }
 
 #if GPS_BAUDRATE_FIXED
@@ -483,6 +442,11 @@ static const int rareSerialSpeeds[3] = {4800, 57600, GPS_BAUDRATE};
 #define GPS_PROBETRIES 2
 #endif
 
+// How often the GPS thread looks for the chip's answer while probing
+#ifndef GPS_PROBE_POLL_MSEC
+#define GPS_PROBE_POLL_MSEC 20
+#endif
+
 /**
  * @brief  Setup the GPS based on the model detected.
  *  We detect the GPS by cycling through a set of baud rates, first common then rare.
@@ -495,37 +459,42 @@ bool GPS::setup()
     if (!didSerialInit) {
         int msglen = 0;
         if (tx_gpio && gnssModel == GNSS_MODEL_UNKNOWN) {
+            if (!probing) {
+                if (!probeStartMsec)
+                    probeStartMsec = millis();
 #ifdef TRACKER_T1000_E
-            // add power up/down strategy, improve ag3335 detection success
-            digitalWrite(PIN_GPS_EN, LOW);
-            delay(500);
-            digitalWrite(GPS_VRTC_EN, LOW);
-            delay(1000);
-            digitalWrite(GPS_VRTC_EN, HIGH);
-            delay(500);
-            digitalWrite(PIN_GPS_EN, HIGH);
-            delay(1000);
+                // add power up/down strategy, improve ag3335 detection success
+                digitalWrite(PIN_GPS_EN, LOW);
+                delay(500);
+                digitalWrite(GPS_VRTC_EN, LOW);
+                delay(1000);
+                digitalWrite(GPS_VRTC_EN, HIGH);
+                delay(500);
+                digitalWrite(PIN_GPS_EN, HIGH);
+                delay(1000);
 #endif
-            if (probeTries < GPS_PROBETRIES) {
-                LOG_DEBUG("Probe for GPS at %d", serialSpeeds[speedSelect]);
-                gnssModel = probe(serialSpeeds[speedSelect]);
-                if (gnssModel == GNSS_MODEL_UNKNOWN) {
+            }
+            // Rare Serial Speeds once the common ones have been tried GPS_PROBETRIES times
+            bool rare = probeTries == GPS_PROBETRIES;
+            int speed = rare ? rareSerialSpeeds[speedSelect] : serialSpeeds[speedSelect];
+            if (!probing)
+                LOG_DEBUG("Probe for GPS at %d", speed);
+            gnssModel = probe(speed);
+            if (probing)
+                return false; // Still waiting for the chip to answer
+            if (gnssModel == GNSS_MODEL_UNKNOWN) {
+                if (!rare) {
                     if (++speedSelect == array_count(serialSpeeds)) {
                         speedSelect = 0;
                         ++probeTries;
                     }
+                } else if (++speedSelect == array_count(rareSerialSpeeds)) {
+                    LOG_WARN("Give up on GPS probe and set to %d", GPS_BAUDRATE);
+                    BootTimeline::span("GPS probe", probeStartMsec);
+                    return true;
                 }
-            }
-            // Rare Serial Speeds
-            if (probeTries == GPS_PROBETRIES) {
-                LOG_DEBUG("Probe for GPS at %d", rareSerialSpeeds[speedSelect]);
-                gnssModel = probe(rareSerialSpeeds[speedSelect]);
-                if (gnssModel == GNSS_MODEL_UNKNOWN) {
-                    if (++speedSelect == array_count(rareSerialSpeeds)) {
-                        LOG_WARN("Give up on GPS probe and set to %d", GPS_BAUDRATE);
-                        return true;
-                    }
-                }
+            } else {
+                BootTimeline::span("GPS probe", probeStartMsec);
             }
         }
 
@@ -1082,7 +1051,7 @@ int32_t GPS::runOnce()
             return disable();
         }
         if (!setup())
-            return 2000; // Setup failed, re-run in two seconds
+            return probing ? GPS_PROBE_POLL_MSEC : 2000; // Setup failed, re-run in two seconds
 
         // We have now loaded our saved preferences from flash
         if (config.position.gps_mode != meshtastic_Config_PositionConfig_GpsMode_ENABLED) {
@@ -1154,6 +1123,8 @@ int32_t GPS::runOnce()
 // clear the GPS rx/tx buffer as quickly as possible
 void GPS::clearBuffer()
 {
+    rxPos = rxLen = 0;
+    parser.reset();
 #ifdef ARCH_ESP32
     _serial_gps->flush(false);
 #else
@@ -1174,129 +1145,228 @@ int GPS::prepareDeepSleep(void *unused)
 static const char *PROBE_MESSAGE = "Trying %s (%s)...";
 static const char *DETECTED_MESSAGE = "%s detected";
 
-#define PROBE_SIMPLE(CHIP, TOWRITE, RESPONSE, DRIVER, TIMEOUT, ...)                                                              \
-    do {                                                                                                                         \
-        LOG_DEBUG(PROBE_MESSAGE, TOWRITE, CHIP);                                                                                 \
-        clearBuffer();                                                                                                           \
-        _serial_gps->write(TOWRITE "\r\n");                                                                                      \
-        if (getACK(RESPONSE, TIMEOUT) == GNSS_RESPONSE_OK) {                                                                     \
-            LOG_INFO(DETECTED_MESSAGE, CHIP);                                                                                    \
-            return DRIVER;                                                                                                       \
-        }                                                                                                                        \
-    } while (0)
-
-#define PROBE_FAMILY(FAMILY_NAME, COMMAND, RESPONSE_MAP, TIMEOUT)                                                                \
-    do {                                                                                                                         \
-        LOG_DEBUG(PROBE_MESSAGE, COMMAND, FAMILY_NAME);                                                                          \
-        clearBuffer();                                                                                                           \
-        _serial_gps->write(COMMAND "\r\n");                                                                                      \
-        GnssModel_t detectedDriver = getProbeResponse(TIMEOUT, RESPONSE_MAP);                                                    \
-        if (detectedDriver != GNSS_MODEL_UNKNOWN) {                                                                              \
-            return detectedDriver;                                                                                               \
-        }                                                                                                                        \
-    } while (0)
+// What we ask at each baud rate before trying UBX, in order. A chip is detected by a string in one of its answers.
+struct ProbeStep {
+    const char *family;
+    const char *prepare; // Sent ahead of the command, without waiting for an answer
+    const char *command;
+    std::vector<ChipInfo> chips;
+    uint32_t timeout;
+};
+
+static const std::vector<ProbeStep> &probeSteps()
+{
+    static const std::vector<ProbeStep> steps = {
+        // Unicore UFirebirdII Series: UC6580, UM620, UM621, UM670A, UM680A, or UM681A
+        {"Unicore Family",
+         nullptr,
+         "$PDTINFO",
+         {{"UC6580", "UC6580", GNSS_MODEL_UC6580}, {"UM600", "UM600", GNSS_MODEL_UC6580}},
+         500},
+        {"ATGM33xx Family",
+         nullptr,
+         "$PCAS06,1*1A",
+         {{"ATGM336H", "$GPTXT,01,01,02,HW=ATGM336H", GNSS_MODEL_ATGM336H},
+          /* ATGM332D series (-11(GPS), -21(BDS), -31(GPS+BDS), -51(GPS+GLONASS), -71-0(GPS+BDS+GLONASS)) based on AT6558 */
+          {"ATGM332D", "$GPTXT,01,01,02,HW=ATGM332D", GNSS_MODEL_ATGM336H}},
+         500},
+        /* Airoha (Mediatek) AG3335A/M/S, A3352Q, Quectel L89 2.0, SimCom SIM65M */
+        {"Airoha Family",
+         "$PAIR062,2,0*3C\r\n"  // GSA OFF to reduce volume
+         "$PAIR062,3,0*3D\r\n"  // GSV OFF to reduce volume
+         "$PAIR513*3D\r\n",     // save configuration
+         "$PAIR021*39",
+         {{"AG3335", "$PAIR021,AG3335", GNSS_MODEL_AG3335},
+          {"AG3352", "$PAIR021,AG3352", GNSS_MODEL_AG3352},
+          {"RYS3520", "$PAIR021,REYAX_RYS3520_V2", GNSS_MODEL_AG3352}},
+         1000},
+        {"LC86", nullptr, "$PQTMVERNO*58", {{"LC86", "$PQTMVERNO,LC86", GNSS_MODEL_AG3352}}, 500},
+        {"L76K", nullptr, "$PCAS06,0*1B", {{"L76K", "$GPTXT,01,01,02,SW=", GNSS_MODEL_MTK}}, 500},
+        // Close all NMEA sentences, valid for MTK3333 and MTK3339 platforms
+        {"MTK Family",
+         "$PMTK514,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0*2E\r\n",
+         "$PMTK605*31",
+         {{"L76B", "Quectel-L76B", GNSS_MODEL_MTK_L76B},
+          {"PA1010D", "1010D", GNSS_MODEL_MTK_PA1010D},
+          {"PA1616S", "1616S", GNSS_MODEL_MTK_PA1616S},
+          {"LS20031", "MC-1513", GNSS_MODEL_MTK_L76B},
+          {"L96", "Quectel-L96", GNSS_MODEL_MTK_L76B},
+          {"L80-R", "_3337_", GNSS_MODEL_MTK_L76B},
+          {"L80", "_3339_", GNSS_MODEL_MTK_L76B}},
+         500},
+    };
+    return steps;
+}
+
+void GPS::pauseProbe(uint32_t ms)
+{
+    probeWaitStart = millis();
+    probeWait = ms;
+}
+
+GnssModel_t GPS::finishProbe(GnssModel_t model)
+{
+    probing = false;
+    probeState = PROBE_BAUD;
+    probeWait = 0;
+    return model;
+}
 
+/**
+ * Detect the chip at one baud rate. This never blocks for an answer: while probing is set, call it again after
+ * GPS_PROBE_POLL_MSEC and it picks up where it was.
+ */
 GnssModel_t GPS::probe(int serialSpeed)
 {
+    probing = true;
+    while (true) {
+        if (probeWait) {
+            if (Throttle::isWithinTimespanMs(probeWaitStart, probeWait))
+                return GNSS_MODEL_UNKNOWN;
+            probeWait = 0;
+        }
+
+        switch (probeState) {
+        case PROBE_BAUD:
 #if defined(ARCH_NRF52) || defined(ARCH_PORTDUINO) || defined(ARCH_STM32WL)
-    _serial_gps->end();
-    _serial_gps->begin(serialSpeed);
+            _serial_gps->end();
+            _serial_gps->begin(serialSpeed);
 #elif defined(ARCH_RP2040)
-    _serial_gps->end();
-    _serial_gps->setFIFOSize(256);
-    _serial_gps->begin(serialSpeed);
+            _serial_gps->end();
+            _serial_gps->setFIFOSize(256);
+            _serial_gps->begin(serialSpeed);
 #else
-    if (_serial_gps->baudRate() != serialSpeed) {
-        LOG_DEBUG("Set Baud to %i", serialSpeed);
-        _serial_gps->updateBaudRate(serialSpeed);
-    }
+            if (_serial_gps->baudRate() != serialSpeed) {
+                LOG_DEBUG("Set Baud to %i", serialSpeed);
+                _serial_gps->updateBaudRate(serialSpeed);
+            }
 #endif
+            memset(&ublox_info, 0, sizeof(ublox_info));
+            probeState = PROBE_CLOSE_NMEA;
+            pauseProbe(100);
+            break;
 
-    memset(&ublox_info, 0, sizeof(ublox_info));
-    uint8_t buffer[768] = {0};
-    delay(100);
-
-    // Close all NMEA sentences, valid for L76K, ATGM336H (and likely other AT6558 devices)
-    _serial_gps->write("$PCAS03,0,0,0,0,0,0,0,0,0,0,,,0,0*02\r\n");
-    delay(20);
-    // Close NMEA sequences on Ublox
-    _serial_gps->write("$PUBX,40,GLL,0,0,0,0,0,0*5C\r\n");
-    _serial_gps->write("$PUBX,40,GSV,0,0,0,0,0,0*59\r\n");
-    _serial_gps->write("$PUBX,40,VTG,0,0,0,0,0,0*5E\r\n");
-    delay(20);
-
-    // Unicore UFirebirdII Series: UC6580, UM620, UM621, UM670A, UM680A, or UM681A
-    std::vector<ChipInfo> unicore = {{"UC6580", "UC6580", GNSS_MODEL_UC6580}, {"UM600", "UM600", GNSS_MODEL_UC6580}};
-    PROBE_FAMILY("Unicore Family", "$PDTINFO", unicore, 500);
-
-    std::vector<ChipInfo> atgm = {
-        {"ATGM336H", "$GPTXT,01,01,02,HW=ATGM336H", GNSS_MODEL_ATGM336H},
-        /* ATGM332D series (-11(GPS), -21(BDS), -31(GPS+BDS), -51(GPS+GLONASS), -71-0(GPS+BDS+GLONASS)) based on AT6558 */
-        {"ATGM332D", "$GPTXT,01,01,02,HW=ATGM332D", GNSS_MODEL_ATGM336H}};
-    PROBE_FAMILY("ATGM33xx Family", "$PCAS06,1*1A", atgm, 500);
-
-    /* Airoha (Mediatek) AG3335A/M/S, A3352Q, Quectel L89 2.0, SimCom SIM65M */
-    _serial_gps->write("$PAIR062,2,0*3C\r\n"); // GSA OFF to reduce volume
-    _serial_gps->write("$PAIR062,3,0*3D\r\n"); // GSV OFF to reduce volume
-    _serial_gps->write("$PAIR513*3D\r\n");     // save configuration
-    std::vector<ChipInfo> airoha = {{"AG3335", "$PAIR021,AG3335", GNSS_MODEL_AG3335},
-                                    {"AG3352", "$PAIR021,AG3352", GNSS_MODEL_AG3352},
-                                    {"RYS3520", "$PAIR021,REYAX_RYS3520_V2", GNSS_MODEL_AG3352}};
-    PROBE_FAMILY("Airoha Family", "$PAIR021*39", airoha, 1000);
-
-    PROBE_SIMPLE("LC86", "$PQTMVERNO*58", "$PQTMVERNO,LC86", GNSS_MODEL_AG3352, 500);
-    PROBE_SIMPLE("L76K", "$PCAS06,0*1B", "$GPTXT,01,01,02,SW=", GNSS_MODEL_MTK, 500);
-
-    // Close all NMEA sentences, valid for MTK3333 and MTK3339 platforms
-    _serial_gps->write("$PMTK514,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0*2E\r\n");
-    delay(20);
-    std::vector<ChipInfo> mtk = {{"L76B", "Quectel-L76B", GNSS_MODEL_MTK_L76B}, {"PA1010D", "1010D", GNSS_MODEL_MTK_PA1010D},
-                                 {"PA1616S", "1616S", GNSS_MODEL_MTK_PA1616S},  {"LS20031", "MC-1513", GNSS_MODEL_MTK_L76B},
-                                 {"L96", "Quectel-L96", GNSS_MODEL_MTK_L76B},   {"L80-R", "_3337_", GNSS_MODEL_MTK_L76B},
-                                 {"L80", "_3339_", GNSS_MODEL_MTK_L76B}};
-
-    PROBE_FAMILY("MTK Family", "$PMTK605*31", mtk, 500);
-
-    uint8_t cfg_rate[] = {0xB5, 0x62, 0x06, 0x08, 0x00, 0x00, 0x00, 0x00};
-    UBXChecksum(cfg_rate, sizeof(cfg_rate));
-    clearBuffer();
-    _serial_gps->write(cfg_rate, sizeof(cfg_rate));
-    // Check that the returned response class and message ID are correct
-    GPS_RESPONSE response = getACK(0x06, 0x08, 750);
-    if (response == GNSS_RESPONSE_NONE) {
-        LOG_WARN("No GNSS Module (baudrate %d)", serialSpeed);
-        return GNSS_MODEL_UNKNOWN;
-    } else if (response == GNSS_RESPONSE_FRAME_ERRORS) {
-        LOG_INFO("UBlox Frame Errors (baudrate %d)", serialSpeed);
-    }
+        case PROBE_CLOSE_NMEA:
+            // Close all NMEA sentences, valid for L76K, ATGM336H (and likely other AT6558 devices)
+            _serial_gps->write("$PCAS03,0,0,0,0,0,0,0,0,0,0,,,0,0*02\r\n");
+            probeState = PROBE_CLOSE_UBLOX;
+            pauseProbe(20);
+            break;
 
-    memset(buffer, 0, sizeof(buffer));
-    uint8_t _message_MONVER[8] = {
-        0xB5, 0x62, // Sync message for UBX protocol
-        0x0A, 0x04, // Message class and ID (UBX-MON-VER)
-        0x00, 0x00, // Length of payload (we're asking for an answer, so no payload)
-        0x00, 0x00  // Checksum
-    };
-    //  Get Ublox gnss module hardware and software info
-    UBXChecksum(_message_MONVER, sizeof(_message_MONVER));
-    clearBuffer();
-    _serial_gps->write(_message_MONVER, sizeof(_message_MONVER));
+        case PROBE_CLOSE_UBLOX:
+            // Close NMEA sequences on Ublox
+            _serial_gps->write("$PUBX,40,GLL,0,0,0,0,0,0*5C\r\n");
+            _serial_gps->write("$PUBX,40,GSV,0,0,0,0,0,0*59\r\n");
+            _serial_gps->write("$PUBX,40,VTG,0,0,0,0,0,0*5E\r\n");
+            probeIndex = 0;
+            probeState = PROBE_PREPARE;
+            pauseProbe(20);
+            break;
 
-    uint16_t len = getACK(buffer, sizeof(buffer), 0x0A, 0x04, 1200);
-    if (len) {
+        case PROBE_PREPARE:
+            if (probeIndex == probeSteps().size()) {
+                probeState = PROBE_UBX_RATE;
+                break;
+            }
+            probeState = PROBE_COMMAND;
+            if (probeSteps()[probeIndex].prepare) {
+                _serial_gps->write(probeSteps()[probeIndex].prepare);
+                pauseProbe(20);
+            }
+            break;
+
+        case PROBE_COMMAND: {
+            const ProbeStep &step = probeSteps()[probeIndex];
+            LOG_DEBUG(PROBE_MESSAGE, step.command, step.family);
+            clearBuffer();
+            _serial_gps->write(step.command);
+            _serial_gps->write("\r\n");
+            probeStepStart = millis();
+            probeState = PROBE_RESPONSE;
+            return GNSS_MODEL_UNKNOWN;
+        }
+
+        case PROBE_RESPONSE: {
+            const ProbeStep &step = probeSteps()[probeIndex];
+            GnssModel_t detected = pollProbeResponse(step.chips);
+            if (detected != GNSS_MODEL_UNKNOWN)
+                return finishProbe(detected);
+            if (Throttle::isWithinTimespanMs(probeStepStart, step.timeout))
+                return GNSS_MODEL_UNKNOWN;
+            probeIndex++;
+            probeState = PROBE_PREPARE;
+            break;
+        }
+
+        case PROBE_UBX_RATE: {
+            uint8_t cfg_rate[] = {0xB5, 0x62, 0x06, 0x08, 0x00, 0x00, 0x00, 0x00};
+            UBXChecksum(cfg_rate, sizeof(cfg_rate));
+            clearBuffer();
+            _serial_gps->write(cfg_rate, sizeof(cfg_rate));
+            // Check that the returned response class and message ID are correct
+            expectAck(0x06, 0x08, 750);
+            probeState = PROBE_UBX_RATE_ACK;
+            return GNSS_MODEL_UNKNOWN;
+        }
+
+        case PROBE_UBX_RATE_ACK: {
+            if (!pollAck())
+                return GNSS_MODEL_UNKNOWN;
+            if (pendingAck.result == GNSS_RESPONSE_NONE) {
+                LOG_WARN("No GNSS Module (baudrate %d)", serialSpeed);
+                return finishProbe(GNSS_MODEL_UNKNOWN);
+            } else if (pendingAck.result == GNSS_RESPONSE_FRAME_ERRORS) {
+                LOG_INFO("UBlox Frame Errors (baudrate %d)", serialSpeed);
+            }
+
+            uint8_t _message_MONVER[8] = {
+                0xB5, 0x62, // Sync message for UBX protocol
+                0x0A, 0x04, // Message class and ID (UBX-MON-VER)
+                0x00, 0x00, // Length of payload (we're asking for an answer, so no payload)
+                0x00, 0x00  // Checksum
+            };
+            //  Get Ublox gnss module hardware and software info
+            UBXChecksum(_message_MONVER, sizeof(_message_MONVER));
+            clearBuffer();
+            _serial_gps->write(_message_MONVER, sizeof(_message_MONVER));
+            // The answer stays in the parser's frame, see below
+            expectMessage(nullptr, 0, 0x0A, 0x04, 1200);
+            probeState = PROBE_UBX_VERSION;
+            return GNSS_MODEL_UNKNOWN;
+        }
+
+        case PROBE_UBX_VERSION: {
+            if (!pollAck())
+                return GNSS_MODEL_UNKNOWN;
+            GnssModel_t detected = GNSS_MODEL_UNKNOWN;
+            if (pendingAck.result == GNSS_RESPONSE_OK)
+                detected = identifyUblox(parser.frame().payload(), parser.frame().payloadLen());
+            if (detected == GNSS_MODEL_UNKNOWN)
+                LOG_WARN("No GNSS Module (baudrate %d)", serialSpeed);
+            return finishProbe(detected);
+        }
+        }
+    }
+}
+
+GnssModel_t GPS::identifyUblox(const uint8_t *payload, uint16_t len)
+{
+    char scratch[32] = {0};
+    // Software and hardware version come first, then 30 bytes per extension
+    if (len >= 40) {
         uint16_t position = 0;
         for (int i = 0; i < 30; i++) {
-            ublox_info.swVersion[i] = buffer[position];
+            ublox_info.swVersion[i] = payload[position];
             position++;
         }
         for (int i = 0; i < 10; i++) {
-            ublox_info.hwVersion[i] = buffer[position];
+            ublox_info.hwVersion[i] = payload[position];
             position++;
         }
 
         while (len >= position + 30) {
             for (int i = 0; i < 30; i++) {
-                ublox_info.extension[ublox_info.extensionNo][i] = buffer[position];
+                ublox_info.extension[ublox_info.extensionNo][i] = payload[position];
                 position++;
             }
             ublox_info.extensionNo++;
@@ -1312,19 +1382,17 @@ GnssModel_t GPS::probe(int serialSpeed)
             LOG_DEBUG("  %s", ublox_info.extension[i]);
         }
 
-        memset(buffer, 0, sizeof(buffer));
-
         // tips: extensionNo field is 0 on some 6M GNSS modules
         for (int i = 0; i < ublox_info.extensionNo; ++i) {
             if (!strncmp(ublox_info.extension[i], "MOD=", 4)) {
-                strncpy((char *)buffer, &(ublox_info.extension[i][4]), sizeof(buffer));
+                strncpy(scratch, &(ublox_info.extension[i][4]), sizeof(scratch) - 1);
             } else if (!strncmp(ublox_info.extension[i], "PROTVER", 7)) {
                 char *ptr = nullptr;
-                memset(buffer, 0, sizeof(buffer));
-                strncpy((char *)buffer, &(ublox_info.extension[i][8]), sizeof(buffer));
-                LOG_DEBUG("Protocol Version:%s", (char *)buffer);
-                if (strlen((char *)buffer)) {
-                    ublox_info.protocol_version = strtoul((char *)buffer, &ptr, 10);
+                memset(scratch, 0, sizeof(scratch));
+                strncpy(scratch, &(ublox_info.extension[i][8]), sizeof(scratch) - 1);
+                LOG_DEBUG("Protocol Version:%s", scratch);
+                if (strlen(scratch)) {
+                    ublox_info.protocol_version = strtoul(scratch, &ptr, 10);
                     LOG_DEBUG("ProtVer=%d", ublox_info.protocol_version);
                 } else {
                     ublox_info.protocol_version = 0;
@@ -1348,40 +1416,27 @@ GnssModel_t GPS::probe(int serialSpeed)
             return GNSS_MODEL_UBLOX10;
         }
     }
-    LOG_WARN("No GNSS Module (baudrate %d)", serialSpeed);
     return GNSS_MODEL_UNKNOWN;
 }
 
-GnssModel_t GPS::getProbeResponse(unsigned long timeout, const std::vector<ChipInfo> &responseMap)
+GnssModel_t GPS::pollProbeResponse(const std::vector<ChipInfo> &responseMap)
 {
-    String response = "";
-    unsigned long start = millis();
-    while (millis() - start < timeout) {
-        if (_serial_gps->available()) {
-            response += (char)_serial_gps->read();
-
-            if (response.endsWith(",") || response.endsWith("\r\n")) {
+    while (readFrame()) {
+        const GPSStreamParser::Frame &f = parser.frame();
+        if (f.type != GPSStreamParser::FRAME_NMEA)
+            continue;
 #ifdef GPS_DEBUG
-                LOG_DEBUG(response.c_str());
+        LOG_DEBUG("%.*s", f.len, f.data);
 #endif
-                // check if we can see our chips
-                for (const auto &chipInfo : responseMap) {
-                    if (strstr(response.c_str(), chipInfo.detectionString.c_str()) != nullptr) {
-                        LOG_INFO("%s detected", chipInfo.chipName.c_str());
-                        return chipInfo.driver;
-                    }
-                }
-            }
-            if (response.endsWith("\r\n")) {
-                response.trim();
-                response = ""; // Reset the response string for the next potential message
+        // check if we can see our chips
+        for (const auto &chipInfo : responseMap) {
+            if (strnstr((const char *)f.data, chipInfo.detectionString.c_str(), f.len) != nullptr) {
+                LOG_INFO(DETECTED_MESSAGE, chipInfo.chipName.c_str());
+                return chipInfo.driver;
             }
         }
     }
-#ifdef GPS_DEBUG
-    LOG_DEBUG(response.c_str());
-#endif
-    return GNSS_MODEL_UNKNOWN; // Return empty string on timeout
+    return GNSS_MODEL_UNKNOWN;
 }
 
 GPS *GPS::createGps()
@@ -1576,13 +1631,11 @@ bool GPS::lookForLocation()
     // At a minimum, use the fixQuality indicator in GPGGA (FIXME?)
     fixQual = reader.fixQuality();
 
-#ifndef TINYGPS_OPTION_NO_STATISTICS
-    if (reader.failedChecksum() > lastChecksumFailCount) {
-        LOG_WARN("%u new GPS checksum failures, for a total of %u", reader.failedChecksum() - lastChecksumFailCount,
-                 reader.failedChecksum());
-        lastChecksumFailCount = reader.failedChecksum();
+    if (parser.getNmeaFailed() > lastChecksumFailCount) {
+        LOG_WARN("%u new GPS checksum failures, for a total of %u", parser.getNmeaFailed() - lastChecksumFailCount,
+                 parser.getNmeaFailed());
+        lastChecksumFailCount = parser.getNmeaFailed();
     }
-#endif
 
 #ifndef TINYGPS_OPTION_NO_CUSTOM_FIELDS
     fixType = atoi(gsafixtype.value()); // will set to zero if no data
@@ -1714,16 +1767,12 @@ bool GPS::hasLock()
 
 bool GPS::hasFlow()
 {
-    return reader.passedChecksum() > 0;
+    return parser.getNmeaPassed() + parser.getUbxPassed() > 0;
 }
 
 bool GPS::whileActive()
 {
-    unsigned int charsInBuf = 0;
     bool isValid = false;
-#ifdef GPS_DEBUG
-    std::string debugmsg = "";
-#endif
     if (powerState != GPS_ACTIVE) {
         clearBuffer();
         return false;
@@ -1735,27 +1784,24 @@ bool GPS::whileActive()
     }
 #endif
     // First consume any chars that have piled up at the receiver
-    while (_serial_gps->available() > 0) {
-        int c = _serial_gps->read();
-        UBXscratch[charsInBuf] = c;
+    static const char ubloxBoot[] = "$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50";
+    while (readFrame()) {
+        const GPSStreamParser::Frame &f = parser.frame();
+        if (f.type != GPSStreamParser::FRAME_NMEA)
+            continue;
 #ifdef GPS_DEBUG
-        debugmsg += vformat("%c", (c >= 32 && c <= 126) ? c : '.');
-#endif
-        isValid |= reader.encode(c);
-        if (charsInBuf > sizeof(UBXscratch) - 10 || c == '\r') {
-            if (strnstr((char *)UBXscratch, "$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50", charsInBuf)) {
-                rebootsSeen++;
-            }
-            charsInBuf = 0;
-        } else {
-            charsInBuf++;
-        }
+        LOG_DEBUG("%.*s", f.len, f.data);
+#endif
+        // TinyGPS++ only gets the sentences that passed their checksum, with the line end it expects
+        if (!f.valid)
+            continue;
+        if (f.len == sizeof(ubloxBoot) - 1 && memcmp(f.data, ubloxBoot, f.len) == 0)
+            rebootsSeen++;
+        for (uint16_t i = 0; i < f.len; i++)
+            reader.encode(f.data[i]);
+        isValid |= reader.encode('\r');
+        reader.encode('\n');
     }
-#ifdef GPS_DEBUG
-    if (debugmsg != "") {
-        LOG_DEBUG(debugmsg.c_str());
-    }
-#endif
     return isValid;
 }
 void GPS::enable()
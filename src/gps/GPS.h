@@ -3,6 +3,7 @@
 #if !MESHTASTIC_EXCLUDE_GPS
 
 #include "GPSStatus.h"
+#include "GPSStreamParser.h"
 #include "GpioLogic.h"
 #include "Observer.h"
 #include "TinyGPS++.h"
@@ -148,6 +149,10 @@ class GPS : private concurrency::OSThread
     GnssModel_t gnssModel = GNSS_MODEL_UNKNOWN;
 
     TinyGPSPlus reader;
+    GPSStreamParser parser;
+    // Bytes taken from the serial port that the parser hasn't used yet
+    uint8_t rxBuf[64];
+    uint8_t rxPos = 0, rxLen = 0;
     uint8_t fixQual = 0; // fix quality from GPGGA
     uint32_t lastChecksumFailCount = 0;
 
@@ -209,6 +214,31 @@ class GPS : private concurrency::OSThread
 
     GPS_RESPONSE getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis);
 
+    // A response of the chip we are waiting for, see expectAck() and pollAck()
+    struct PendingAck {
+        enum Kind : uint8_t { NONE, UBX_ACK, UBX_MESSAGE, TEXT } kind = NONE;
+        uint8_t cls = 0, id = 0;
+        const char *text = nullptr;
+        uint8_t *buffer = nullptr;
+        uint16_t size = 0, payloadLen = 0;
+        uint32_t start = 0, timeout = 0;
+        GPS_RESPONSE result = GNSS_RESPONSE_NONE;
+    } pendingAck;
+
+    /// Start waiting for the UBX-ACK-ACK or UBX-ACK-NAK of a command
+    void expectAck(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis);
+    /// Start waiting for a UBX message, its payload is copied to buffer
+    void expectMessage(uint8_t *buffer, uint16_t size, uint8_t class_id, uint8_t msg_id, uint32_t waitMillis);
+    /// Start waiting for an NMEA sentence that contains message
+    void expectText(const char *message, uint32_t waitMillis);
+    /// Look at what the chip sent without blocking, @return true once pendingAck.result has the answer or the wait timed out
+    bool pollAck();
+    /// Block until pollAck() is done
+    GPS_RESPONSE waitAck();
+
+    /// Feed what the serial port has to the parser, @return true if that completed a frame
+    bool readFrame();
+
     /// Prepare the GPS for the cpu entering deep sleep, expect to be gone for at least 100s of msecs
     /// always returns 0 to indicate okay to sleep
     int prepareDeepSleep(void *unused);
@@ -236,9 +266,30 @@ class GPS : private concurrency::OSThread
 
     virtual int32_t runOnce() override;
 
-    GnssModel_t getProbeResponse(unsigned long timeout, const std::vector<ChipInfo> &responseMap);
-
-    // Get GNSS model
+    // Where probe() is at the current baud rate
+    enum ProbeState : uint8_t {
+        PROBE_BAUD,
+        PROBE_CLOSE_NMEA,
+        PROBE_CLOSE_UBLOX,
+        PROBE_PREPARE,
+        PROBE_COMMAND,
+        PROBE_RESPONSE,
+        PROBE_UBX_RATE,
+        PROBE_UBX_RATE_ACK,
+        PROBE_UBX_VERSION
+    };
+    ProbeState probeState = PROBE_BAUD;
+    bool probing = false;   // probe() is waiting for the chip and wants to be called again
+    uint8_t probeIndex = 0; // The question we are asking
+    uint32_t probeStepStart = 0, probeWaitStart = 0, probeWait = 0;
+    uint32_t probeStartMsec = 0; // For the boot timeline
+
+    void pauseProbe(uint32_t ms);
+    GnssModel_t finishProbe(GnssModel_t model);
+    GnssModel_t pollProbeResponse(const std::vector<ChipInfo> &responseMap);
+    GnssModel_t identifyUblox(const uint8_t *payload, uint16_t len);
+
+    // Get GNSS model, one step at a time
     GnssModel_t probe(int serialSpeed);
 
     // delay counter to allow more sats before fixed position stops GPS thread
@@ -0,0 +1,192 @@
+#include "GPSStreamParser.h"
+
+#include <algorithm>
+#include <string.h>
+
+static const uint8_t UBX_SYNC_1 = 0xB5;
+static const uint8_t UBX_SYNC_2 = 0x62;
+static const uint16_t UBX_HEADER_LEN = 6; // Sync chars, class, id and payload length
+
+static int hexValue(uint8_t c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+uint8_t GPSStreamParser::nmeaChecksum(const uint8_t *data, size_t len)
+{
+    uint32_t x = 0;
+    size_t i = 0;
+    for (; i + sizeof(x) <= len; i += sizeof(x)) {
+        uint32_t w;
+        memcpy(&w, data + i, sizeof(w));
+        x ^= w;
+    }
+    uint8_t c = x ^ (x >> 8) ^ (x >> 16) ^ (x >> 24);
+    for (; i < len; i++)
+        c ^= data[i];
+    return c;
+}
+
+void GPSStreamParser::reset()
+{
+    state = IDLE;
+    pos = 0;
+    need = 0;
+    current = Frame();
+}
+
+void GPSStreamParser::startNmea()
+{
+    buf[0] = '$';
+    pos = 1;
+    state = NMEA;
+}
+
+void GPSStreamParser::startUbx()
+{
+    buf[0] = UBX_SYNC_1;
+    buf[1] = UBX_SYNC_2;
+    pos = 2;
+    ckA = ckB = 0;
+    state = UBX_HEADER;
+}
+
+void GPSStreamParser::endNmea()
+{
+    // "$<body>*<two hex digits>"
+    bool valid = false;
+    if (pos >= 4 && buf[pos - 3] == '*') {
+        int hi = hexValue(buf[pos - 2]), lo = hexValue(buf[pos - 1]);
+        valid = hi >= 0 && lo >= 0 && nmeaChecksum(buf + 1, pos - 4) == ((hi << 4) | lo);
+    }
+    if (valid)
+        nmeaPassed++;
+    else
+        nmeaFailed++;
+
+    current.type = FRAME_NMEA;
+    current.valid = valid;
+    current.data = buf;
+    current.len = pos;
+    state = IDLE;
+}
+
+void GPSStreamParser::endUbx()
+{
+    bool valid = buf[pos - 2] == ckA && buf[pos - 1] == ckB;
+    if (valid)
+        ubxPassed++;
+    else
+        ubxFailed++;
+
+    current.type = FRAME_UBX;
+    current.valid = valid;
+    current.data = buf;
+    current.len = pos;
+    current.ubxClass = buf[2];
+    current.ubxId = buf[3];
+    state = IDLE;
+}
+
+size_t GPSStreamParser::feed(const uint8_t *data, size_t len)
+{
+    current = Frame();
+    size_t i = 0;
+    while (i < len) {
+        switch (state) {
+        case IDLE:
+            // Skip the line ends and whatever noise is between frames
+            if (data[i] == '$')
+                startNmea();
+            else if (data[i] == UBX_SYNC_1)
+                state = UBX_SYNC;
+            i++;
+            break;
+
+        case UBX_SYNC:
+            if (data[i] == UBX_SYNC_2) {
+                startUbx();
+                i++;
+            } else {
+                state = IDLE; // Look at this byte again, it might start a frame itself
+            }
+            break;
+
+        case UBX_HEADER:
+            buf[pos++] = data[i];
+            ckA += data[i];
+            ckB += ckA;
+            i++;
+            if (pos == UBX_HEADER_LEN) {
+                need = (buf[4] | (buf[5] << 8)) + 2; // Payload and checksum
+                if ((size_t)UBX_HEADER_LEN + need > sizeof(buf)) {
+                    overflows++;
+                    state = UBX_SKIP;
+                } else {
+                    state = UBX_BODY;
+                }
+            }
+            break;
+
+        case UBX_BODY: {
+            size_t n = std::min((size_t)need, len - i);
+            memcpy(buf + pos, data + i, n);
+            // The last two bytes are the checksum itself
+            uint16_t end = std::min<uint16_t>(pos + n, pos + need - 2);
+            for (uint16_t k = pos; k < end; k++) {
+                ckA += buf[k];
+                ckB += ckA;
+            }
+            pos += n;
+            need -= n;
+            i += n;
+            if (!need) {
+                endUbx();
+                return i;
+            }
+            break;
+        }
+
+        case UBX_SKIP: {
+            size_t n = std::min((size_t)need, len - i);
+            need -= n;
+            i += n;
+            if (!need)
+                state = IDLE;
+            break;
+        }
+
+        case NMEA: {
+            // Take the printable run in one go
+            size_t start = i;
+            while (i < len && data[i] >= 0x20 && data[i] < 0x7F && data[i] != '$')
+                i++;
+            size_t n = i - start;
+            if (pos + n > sizeof(buf)) {
+                overflows++;
+                state = IDLE;
+                break;
+            }
+            memcpy(buf + pos, data + start, n);
+            pos += n;
+            if (i == len)
+                break;
+            if (data[i] == '\r' || data[i] == '\n') {
+                endNmea();
+                return i + 1;
+            }
+            // A '$' or a binary byte cut the sentence short, look at it again from the start
+            nmeaFailed++;
+            state = IDLE;
+            break;
+        }
+        }
+    }
+    return i;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Longest frame we keep, UBX-MON-VER with all its extensions is the largest message we ask for
+#ifndef GPS_PARSER_FRAME_SIZE
+#define GPS_PARSER_FRAME_SIZE 512
+#endif
+
+/**
+ * Splits the byte stream of a GNSS receiver into NMEA sentences and UBX frames in a single pass, and checks their checksums.
+ *
+ * Bytes are taken a run at a time, so the receive buffer of the UART can be handed over as it is. A finished frame is
+ * returned from the parser's own buffer without copying it again, and stays valid until the next call to feed().
+ */
+class GPSStreamParser
+{
+  public:
+    enum FrameType : uint8_t { FRAME_NONE, FRAME_NMEA, FRAME_UBX };
+
+    struct Frame {
+        FrameType type = FRAME_NONE;
+        bool valid = false;            // The checksum matched, an NMEA sentence without checksum is never valid
+        const uint8_t *data = nullptr; // NMEA from '$' up to the line end, UBX from the sync chars up to the checksum
+        uint16_t len = 0;
+        uint8_t ubxClass = 0, ubxId = 0;
+
+        const uint8_t *payload() const { return data + 6; }
+        uint16_t payloadLen() const { return type == FRAME_UBX ? len - 8 : 0; }
+    };
+
+    /**
+     * Consume bytes up to the end of the next frame.
+     * @return the number of bytes used, frame() has the frame if one was completed
+     */
+    size_t feed(const uint8_t *data, size_t len);
+
+    const Frame &frame() const { return current; }
+
+    /// Forget a partial frame, e.g. when the baud rate changes
+    void reset();
+
+    uint32_t getNmeaPassed() const { return nmeaPassed; }
+    uint32_t getNmeaFailed() const { return nmeaFailed; }
+    uint32_t getUbxPassed() const { return ubxPassed; }
+    uint32_t getUbxFailed() const { return ubxFailed; }
+    uint32_t getOverflows() const { return overflows; }
+
+    /// XOR of the characters of an NMEA sentence, computed a machine word at a time
+    static uint8_t nmeaChecksum(const uint8_t *data, size_t len);
+
+  private:
+    enum State : uint8_t { IDLE, NMEA, UBX_SYNC, UBX_HEADER, UBX_BODY, UBX_SKIP };
+
+    uint8_t buf[GPS_PARSER_FRAME_SIZE];
+    uint16_t pos = 0;
+    uint16_t need = 0; // UBX bytes still missing
+    uint8_t ckA = 0, ckB = 0;
+    State state = IDLE;
+    Frame current;
+
+    uint32_t nmeaPassed = 0, nmeaFailed = 0, ubxPassed = 0, ubxFailed = 0, overflows = 0;
+
+    void startNmea();
+    void startUbx();
+    void endNmea();
+    void endUbx();
+};
@@ -56,11 +56,21 @@ bool EInkDisplay::forceDisplay(uint32_t msecLimit)
     uint32_t now = millis();
     uint32_t sinceLast = now - lastDrawMsec;
 
-    if (adafruitDisplay && (sinceLast > msecLimit || lastDrawMsec == 0))
-        lastDrawMsec = now;
-    else
+    if (!adafruitDisplay || (sinceLast <= msecLimit && lastDrawMsec != 0))
         return false;
 
+#if !defined(USE_EINK_DYNAMICDISPLAY)
+    // Skip the refresh entirely if the image is the one already on the panel
+    // (EInkDynamicDisplay makes this decision itself, as it may want to redraw an unchanged image with a full refresh)
+    uint32_t frameHash = 2166136261UL; // FNV-1a
+    for (uint32_t i = 0; i < displayBufferSize; i++)
+        frameHash = (frameHash ^ buffer[i]) * 16777619UL;
+    if (lastDrawMsec != 0 && frameHash == lastFrameHash)
+        return false;
+    lastFrameHash = frameHash;
+#endif
+    lastDrawMsec = now;
+
     // FIXME - only draw bits have changed (use backbuf similar to the other displays)
     const bool flipped = config.display.flip_screen;
     for (uint32_t y = 0; y < displayHeight; y++) {
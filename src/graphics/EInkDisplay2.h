@@ -80,6 +80,11 @@ class EInkDisplay : public OLEDDisplay
   private:
     // FIXME quick hack to limit drawing to a very slow rate
     uint32_t lastDrawMsec = 0;
+
+#if !defined(USE_EINK_DYNAMICDISPLAY)
+    // Hash of the image on the panel, every refresh goes through forceDisplay()
+    uint32_t lastFrameHash = 0;
+#endif
 };
 
 #endif
@@ -12,6 +12,11 @@ EInkDynamicDisplay::EInkDynamicDisplay(uint8_t address, int sda, int scl, OLEDDI
 #ifdef EINK_LIMIT_GHOSTING_PX
     dirtyPixels = new uint8_t[EInkDisplay::displayBufferSize](); // Init with zeros
 #endif
+
+    // If diffing frames, grab memory for the previous one. Zeros: blank, as after clearScreen()
+#ifdef EINK_PARTIAL_WINDOW
+    previousFrame = new uint8_t[EInkDisplay::displayBufferSize]();
+#endif
 }
 
 // Destructor
@@ -21,6 +26,9 @@ EInkDynamicDisplay::~EInkDynamicDisplay()
 #ifdef EINK_LIMIT_GHOSTING_PX
     delete[] dirtyPixels;
 #endif
+#ifdef EINK_PARTIAL_WINDOW
+    delete[] previousFrame;
+#endif
 }
 
 // Screen requests a BACKGROUND frame
@@ -51,6 +59,13 @@ void EInkDynamicDisplay::configForFastRefresh()
 #if defined(PRIVATE_HW)
 #else
     // Otherwise:
+#ifdef EINK_PARTIAL_WINDOW
+    // Only refresh the part of the image which changed
+    if (dirtyRegion.w) {
+        adafruitDisplay->setPartialWindow(dirtyRegion.x, dirtyRegion.y, dirtyRegion.w, dirtyRegion.h);
+        return;
+    }
+#endif
     adafruitDisplay->setPartialWindow(0, 0, adafruitDisplay->width(), adafruitDisplay->height());
 #endif
 }
@@ -69,11 +84,19 @@ void EInkDynamicDisplay::configForFullRefresh()
 // Run any relevant GxEPD2 code, so next update will use correct refresh type
 void EInkDynamicDisplay::applyRefreshMode()
 {
+#ifdef EINK_PARTIAL_WINDOW
+    // Window moves with the changes, so set it for every FAST frame
+    if (refresh == FAST) {
+        configForFastRefresh();
+        currentConfig = FAST;
+    }
+#else
     // Change from FULL to FAST
     if (currentConfig == FULL && refresh == FAST) {
         configForFastRefresh();
         currentConfig = FAST;
     }
+#endif
 
     // Change from FAST back to FULL
     else if (currentConfig == FAST && refresh == FULL) {
@@ -158,6 +181,9 @@ bool EInkDynamicDisplay::determineMode()
     resetRateLimiting(); // Once determineMode() ends, will have to wait again
     hashImage();         // Generate here, so we can still copy it to previousImageHash, even if we skip the comparison check
     LOG_DEBUG("determineMode(): "); // Begin log entry
+#ifdef EINK_PARTIAL_WINDOW
+    findDirtyRegion(); // Exact comparison against the previous frame, replaces the hash
+#endif
 
     // Once mode determined, any remaining checks will bypass
     checkCosmetic();
@@ -298,8 +324,13 @@ void EInkDynamicDisplay::checkFrameMatchesPrevious()
         return;
 
     // If frame is *not* a duplicate, abort the check
+#ifdef EINK_PARTIAL_WINDOW
+    if (dirtyRegion.w)
+        return;
+#else
     if (imageHash != previousImageHash)
         return;
+#endif
 
 #if !defined(EINK_BACKGROUND_USES_FAST)
     // If BACKGROUND, and last update was FAST: redraw the same image in FULL (for display health + image quality)
@@ -386,6 +417,79 @@ void EInkDynamicDisplay::hashImage()
     }
 }
 
+#ifdef EINK_PARTIAL_WINDOW
+// Find the bounding box of all pixels which differ from the previous frame
+// Buffer is in OLEDDisplay format: each byte is a column of 8 rows ("page"), LSB at top
+void EInkDynamicDisplay::findDirtyRegion()
+{
+    const uint16_t pages = (displayHeight + 7) / 8;
+    uint8_t firstPageBits = 0; // Which rows differ, in the first and last dirty pages
+    uint8_t lastPageBits = 0;
+    bool found = false;
+
+    for (uint16_t page = 0; page < pages; page++) {
+        const uint8_t *now = buffer + (page * displayWidth);
+        const uint8_t *prev = previousFrame + (page * displayWidth);
+
+        // Most pages of a typical frame are unchanged
+        if (memcmp(now, prev, displayWidth) == 0)
+            continue;
+
+        uint8_t pageBits = 0;
+        for (uint16_t x = 0; x < displayWidth; x++) {
+            uint8_t diff = now[x] ^ prev[x];
+            if (!diff)
+                continue;
+            pageBits |= diff;
+            if (!found || x < dirtyColFirst)
+                dirtyColFirst = x;
+            if (!found || x > dirtyColLast)
+                dirtyColLast = x;
+            found = true;
+        }
+
+        if (firstPageBits == 0) {
+            dirtyPageFirst = page;
+            firstPageBits = pageBits;
+        }
+        dirtyPageLast = page;
+        lastPageBits = pageBits;
+    }
+
+    dirtyRegion = Region();
+    if (!found) {
+        LOG_DEBUG("dirtyRegion=none, ");
+        return;
+    }
+
+    // Narrow down to the exact rows
+    uint16_t yFirst = dirtyPageFirst * 8;
+    while (!(firstPageBits & 1)) {
+        firstPageBits >>= 1;
+        yFirst++;
+    }
+    uint16_t yLast = (dirtyPageLast * 8) + 7;
+    while (!(lastPageBits & 0x80)) {
+        lastPageBits <<= 1;
+        yLast--;
+    }
+    yLast = min(yLast, (uint16_t)(displayHeight - 1));
+
+    // Handle flip the same way as EInkDisplay::forceDisplay
+    dirtyRegion.w = (dirtyColLast - dirtyColFirst) + 1;
+    dirtyRegion.h = (yLast - yFirst) + 1;
+    if (config.display.flip_screen) {
+        dirtyRegion.x = (displayWidth - 1) - dirtyColLast;
+        dirtyRegion.y = (displayHeight - 1) - yLast;
+    } else {
+        dirtyRegion.x = dirtyColFirst;
+        dirtyRegion.y = yFirst;
+    }
+
+    LOG_DEBUG("dirtyRegion=%ux%u@%u,%u, ", dirtyRegion.w, dirtyRegion.h, dirtyRegion.x, dirtyRegion.y);
+}
+#endif
+
 // Store the results of determineMode() for future use, and reset for next call
 void EInkDynamicDisplay::storeAndReset()
 {
@@ -396,6 +500,9 @@ void EInkDynamicDisplay::storeAndReset()
     // Only store image hash if the display will update
     if (refresh != SKIPPED) {
         previousImageHash = imageHash;
+#ifdef EINK_PARTIAL_WINDOW
+        memcpy(previousFrame, buffer, displayBufferSize);
+#endif
     }
 
     frameFlags = BACKGROUND;
@@ -406,6 +513,26 @@ void EInkDynamicDisplay::storeAndReset()
 // Count how many ghost pixels the new image will display
 void EInkDynamicDisplay::countGhostPixels()
 {
+#ifdef EINK_PARTIAL_WINDOW
+    // Only the changed region will be refreshed, so ghosting elsewhere stays as previously counted.
+    // Within the region: take away the ghosts of the previous frame, then add those of the new frame
+    for (uint32_t page = dirtyPageFirst; dirtyRegion.w && page <= dirtyPageLast; page++) {
+        for (uint32_t i = (page * displayWidth) + dirtyColFirst; i <= (page * displayWidth) + dirtyColLast; i++) {
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                const bool dirty = (dirtyPixels[i] >> bit) & 1;
+                const bool wasBlank = !((previousFrame[i] >> bit) & 1);
+                const bool shouldBeBlank = !((buffer[i] >> bit) & 1);
+
+                if (dirty && wasBlank && ghostPixelCount)
+                    ghostPixelCount--;
+                if (dirty && shouldBeBlank)
+                    ghostPixelCount++;
+                if (!dirty && !shouldBeBlank)
+                    dirtyPixels[i] |= (1 << bit);
+            }
+        }
+    }
+#else
     // If a decision was already reached, don't run the check
     if (refresh != UNSPECIFIED)
         return;
@@ -429,6 +556,7 @@ void EInkDynamicDisplay::countGhostPixels()
                 dirtyPixels[i] |= (1 << bit);
         }
     }
+#endif
 
     LOG_DEBUG("ghostPixels=%hu, ", ghostPixelCount);
 }
@@ -436,11 +564,20 @@ void EInkDynamicDisplay::countGhostPixels()
 // Check if ghost pixel count exceeds the defined limit
 void EInkDynamicDisplay::checkExcessiveGhosting()
 {
+#ifdef EINK_PARTIAL_WINDOW
+    // Count for every frame which will be shown with a FAST refresh, even if that was decided by an earlier check.
+    // The count is updated incrementally, so must stay in step with previousFrame, which is replaced by each of these frames
+    if (refresh == UNSPECIFIED || refresh == FAST)
+        countGhostPixels();
+#endif
+
     // If a decision was already reached, don't run the check
     if (refresh != UNSPECIFIED)
         return;
 
+#ifndef EINK_PARTIAL_WINDOW
     countGhostPixels();
+#endif
 
     // If too many ghost pixels, select full refresh
     if (ghostPixelCount > EINK_LIMIT_GHOSTING_PX) {
@@ -455,6 +592,7 @@ void EInkDynamicDisplay::resetGhostPixelTracking()
 {
     // Copy the current frame into dirtyPixels[] from the display buffer
     memcpy(dirtyPixels, EInkDisplay::buffer, EInkDisplay::displayBufferSize);
+    ghostPixelCount = 0;
 }
 #endif // EINK_LIMIT_GHOSTING_PX
 
@@ -123,6 +123,24 @@ class EInkDynamicDisplay : public EInkDisplay, protected concurrency::NotifiedWo
     uint32_t ghostPixelCount = 0;   // Number of pixels with problematic ghosting. Retained here for LOG_DEBUG use
 #endif
 
+    // Optional - diff against the previous frame, and only refresh the window which changed
+    // Costs a copy of the display buffer. Small changes (clock, node count) then only send and refresh a few bytes of image
+#ifdef EINK_PARTIAL_WINDOW
+    struct Region {
+        uint16_t x = 0; // In display (GxEPD2) coordinates, after flip
+        uint16_t y = 0;
+        uint16_t w = 0; // Zero if nothing changed
+        uint16_t h = 0;
+    };
+    void findDirtyRegion();      // Bounding box of pixels which differ from the previous frame
+    uint8_t *previousFrame;      // Image which is currently shown, in OLEDDisplay buffer format (dynamically allocated mem)
+    Region dirtyRegion;          // Where the new frame differs from previousFrame
+    uint16_t dirtyPageFirst = 0; // The same region, in OLEDDisplay buffer pages (8 rows each) and columns
+    uint16_t dirtyPageLast = 0;
+    uint16_t dirtyColFirst = 0;
+    uint16_t dirtyColLast = 0;
+#endif
+
     // Conditional - async full refresh - only with modified meshtastic/GxEPD2
 #if defined(HAS_EINK_ASYNCFULL)
   public:
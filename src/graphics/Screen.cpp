@@ -1266,8 +1266,14 @@ static void drawGPScoordinates(OLEDDisplay *display, int16_t x, int16_t y, const
 float Screen::estimatedHeading(double lat, double lon)
 {
     static double oldLat, oldLon;
+    static double lastLat, lastLon; // Position of the previous call: usually the same, every UI tick
     static float b;
 
+    if (lat == lastLat && lon == lastLon)
+        return b;
+    lastLat = lat;
+    lastLon = lon;
+
     if (oldLat == 0) {
         // just prepare for next time
         oldLat = lat;
@@ -1292,6 +1298,22 @@ float Screen::estimatedHeading(double lat, double lon)
 static size_t nodeIndex;
 static int8_t prevFrame = -1;
 
+// Derived display data for the node shown by drawNodeInfo, which is called every UI tick while the frame is shown
+// Saves redoing the distance / bearing trig and string formatting when nothing has changed
+// Invalidated when NodeDB or GPS report a change (see Screen::handleStatusUpdate), or when a different node is shown
+static struct {
+    bool valid = false;
+    NodeNum num = 0;
+    meshtastic_Config_DisplayConfig_DisplayUnits units;
+    bool hasBearing = false;            // Do both nodes have a valid position
+    float distance = 0;                 // Meters
+    float bearingToOther = 0;           // Radians, relative to north
+    int16_t distStrDegrees = -1;        // Bearing which distStr was formatted for
+    uint32_t lastStrSecs = UINT32_MAX;  // Age which lastStr was formatted for
+    char lastStr[20];
+    char distStr[20];
+} nodeInfoCache;
+
 // Draw the arrow pointing to a node's location
 void Screen::drawNodeHeading(OLEDDisplay *display, int16_t compassX, int16_t compassY, uint16_t compassDiam, float headingRadian)
 {
@@ -1442,16 +1464,40 @@ static void drawNodeInfo(OLEDDisplay *display, OLEDDisplayUiState *state, int16_
         snprintf(signalStr, sizeof(signalStr), "Signal: %d%%", clamp((int)((node->snr + 10) * 5), 0, 100));
     }
 
-    static char lastStr[20];
-    screen->getTimeAgoStr(sinceLastSeen(node), lastStr, sizeof(lastStr));
+    meshtastic_NodeInfoLite *ourNode = nodeDB->getMeshNode(nodeDB->getNodeNum());
+    bool haveOurPosition = ourNode && nodeDB->hasValidPosition(ourNode);
+
+    // Recalculate distance and bearing only if something changed since we last drew this node
+    if (!nodeInfoCache.valid || nodeInfoCache.num != node->num || nodeInfoCache.units != config.display.units) {
+        nodeInfoCache.valid = true;
+        nodeInfoCache.num = node->num;
+        nodeInfoCache.units = config.display.units;
+        nodeInfoCache.lastStrSecs = UINT32_MAX;
+        nodeInfoCache.distStrDegrees = -1;
+        nodeInfoCache.hasBearing = haveOurPosition && nodeDB->hasValidPosition(node);
+        if (nodeInfoCache.hasBearing) {
+            const meshtastic_PositionLite &op = ourNode->position;
+            const meshtastic_PositionLite &p = node->position;
+            nodeInfoCache.distance =
+                GeoCoord::latLongToMeter(DegD(p.latitude_i), DegD(p.longitude_i), DegD(op.latitude_i), DegD(op.longitude_i));
+            nodeInfoCache.bearingToOther =
+                GeoCoord::bearing(DegD(op.latitude_i), DegD(op.longitude_i), DegD(p.latitude_i), DegD(p.longitude_i));
+        } else if (config.display.units == meshtastic_Config_DisplayConfig_DisplayUnits_IMPERIAL) {
+            strncpy(nodeInfoCache.distStr, "? mi ?°", sizeof(nodeInfoCache.distStr)); // might not have location data
+        } else {
+            strncpy(nodeInfoCache.distStr, "? km ?°", sizeof(nodeInfoCache.distStr));
+        }
+    }
 
-    static char distStr[20];
-    if (config.display.units == meshtastic_Config_DisplayConfig_DisplayUnits_IMPERIAL) {
-        strncpy(distStr, "? mi ?°", sizeof(distStr)); // might not have location data
-    } else {
-        strncpy(distStr, "? km ?°", sizeof(distStr));
+    // Age string only changes once per second at most
+    uint32_t agoSecs = sinceLastSeen(node);
+    if (agoSecs != nodeInfoCache.lastStrSecs) {
+        nodeInfoCache.lastStrSecs = agoSecs;
+        screen->getTimeAgoStr(agoSecs, nodeInfoCache.lastStr, sizeof(nodeInfoCache.lastStr));
     }
-    meshtastic_NodeInfoLite *ourNode = nodeDB->getMeshNode(nodeDB->getNodeNum());
+
+    char *lastStr = nodeInfoCache.lastStr;
+    char *distStr = nodeInfoCache.distStr;
     const char *fields[] = {username, lastStr, signalStr, distStr, NULL};
     int16_t compassX = 0, compassY = 0;
     uint16_t compassDiam = Screen::getCompassDiam(SCREEN_WIDTH, SCREEN_HEIGHT);
@@ -1466,7 +1512,7 @@ static void drawNodeInfo(OLEDDisplay *display, OLEDDisplayUiState *state, int16_
     }
     bool hasNodeHeading = false;
 
-    if (ourNode && (nodeDB->hasValidPosition(ourNode) || screen->hasHeading())) {
+    if (ourNode && (haveOurPosition || screen->hasHeading())) {
         const meshtastic_PositionLite &op = ourNode->position;
         float myHeading;
         if (screen->hasHeading())
@@ -1475,15 +1521,11 @@ static void drawNodeInfo(OLEDDisplay *display, OLEDDisplayUiState *state, int16_
             myHeading = screen->estimatedHeading(DegD(op.latitude_i), DegD(op.longitude_i));
         screen->drawCompassNorth(display, compassX, compassY, myHeading);
 
-        if (nodeDB->hasValidPosition(node)) {
+        if (nodeInfoCache.hasBearing) {
             // display direction toward node
             hasNodeHeading = true;
-            const meshtastic_PositionLite &p = node->position;
-            float d =
-                GeoCoord::latLongToMeter(DegD(p.latitude_i), DegD(p.longitude_i), DegD(op.latitude_i), DegD(op.longitude_i));
-
-            float bearingToOther =
-                GeoCoord::bearing(DegD(op.latitude_i), DegD(op.longitude_i), DegD(p.latitude_i), DegD(p.longitude_i));
+            float d = nodeInfoCache.distance;
+            float bearingToOther = nodeInfoCache.bearingToOther;
             // If the top of the compass is a static north then bearingToOther can be drawn on the compass directly
             // If the top of the compass is not a static north we need adjust bearingToOther based on heading
             if (!config.display.compass_north_top)
@@ -1493,17 +1535,22 @@ static void drawNodeInfo(OLEDDisplay *display, OLEDDisplayUiState *state, int16_
             float bearingToOtherDegrees = (bearingToOther < 0) ? bearingToOther + 2 * PI : bearingToOther;
             bearingToOtherDegrees = bearingToOtherDegrees * 180 / PI;
 
-            if (config.display.units == meshtastic_Config_DisplayConfig_DisplayUnits_IMPERIAL) {
-                if (d < (2 * MILES_TO_FEET))
-                    snprintf(distStr, sizeof(distStr), "%.0fft   %.0f°", d * METERS_TO_FEET, bearingToOtherDegrees);
-                else
-                    snprintf(distStr, sizeof(distStr), "%.1fmi   %.0f°", d * METERS_TO_FEET / MILES_TO_FEET,
-                             bearingToOtherDegrees);
-            } else {
-                if (d < 2000)
-                    snprintf(distStr, sizeof(distStr), "%.0fm   %.0f°", d, bearingToOtherDegrees);
-                else
-                    snprintf(distStr, sizeof(distStr), "%.1fkm   %.0f°", d / 1000, bearingToOtherDegrees);
+            // Heading may move the bearing, distance only changes with an invalidation
+            int16_t degrees = lroundf(bearingToOtherDegrees);
+            if (degrees != nodeInfoCache.distStrDegrees) {
+                nodeInfoCache.distStrDegrees = degrees;
+                if (config.display.units == meshtastic_Config_DisplayConfig_DisplayUnits_IMPERIAL) {
+                    if (d < (2 * MILES_TO_FEET))
+                        snprintf(distStr, sizeof(nodeInfoCache.distStr), "%.0fft   %d°", d * METERS_TO_FEET, degrees);
+                    else
+                        snprintf(distStr, sizeof(nodeInfoCache.distStr), "%.1fmi   %d°", d * METERS_TO_FEET / MILES_TO_FEET,
+                                 degrees);
+                } else {
+                    if (d < 2000)
+                        snprintf(distStr, sizeof(nodeInfoCache.distStr), "%.0fm   %d°", d, degrees);
+                    else
+                        snprintf(distStr, sizeof(nodeInfoCache.distStr), "%.1fkm   %d°", d / 1000, degrees);
+                }
             }
         }
     }
@@ -2498,7 +2545,7 @@ void DebugInfo::drawFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
     // Draw our hardware ID to assist with bluetooth pairing. Either prefix with Info or S&F Logo
     if (moduleConfig.store_forward.enabled) {
 #ifdef ARCH_ESP32
-        if (!Throttle::isWithinTimespanMs(storeForwardModule->lastHeartbeat,
+        if (!storeForwardModule || !Throttle::isWithinTimespanMs(storeForwardModule->lastHeartbeat,
                                           (storeForwardModule->heartbeatInterval * 1200))) { // no heartbeat, overlap a bit
 #if (defined(USE_EINK) || defined(ILI9341_DRIVER) || defined(ILI9342_DRIVER) || defined(ST7701_CS) || defined(ST7735_CS) ||      \
      defined(ST7789_CS) || defined(USE_ST7789) || defined(HX8357_CS) || defined(ILI9488_CS) || ARCH_PORTDUINO) &&                \
@@ -2766,6 +2813,10 @@ int Screen::handleStatusUpdate(const meshtastic::Status *arg)
             setFrames(FOCUS_PRESERVE); // Regen the list of screen frames (returning to same frame, if possible)
         }
         nodeDB->updateGUI = false;
+        nodeInfoCache.valid = false; // Node info or position changed: recalculate distance and bearing
+        break;
+    case STATUS_TYPE_GPS:
+        nodeInfoCache.valid = false; // We may have moved
         break;
     }
 
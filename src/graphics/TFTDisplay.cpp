@@ -18,6 +18,8 @@ extern SX1509 gpioExtender;
 #define TFT_MESH COLOR565(0x67, 0xEA, 0x94)
 #endif
 
+// TFT_FRAME_STATS: build with it set to a number of frames (e.g. -DTFT_FRAME_STATS=100) to log the average blit time per frame
+
 #if defined(ST7735S)
 #include <LovyanGFX.hpp> // Graphics and font library for ST7735 driver chip
 
@@ -990,37 +992,105 @@ TFTDisplay::TFTDisplay(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY g
 #endif
 }
 
+// Compare one page (8 rows) of the OLED page buffer against the back buffer a word at a time.
+// @return false if the page is unchanged, otherwise the first and last changed column
+static bool findDirtyColumns(const uint8_t *page, const uint8_t *back, uint16_t width, uint16_t &first, uint16_t &last)
+{
+    uint16_t x = 0;
+    for (; x + sizeof(uint32_t) <= width; x += sizeof(uint32_t)) {
+        uint32_t a, b;
+        memcpy(&a, page + x, sizeof(a));
+        memcpy(&b, back + x, sizeof(b));
+        if (a ^ b)
+            break;
+    }
+    for (; x < width && page[x] == back[x]; x++)
+        ;
+    if (x == width)
+        return false;
+    first = x;
+
+    x = width;
+    for (; x >= first + sizeof(uint32_t); x -= sizeof(uint32_t)) {
+        uint32_t a, b;
+        memcpy(&a, page + x - sizeof(uint32_t), sizeof(a));
+        memcpy(&b, back + x - sizeof(uint32_t), sizeof(b));
+        if (a ^ b)
+            break;
+    }
+    for (; x > first && page[x - 1] == back[x - 1]; x--)
+        ;
+    last = x - 1;
+    return true;
+}
+
 // Write the buffer to the display memory
 void TFTDisplay::display(bool fromBlank)
 {
+#ifdef TFT_FRAME_STATS
+    uint32_t start = micros();
+    uint32_t runs = 0;
+#endif
     if (fromBlank)
         tft->fillScreen(TFT_BLACK);
     // tft->clear();
     concurrency::LockGuard g(spiLock);
 
-    uint16_t x, y;
+    // All runs of a frame go out in a single SPI transaction
+    bool inTransaction = false;
 
-    for (y = 0; y < displayHeight; y++) {
-        for (x = 0; x < displayWidth; x++) {
-            auto isset = buffer[x + (y / 8) * displayWidth] & (1 << (y & 7));
-            if (!fromBlank) {
-                // get src pixel in the page based ordering the OLED lib uses FIXME, super inefficent
-                auto dblbuf_isset = buffer_back[x + (y / 8) * displayWidth] & (1 << (y & 7));
-                if (isset != dblbuf_isset) {
-                    tft->drawPixel(x, y, isset ? TFT_MESH : TFT_BLACK);
+    for (uint16_t pageY = 0; pageY < displayHeight; pageY += 8) {
+        const uint8_t *page = buffer + (pageY / 8) * displayWidth;
+        uint8_t *back = buffer_back + (pageY / 8) * displayWidth;
+        uint16_t first = 0, last = displayWidth - 1;
+        if (!fromBlank && !findDirtyColumns(page, back, displayWidth, first, last))
+            continue;
+
+        if (!inTransaction) {
+            tft->startWrite();
+            inTransaction = true;
+        }
+
+        // Within the dirty columns, draw each horizontal run of changed pixels that share a color as one line
+        for (uint16_t y = pageY; y < pageY + 8 && y < displayHeight; y++) {
+            uint8_t mask = 1 << (y & 7);
+            uint16_t x = first;
+            while (x <= last) {
+                bool isset = page[x] & mask;
+                bool changed = fromBlank ? isset : isset != (bool)(back[x] & mask);
+                if (!changed) {
+                    x++;
+                    continue;
                 }
-            } else if (isset) {
-                tft->drawPixel(x, y, TFT_MESH);
+                uint16_t runStart = x++;
+                while (x <= last && (bool)(page[x] & mask) == isset &&
+                       (fromBlank || (bool)(back[x] & mask) != isset))
+                    x++;
+                tft->drawFastHLine(runStart, y, x - runStart, isset ? TFT_MESH : TFT_BLACK);
+#ifdef TFT_FRAME_STATS
+                runs++;
+#endif
             }
         }
+
+        // Copy the dirty part of the page to the back buffer
+        memcpy(back + first, page + first, last - first + 1);
     }
-    // Copy the Buffer to the Back Buffer
-    for (y = 0; y < (displayHeight / 8); y++) {
-        for (x = 0; x < displayWidth; x++) {
-            uint16_t pos = x + y * displayWidth;
-            buffer_back[pos] = buffer[pos];
-        }
+
+    if (inTransaction)
+        tft->endWrite();
+
+#ifdef TFT_FRAME_STATS
+    static uint32_t frames, totalMicros, totalRuns;
+    frames++;
+    totalMicros += micros() - start;
+    totalRuns += runs;
+    if (frames == TFT_FRAME_STATS) {
+        LOG_DEBUG("TFT %u frames, %u us/frame (%u fps max), %u runs/frame", frames, totalMicros / frames,
+                  totalMicros ? 1000000UL * frames / totalMicros : 0, totalRuns / frames);
+        frames = totalMicros = totalRuns = 0;
     }
+#endif
 }
 
 // Send a command to the display (low level function)
@@ -7,7 +7,6 @@
  * An adapter class that allows using the LovyanGFX library as if it was an OLEDDisplay implementation.
  *
  * Remaining TODO:
- * optimize display() to only draw changed pixels (see other OLED subclasses for examples)
  * Use the fast NRF52 SPI API rather than the slow standard arduino version
  *
  * turn radio back on - currently with both on spi bus is fucked? or are we leaving chip select asserted?
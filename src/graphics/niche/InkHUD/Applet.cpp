@@ -34,6 +34,112 @@ void InkHUD::Applet::drawPixel(int16_t x, int16_t y, uint16_t color)
         assignedTile->handleAppletPixel(x, y, (Color)color);
 }
 
+// Crop a horizontal span to the user's cropped region, then pass it to the tile in one go
+void InkHUD::Applet::drawSpan(int16_t x, int16_t y, int16_t w, Color c)
+{
+    if (y < cropTop || y >= cropTop + cropHeight)
+        return;
+
+    int16_t x0 = max(x, cropLeft);
+    int16_t x1 = min((int16_t)(x + w), (int16_t)(cropLeft + cropWidth)); // Exclusive
+    if (x1 > x0)
+        assignedTile->handleAppletSpan(x0, y, x1 - x0, c);
+}
+
+// AdafruitGFX would draw these pixel by pixel
+void InkHUD::Applet::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    writeFastHLine(x, y, w, color);
+}
+
+void InkHUD::Applet::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    // Negative width extends left, as with AdafruitGFX
+    if (w < 0) {
+        x += w + 1;
+        w = -w;
+    }
+    drawSpan(x, y, w, (Color)color);
+}
+
+void InkHUD::Applet::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    writeFillRect(x, y, w, h, color);
+}
+
+// Fill one row at a time: spans are contiguous in the image buffer (unless rotated)
+void InkHUD::Applet::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (w < 0) {
+        x += w + 1;
+        w = -w;
+    }
+    if (h < 0) {
+        y += h + 1;
+        h = -h;
+    }
+    for (int16_t row = max(y, cropTop); row < min((int16_t)(y + h), (int16_t)(cropTop + cropHeight)); row++)
+        drawSpan(x, row, w, (Color)color);
+}
+
+// Print a character with an AppletFont, blitting the glyph as spans
+// Mirrors AdafruitGFX's handling of custom fonts, which otherwise passes each set bit of the glyph to drawPixel
+// Falls back to AdafruitGFX for the in-built font and scaled text
+size_t InkHUD::Applet::write(uint8_t c)
+{
+    if (!gfxFont || textsize_x != 1 || textsize_y != 1)
+        return GFX::write(c);
+
+    if (c == '\n') {
+        cursor_x = 0;
+        cursor_y += gfxFont->yAdvance;
+        return 1;
+    }
+    if (c == '\r' || c < gfxFont->first || c > gfxFont->last)
+        return 1;
+
+    const GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+    if (glyph->width > 0 && glyph->height > 0) {
+        if (wrap && (cursor_x + glyph->xOffset + glyph->width) > _width) {
+            cursor_x = 0;
+            cursor_y += gfxFont->yAdvance;
+        }
+        drawGlyph(cursor_x, cursor_y, glyph, (Color)textcolor);
+    }
+    cursor_x += glyph->xAdvance;
+    return 1;
+}
+
+// Glyph bitmaps are packed 1bpp, rows are not byte aligned
+// Consecutive set bits in a row become a single span
+void InkHUD::Applet::drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph, Color c)
+{
+    const uint8_t *bitmap = gfxFont->bitmap + glyph->bitmapOffset;
+    uint8_t bits = 0;
+    uint16_t bit = 0;
+
+    x += glyph->xOffset;
+    y += glyph->yOffset;
+
+    for (uint8_t yy = 0; yy < glyph->height; yy++) {
+        int16_t runStart = -1;
+        for (uint8_t xx = 0; xx < glyph->width; xx++) {
+            if (!(bit++ & 7))
+                bits = *bitmap++;
+            if (bits & 0x80) {
+                if (runStart < 0)
+                    runStart = xx;
+            } else if (runStart >= 0) {
+                drawSpan(x + runStart, y + yy, xx - runStart, c);
+                runStart = -1;
+            }
+            bits <<= 1;
+        }
+        if (runStart >= 0)
+            drawSpan(x + runStart, y + yy, glyph->width - runStart, c);
+    }
+}
+
 // Link our applet to a tile
 // This can only be called by Tile::assignApplet
 // The tile determines the applets dimensions
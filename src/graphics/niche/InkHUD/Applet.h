@@ -102,6 +102,14 @@ class Applet : public GFX
   protected:
     void drawPixel(int16_t x, int16_t y, uint16_t color) override; // Place a single pixel. All drawing output passes through here
 
+    // Fast paths, passing whole horizontal spans to the tile instead of single pixels
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    size_t write(uint8_t c) override; // Blits AppletFont glyphs as spans
+    using GFX::write;
+
     void requestUpdate(EInk::UpdateTypes type = EInk::UpdateTypes::UNSPECIFIED); // Ask WindowManager to schedule a display update
     void requestAutoshow();                                                      // Ask for applet to be moved to foreground
 
@@ -147,6 +155,9 @@ class Applet : public GFX
     Persistence::LatestMessage *latestMessage = nullptr;
 
   private:
+    void drawSpan(int16_t x, int16_t y, int16_t w, Color c); // Crop a horizontal span, then pass to tile
+    void drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph, Color c);
+
     Tile *assignedTile = nullptr; // Rendered pixels are fed into a Tile object, which translates them, then passes to WM
     bool active = false;          // Has the user enabled this applet (at run-time)?
     bool foreground = false;      // Is the applet currently drawn on a tile?
@@ -215,4 +215,11 @@ void InkHUD::InkHUD::drawPixel(int16_t x, int16_t y, Color c)
     renderer->handlePixel(x, y, c);
 }
 
+// Place a horizontal run of pixels into the image buffer
+// Same coordinates as drawPixel, but the renderer only needs to rotate once per span
+void InkHUD::InkHUD::drawSpan(int16_t x, int16_t y, uint16_t w, Color c)
+{
+    renderer->handleSpan(x, y, w, c);
+}
+
 #endif
\ No newline at end of file
@@ -93,6 +93,7 @@ class InkHUD
 
     // Pass drawing output to Renderer
     void drawPixel(int16_t x, int16_t y, Color c);
+    void drawSpan(int16_t x, int16_t y, uint16_t w, Color c);
 
     // Shared data which persists between boots
     Persistence *persistence = nullptr;
@@ -121,6 +121,69 @@ void InkHUD::Renderer::handlePixel(int16_t x, int16_t y, Color c)
     bitWrite(imageBuffer[byteNum], bitNum, c);
 }
 
+// Set a horizontal run of pixels into the image buffer
+// Rotation is applied once for the whole span: depending on rotation, it becomes either a row or a column of the buffer
+// Much cheaper than calling handlePixel for every pixel, for text, fills and map tiles
+void InkHUD::Renderer::handleSpan(int16_t x, int16_t y, uint16_t w, Color c)
+{
+    if (w == 0)
+        return;
+
+    switch (settings->rotation) {
+    case 0:
+        fillBufferRow(x, y, w, c);
+        break;
+    case 1:
+        fillBufferColumn((driver->width - 1) - y, x, w, c);
+        break;
+    case 2:
+        fillBufferRow((driver->width - 1) - (x + w - 1), (driver->height - 1) - y, w, c);
+        break;
+    case 3:
+        fillBufferColumn(y, (driver->height - 1) - (x + w - 1), w, c);
+        break;
+    }
+}
+
+// Set w pixels along one row of the image buffer, a whole byte at a time where aligned
+void InkHUD::Renderer::fillBufferRow(uint16_t x, uint16_t y, uint16_t w, Color c)
+{
+    uint8_t *row = imageBuffer + (y * imageBufferWidth);
+    uint16_t end = x + w; // Exclusive
+
+    // Leading partial byte
+    while ((x % 8) && x < end) {
+        bitWrite(row[x / 8], 7 - (x % 8), c);
+        x++;
+    }
+
+    // Whole bytes
+    uint16_t wholeBytes = (end - x) / 8;
+    memset(row + (x / 8), c ? 0xFF : 0x00, wholeBytes);
+    x += wholeBytes * 8;
+
+    // Trailing partial byte
+    while (x < end) {
+        bitWrite(row[x / 8], 7 - (x % 8), c);
+        x++;
+    }
+}
+
+// Set h pixels down one column of the image buffer: same bit in consecutive rows
+void InkHUD::Renderer::fillBufferColumn(uint16_t x, uint16_t y, uint16_t h, Color c)
+{
+    uint8_t *byte = imageBuffer + (y * imageBufferWidth) + (x / 8);
+    uint8_t mask = 1 << (7 - (x % 8));
+
+    for (uint16_t i = 0; i < h; i++) {
+        if (c)
+            *byte |= mask;
+        else
+            *byte &= ~mask;
+        byte += imageBufferWidth;
+    }
+}
+
 // Width of the display, relative to rotation
 uint16_t InkHUD::Renderer::width()
 {
@@ -219,10 +282,12 @@ void InkHUD::Renderer::render(bool async)
         Drivers::EInk::UpdateTypes updateType = decideUpdateType();
 
         // Render the new image
+        uint32_t renderStarted = micros();
         clearBuffer();
         renderUserApplets();
         renderPlaceholders();
         renderSystemApplets();
+        LOG_DEBUG("Rendered in %luus", (unsigned long)(micros() - renderStarted));
 
         // Tell display to begin process of drawing new image
         LOG_INFO("Updating display");
@@ -46,6 +46,7 @@ class Renderer : protected concurrency::OSThread
 
     // Receives pixel output from an applet (via a tile, which translates the coordinates)
     void handlePixel(int16_t x, int16_t y, Color c);
+    void handleSpan(int16_t x, int16_t y, uint16_t w, Color c); // Horizontal run of pixels, same coordinates as handlePixel
 
     // Size of display, in context of current rotation
 
@@ -59,6 +60,10 @@ class Renderer : protected concurrency::OSThread
     // Apply the display rotation to handled pixels
     void rotatePixelCoords(int16_t *x, int16_t *y);
 
+    // Set runs of pixels directly in the image buffer, in driver (unrotated) coordinates
+    void fillBufferRow(uint16_t x, uint16_t y, uint16_t w, Color c);
+    void fillBufferColumn(uint16_t x, uint16_t y, uint16_t h, Color c);
+
     // Execute the render process now, then hand off to driver for display update
     void render(bool async = true);
 
@@ -190,6 +190,23 @@ void InkHUD::Tile::handleAppletPixel(int16_t x, int16_t y, Color c)
     }
 }
 
+// Receive a horizontal run of pixels from the assigned applet
+// Same as handleAppletPixel, but the span is clipped once to the tile borders, instead of per pixel
+void InkHUD::Tile::handleAppletSpan(int16_t x, int16_t y, int16_t w, Color c)
+{
+    // Move pixels from applet-space to tile-space
+    x += left;
+    y += top;
+
+    // Crop to tile borders
+    if (y < top || y >= top + height)
+        return;
+    int16_t x0 = max(x, left);
+    int16_t x1 = min((int16_t)(x + w), (int16_t)(left + width)); // Exclusive
+    if (x1 > x0)
+        inkhud->drawSpan(x0, y, x1 - x0, c);
+}
+
 // Called by Applet base class, when setting applet dimensions, immediately before render
 uint16_t InkHUD::Tile::getWidth()
 {
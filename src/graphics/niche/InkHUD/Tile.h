@@ -29,6 +29,7 @@ class Tile
     void setRegion(uint8_t layoutSize, uint8_t tileIndex);                      // Assign region automatically, based on layout
     void setRegion(int16_t left, int16_t top, uint16_t width, uint16_t height); // Assign region manually
     void handleAppletPixel(int16_t x, int16_t y, Color c);                      // Receive px output from assigned applet
+    void handleAppletSpan(int16_t x, int16_t y, int16_t w, Color c);            // Receive a horizontal run of px
     uint16_t getWidth();
     uint16_t getHeight();
     static uint16_t maxDisplayDimension(); // Largest possible width / height any tile may ever encounter
@@ -15,6 +15,7 @@
 #include "Led.h"
 #include "RTC.h"
 #include "SPILock.h"
+#include "BootTimeline.h"
 #include "Throttle.h"
 #include "concurrency/OSThread.h"
 #include "concurrency/Periodic.h"
@@ -32,6 +33,7 @@
 #include "main.h"
 #include "mesh/generated/meshtastic/config.pb.h"
 #include "meshUtils.h"
+#include "mesh/PacketAggregator.h"
 #include "modules/Modules.h"
 #include "shutdown.h"
 #include "sleep.h"
@@ -90,6 +92,7 @@ NRF52Bluetooth *nrf52Bluetooth = nullptr;
 #ifdef ARCH_PORTDUINO
 #include "linux/LinuxHardwareI2C.h"
 #include "mesh/raspihttp/PiWebServer.h"
+#include "platform/portduino/PacketReplay.h"
 #include "platform/portduino/PortduinoGlue.h"
 #include "platform/portduino/USBHal.h"
 #include <cstdlib>
@@ -405,6 +408,7 @@ void setup()
 
     powerMonInit();
     serialSinceMsec = millis();
+    BootTimeline::mark("console");
 
     LOG_INFO("\n\n//\\ E S H T /\\ S T / C\n");
 
@@ -481,6 +485,7 @@ void setup()
 #endif
 
     fsInit();
+    BootTimeline::mark("filesystem");
 
 #if defined(_SEEED_XIAO_NRF52840_SENSE_H_)
 
@@ -549,6 +554,7 @@ void setup()
     power->setStatusHandler(powerStatus);
     powerStatus->observe(&power->newStatus);
     power->setup(); // Must be after status handler is installed, so that handler gets notified of the initial configuration
+    BootTimeline::mark("power");
 
 #if !MESHTASTIC_EXCLUDE_I2C
     // We need to scan here to decide if we have a screen for nodeDB.init() and because power has been applied to
@@ -558,34 +564,37 @@ void setup()
     LOG_INFO("Scan for i2c devices");
 #endif
 
+    ScanI2C::I2CPort i2cPorts[2];
+    uint8_t i2cPortCount = 0;
 #if defined(I2C_SDA1) && defined(ARCH_RP2040)
     Wire1.setSDA(I2C_SDA1);
     Wire1.setSCL(I2C_SCL1);
     Wire1.begin();
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE1);
+    i2cPorts[i2cPortCount++] = ScanI2C::I2CPort::WIRE1;
 #elif defined(I2C_SDA1) && !defined(ARCH_RP2040)
     Wire1.begin(I2C_SDA1, I2C_SCL1);
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE1);
+    i2cPorts[i2cPortCount++] = ScanI2C::I2CPort::WIRE1;
 #elif defined(NRF52840_XXAA) && (WIRE_INTERFACES_COUNT == 2)
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE1);
+    i2cPorts[i2cPortCount++] = ScanI2C::I2CPort::WIRE1;
 #endif
 
 #if defined(I2C_SDA) && defined(ARCH_RP2040)
     Wire.setSDA(I2C_SDA);
     Wire.setSCL(I2C_SCL);
     Wire.begin();
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE);
+    i2cPorts[i2cPortCount++] = ScanI2C::I2CPort::WIRE;
 #elif defined(I2C_SDA) && !defined(ARCH_RP2040)
     Wire.begin(I2C_SDA, I2C_SCL);
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE);
+    i2cPorts[i2cPortCount++] = ScanI2C::I2CPort::WIRE;
 #elif defined(ARCH_PORTDUINO)
     if (settingsStrings[i2cdev] != "") {
         LOG_INFO("Scan for i2c devices");
-        i2cScanner->scanPort(ScanI2C::I2CPort::WIRE);
+        i2cPorts[i2cPortCount++] = ScanI2C::I2CPort::WIRE;
     }
 #elif HAS_WIRE
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE);
+    i2cPorts[i2cPortCount++] = ScanI2C::I2CPort::WIRE;
 #endif
+    i2cScanner->scanPorts(i2cPorts, i2cPortCount);
 
     auto i2cCount = i2cScanner->countDevices();
     if (i2cCount == 0) {
@@ -735,6 +744,7 @@ void setup()
 
     i2cScanner.reset();
 #endif
+    BootTimeline::mark("i2c scan");
 
 #ifdef HAS_SDCARD
     setupSDCard();
@@ -765,9 +775,12 @@ void setup()
     rp2040Setup();
 #endif
 
+    BootTimeline::mark("platform");
+
     // We do this as early as possible because this loads preferences from flash
     // but we need to do this after main cpu init (esp32setup), because we need the random seed set
     nodeDB = new NodeDB;
+    BootTimeline::mark("nodedb");
 
     // If we're taking on the repeater role, use NextHopRouter and turn off 3V3_S rail because peripherals are not needed
     if (config.device.role == meshtastic_Config_DeviceConfig_Role_REPEATER) {
@@ -778,6 +791,9 @@ void setup()
     } else
         router = new ReliableRouter();
 
+    if (USERPREFS_PACKET_AGGREGATION)
+        packetAggregator = new PacketAggregator();
+
 #if HAS_BUTTON || defined(ARCH_PORTDUINO)
     // Buttons. Moved here cause we need NodeDB to be initialized
     buttonThread = new ButtonThread();
@@ -886,6 +902,7 @@ void setup()
 #endif
 
     readFromRTC(); // read the main CPU RTC at first (in case we can't get GPS time)
+    BootTimeline::mark("screen, rtc");
 
 #if !MESHTASTIC_EXCLUDE_GPS
     // If we're taking on the repeater role, ignore GPS
@@ -908,6 +925,7 @@ void setup()
 #endif
 
 #endif
+    BootTimeline::mark("gps");
 
     nodeStatus->observe(&nodeDB->newStatus);
 
@@ -932,6 +950,7 @@ void setup()
 
     // Now that the mesh service is created, create any modules
     setupModules();
+    BootTimeline::mark("modules");
 
 #ifdef MESHTASTIC_INCLUDE_NICHE_GRAPHICS
     // After modules are setup, so we can observe modules
@@ -967,6 +986,7 @@ void setup()
 #endif
 
     screen->print("Started...\n");
+    BootTimeline::mark("screen setup");
 
 #ifdef PIN_PWR_DELAY_MS
     // This may be required to give the peripherals time to power up.
@@ -1234,6 +1254,7 @@ void setup()
     }
 
     lateInitVariant(); // Do board specific init (see extra_variants/README.md for documentation)
+    BootTimeline::mark("radio");
 
 #if !MESHTASTIC_EXCLUDE_MQTT
     mqttInit();
@@ -1272,10 +1293,13 @@ void setup()
     }
 #endif
     initApiServer(TCPPort);
+    if (replayPath)
+        packetReplay = new PacketReplay(replayPath, replaySpeed);
 #endif
 
     // Start airtime logger thread.
     airTime = new AirTime();
+    BootTimeline::mark("network");
 
     if (!rIf)
         RECORD_CRITICALERROR(meshtastic_CriticalErrorCode_NO_RADIO);
@@ -1291,6 +1315,7 @@ void setup()
     // This must be _after_ service.init because we need our preferences loaded from flash to have proper timeout values
     PowerFSM_setup(); // we will transition to ON in a couple of seconds, FIXME, only do this for cold boots, not waking from SDS
     powerFSMthread = new PowerFSMThread();
+    BootTimeline::mark("power fsm");
 
 #if !HAS_TFT
     setCPUFast(false); // 80MHz is fine for our slow peripherals
@@ -1300,6 +1325,7 @@ void setup()
     LOG_DEBUG("Free heap  : %7d bytes", ESP.getFreeHeap());
     LOG_DEBUG("Free PSRAM : %7d bytes", ESP.getFreePsram());
 #endif
+    BootTimeline::print();
 }
 
 #endif
@@ -45,6 +45,11 @@ bool FloodingRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
 
 void FloodingRouter::perhapsCancelDupe(const meshtastic_MeshPacket *p)
 {
+    if (USERPREFS_FLOOD_SUPPRESSION_MODE != FLOOD_SUPPRESSION_DEFAULT) {
+        perhapsSuppressRebroadcast(p);
+        return;
+    }
+
     if (config.device.role != meshtastic_Config_DeviceConfig_Role_ROUTER &&
         config.device.role != meshtastic_Config_DeviceConfig_Role_REPEATER &&
         config.device.role != meshtastic_Config_DeviceConfig_Role_ROUTER_LATE) {
@@ -57,6 +62,58 @@ void FloodingRouter::perhapsCancelDupe(const meshtastic_MeshPacket *p)
     }
 }
 
+uint8_t FloodingRouter::countHeardCopy(const meshtastic_MeshPacket *p)
+{
+    NodeNum sender = getFrom(p);
+    for (auto &c : dupeCounters) {
+        if (c.heard && c.sender == sender && c.id == p->id)
+            return ++c.heard;
+    }
+
+    // Not tracked yet: reuse a slot of which the packet already left the TX queue, or else the oldest one
+    uint8_t slot = nextDupeCounter;
+    for (uint8_t i = 0; i < MAX_TX_QUEUE; i++) {
+        if (!dupeCounters[i].heard || !findInTxQueue(dupeCounters[i].sender, dupeCounters[i].id)) {
+            slot = i;
+            break;
+        }
+    }
+    nextDupeCounter = (slot + 1) % MAX_TX_QUEUE;
+
+    // The first copy is the one that made us queue the rebroadcast, so this is the second one
+    dupeCounters[slot] = {.sender = sender, .id = p->id, .heard = 2};
+    return dupeCounters[slot].heard;
+}
+
+bool FloodingRouter::perhapsSuppressRebroadcast(const meshtastic_MeshPacket *p)
+{
+    NodeNum sender = getFrom(p);
+    if (!findInTxQueue(sender, p->id))
+        return false; // nothing pending to suppress
+
+    uint8_t copies;
+    if (USERPREFS_FLOOD_SUPPRESSION_MODE == FLOOD_SUPPRESSION_COVERAGE) {
+        // relayed_by was already updated with this copy by wasSeenRecently()
+        copies = getNumRelayers(p->id, sender, nodeDB->getLastByteOfNodeNum(getNodeNum()));
+    } else {
+        copies = countHeardCopy(p);
+    }
+
+    if (copies >= USERPREFS_FLOOD_SUPPRESSION_THRESHOLD) {
+        LOG_DEBUG("Suppress rebroadcast of id=0x%x, heard %d copies", p->id, copies);
+        if (Router::cancelSending(sender, p->id)) {
+            txRelayCanceled++;
+            return true;
+        }
+        return false;
+    }
+
+    // Not enough copies yet, defer our rebroadcast so we get more chance to overhear others
+    if (iface)
+        iface->clampToLateRebroadcastWindow(sender, p->id);
+    return false;
+}
+
 bool FloodingRouter::isRebroadcaster()
 {
     return config.device.role != meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE &&
@@ -2,6 +2,29 @@
 
 #include "Router.h"
 
+/**
+ * Flood suppression modes for pending rebroadcasts, selectable with USERPREFS_FLOOD_SUPPRESSION_MODE
+ *
+ *   FLOOD_SUPPRESSION_DEFAULT:  cancel our rebroadcast on the first duplicate we hear (never for router roles)
+ *   FLOOD_SUPPRESSION_COUNTER:  cancel once we have heard USERPREFS_FLOOD_SUPPRESSION_THRESHOLD copies during our TX delay
+ *   FLOOD_SUPPRESSION_COVERAGE: cancel once USERPREFS_FLOOD_SUPPRESSION_THRESHOLD distinct relayers (per PacketHistory) covered
+ *                               the packet
+ *
+ * In the counter and coverage modes every role (including routers and repeaters) takes part, and a pending rebroadcast that
+ * has not reached the threshold yet is moved to the late rebroadcast window, so we get more time to overhear other copies.
+ */
+#define FLOOD_SUPPRESSION_DEFAULT 0
+#define FLOOD_SUPPRESSION_COUNTER 1
+#define FLOOD_SUPPRESSION_COVERAGE 2
+
+#ifndef USERPREFS_FLOOD_SUPPRESSION_MODE
+#define USERPREFS_FLOOD_SUPPRESSION_MODE FLOOD_SUPPRESSION_DEFAULT
+#endif
+
+#ifndef USERPREFS_FLOOD_SUPPRESSION_THRESHOLD
+#define USERPREFS_FLOOD_SUPPRESSION_THRESHOLD 2
+#endif
+
 /**
  * This is a mixin that extends Router with the ability to do Naive Flooding (in the standard mesh protocol sense)
  *
@@ -31,6 +54,23 @@ class FloodingRouter : public Router
     /* Check if we should rebroadcast this packet, and do so if needed */
     void perhapsRebroadcast(const meshtastic_MeshPacket *p);
 
+    /// Number of copies we overheard of a packet while our own rebroadcast of it is waiting in the TX queue
+    struct DupeCounter {
+        NodeNum sender;
+        PacketId id;
+        uint8_t heard;
+    };
+
+    /// Only packets in the TX queue are tracked, so we never need more slots than it can hold
+    DupeCounter dupeCounters[MAX_TX_QUEUE] = {};
+    uint8_t nextDupeCounter = 0;
+
+    /* Count a copy of a packet we are about to rebroadcast, @return the number of copies heard including the first one */
+    uint8_t countHeardCopy(const meshtastic_MeshPacket *p);
+
+    /* Counter/coverage based suppression, @return true if our pending rebroadcast was cancelled */
+    bool perhapsSuppressRebroadcast(const meshtastic_MeshPacket *p);
+
   public:
     /**
      * Constructor
@@ -2,16 +2,20 @@
 
 #include <Arduino.h>
 #include <assert.h>
-#include <functional>
 #include <memory>
 
 #include "PointerQueue.h"
+#include "concurrency/Lock.h"
+
+#ifdef ARCH_PORTDUINO
+#include <mutex>
+#endif
 
 template <class T> class Allocator
 {
 
   public:
-    Allocator() : deleter([this](T *p) { this->release(p); }) {}
+    Allocator() : deleter(this) {}
     virtual ~Allocator() {}
 
     /// Return a queable object which has been prefilled with zeros.  Panic if no buffer is available
@@ -46,8 +50,15 @@ template <class T> class Allocator
         return p;
     }
 
+    /// std::unique_ptr Deleter, just a pointer to the allocator to release() to
+    struct Deleter {
+        Allocator<T> *allocator;
+        explicit Deleter(Allocator<T> *allocator) : allocator(allocator) {}
+        void operator()(T *p) const { allocator->release(p); }
+    };
+
     /// Variations of the above methods that return std::unique_ptr instead of raw pointers.
-    using UniqueAllocation = std::unique_ptr<T, const std::function<void(T *)> &>;
+    using UniqueAllocation = std::unique_ptr<T, Deleter>;
     /// Return a queable object which has been prefilled with zeros.
     /// std::unique_ptr wrapped variant of allocZeroed().
     UniqueAllocation allocUniqueZeroed() { return UniqueAllocation(allocZeroed(), deleter); }
@@ -65,13 +76,16 @@ template <class T> class Allocator
     /// Return a buffer for use by others
     virtual void release(T *p) = 0;
 
+    /// Number of objects currently handed out, 0 if the allocator doesn't keep track
+    virtual uint32_t getInUse() const { return 0; }
+
   protected:
     // Alloc some storage
     virtual T *alloc(TickType_t maxWait) = 0;
 
   private:
     // std::unique_ptr Deleter function; calls release().
-    const std::function<void(T *)> deleter;
+    const Deleter deleter;
 };
 
 /**
@@ -85,14 +99,218 @@ template <class T> class MemoryDynamic : public Allocator<T>
     {
         assert(p);
         free(p);
+        inUse--;
+    }
+
+    virtual uint32_t getInUse() const override { return inUse; }
+
+  protected:
+    // Alloc some storage
+    virtual T *alloc(TickType_t maxWait) override
+    {
+        T *p = (T *)malloc(sizeof(T));
+        assert(p);
+        inUse++;
+        return p;
+    }
+
+  private:
+    uint32_t inUse = 0; // Only for statistics, so not worth a lock
+};
+
+/// Slots are aligned to cache lines where that matters, so two threads never share a line
+#ifndef SLAB_ALIGN
+#ifdef ARCH_PORTDUINO
+#define SLAB_ALIGN 64
+#else
+#define SLAB_ALIGN 8
+#endif
+#endif
+
+/// Number of free slots each thread keeps for itself on portduino, to avoid taking the lock for every packet
+#ifndef SLAB_THREAD_CACHE
+#define SLAB_THREAD_CACHE 8
+#endif
+
+/**
+ * A fixed-size slab allocator: all slots are allocated once at construction and kept on a free list, so allocating and
+ * releasing is a pointer swap and the heap never fragments. If all slots are in use we fall back to malloc (and count it),
+ * so a flood degrades to MemoryDynamic rather than asserting.
+ *
+ * On portduino every thread caches a few free slots, only going to the shared (locked) free list to refill or spill half of
+ * its cache. On MCUs almost everything runs on the main task, so there is no cache and just the lock.
+ */
+template <class T> class MemorySlab : public Allocator<T>
+{
+  public:
+    explicit MemorySlab(size_t _capacity) : capacity(_capacity)
+    {
+#ifdef ARCH_PORTDUINO
+        slab = (uint8_t *)aligned_alloc(SLAB_ALIGN, capacity * slotSize);
+#else
+        slab = (uint8_t *)malloc(capacity * slotSize);
+#endif
+        assert(slab);
+        for (size_t i = capacity; i-- > 0;)
+            push((FreeSlot *)(slab + i * slotSize));
+    }
+
+    // Slabs are meant to live as long as the program, other threads must not have slots of it cached anymore
+    virtual ~MemorySlab()
+    {
+#ifdef ARCH_PORTDUINO
+        if (cache.owner == this) {
+            cache.owner = nullptr;
+            cache.count = 0;
+        }
+#endif
+        free(slab);
+    }
+
+    /// Return a buffer for use by others
+    virtual void release(T *p) override
+    {
+        assert(p);
+        if (!owns(p)) {
+            free(p); // Allocated while we were exhausted
+            return;
+        }
+#ifdef ARCH_PORTDUINO
+        ThreadCache &c = cache;
+        if (c.owner == nullptr)
+            c.owner = this;
+        if (c.owner == this) {
+            if (c.count == SLAB_THREAD_CACHE)
+                spill(c);
+            c.slots[c.count++] = (FreeSlot *)p;
+            return;
+        }
+#endif
+        lock();
+        push((FreeSlot *)p);
+        unlock();
     }
 
+    /// Slots not on the shared free list, including the ones cached by threads
+    virtual uint32_t getInUse() const override { return inUse; }
+
+    /// Most slots that were ever in use at the same time
+    uint32_t getHighWater() const { return highWater; }
+
+    /// Number of allocations that had to fall back to malloc, because all slots were in use
+    uint32_t getExhausted() const { return exhausted; }
+
+    size_t getCapacity() const { return capacity; }
+
   protected:
     // Alloc some storage
     virtual T *alloc(TickType_t maxWait) override
     {
+#ifdef ARCH_PORTDUINO
+        ThreadCache &c = cache;
+        if (c.owner == nullptr)
+            c.owner = this;
+        if (c.owner == this) {
+            if (!c.count)
+                refill(c);
+            if (c.count)
+                return (T *)c.slots[--c.count];
+        }
+#endif
+        lock();
+        FreeSlot *s = pop();
+        if (!s)
+            exhausted++;
+        unlock();
+        if (s)
+            return (T *)s;
+
         T *p = (T *)malloc(sizeof(T));
         assert(p);
         return p;
     }
+
+  private:
+    struct FreeSlot {
+        FreeSlot *next;
+    };
+
+    static constexpr size_t slotSize = (sizeof(T) + SLAB_ALIGN - 1) / SLAB_ALIGN * SLAB_ALIGN;
+
+    uint8_t *slab;
+    size_t capacity;
+    FreeSlot *freeList = nullptr;
+    uint32_t inUse = 0, highWater = 0, exhausted = 0;
+
+    bool owns(const T *p) const { return (const uint8_t *)p >= slab && (const uint8_t *)p < slab + capacity * slotSize; }
+
+    // Must hold the lock, except in the constructor
+    void push(FreeSlot *s)
+    {
+        s->next = freeList;
+        freeList = s;
+        if (inUse)
+            inUse--;
+    }
+
+    // Must hold the lock
+    FreeSlot *pop()
+    {
+        FreeSlot *s = freeList;
+        if (s) {
+            freeList = s->next;
+            if (++inUse > highWater)
+                highWater = inUse;
+        }
+        return s;
+    }
+
+#ifdef ARCH_PORTDUINO
+    std::mutex mutex;
+    void lock() { mutex.lock(); }
+    void unlock() { mutex.unlock(); }
+
+    struct ThreadCache {
+        MemorySlab<T> *owner = nullptr; // A thread only caches for the first slab of this type it uses
+        uint8_t count = 0;
+        FreeSlot *slots[SLAB_THREAD_CACHE];
+
+        // Hand the cached slots back when the thread exits
+        ~ThreadCache()
+        {
+            if (owner) {
+                owner->lock();
+                while (count)
+                    owner->push(slots[--count]);
+                owner->unlock();
+            }
+        }
+    };
+    static thread_local ThreadCache cache;
+
+    void refill(ThreadCache &c)
+    {
+        lock();
+        FreeSlot *s;
+        while (c.count < SLAB_THREAD_CACHE / 2 && (s = pop()))
+            c.slots[c.count++] = s;
+        unlock();
+    }
+
+    void spill(ThreadCache &c)
+    {
+        lock();
+        while (c.count > SLAB_THREAD_CACHE / 2)
+            push(c.slots[--c.count]);
+        unlock();
+    }
+#else
+    concurrency::Lock mutex;
+    void lock() { mutex.lock(); }
+    void unlock() { mutex.unlock(); }
+#endif
 };
+
+#ifdef ARCH_PORTDUINO
+template <class T> thread_local typename MemorySlab<T>::ThreadCache MemorySlab<T>::cache;
+#endif
@@ -24,7 +24,11 @@ MeshModule::MeshModule(const char *_name) : name(_name)
     if (!modules)
         modules = new std::vector<MeshModule *>();
 
-    modules->push_back(this);
+    // RoutingModule has to stay last, modules that are constructed after it (see deferModule()) go in front of it
+    if (routingModule && !modules->empty() && modules->back() == routingModule)
+        modules->insert(modules->end() - 1, this);
+    else
+        modules->push_back(this);
 }
 
 void MeshModule::setup() {}
@@ -103,6 +103,20 @@ meshtastic_MeshPacket *MeshPacketQueue::getFront()
     return p;
 }
 
+/** Remove and return the first (highest priority) packet for which canSend() returns true, or NULL if there is none */
+meshtastic_MeshPacket *MeshPacketQueue::dequeueFirst(const std::function<bool(const meshtastic_MeshPacket *)> &canSend)
+{
+    for (auto it = queue.begin(); it != queue.end(); it++) {
+        auto p = (*it);
+        if (canSend(p)) {
+            queue.erase(it);
+            return p;
+        }
+    }
+
+    return NULL;
+}
+
 /** Attempt to find and remove a packet from this queue.  Returns a pointer to the removed packet, or NULL if not found */
 meshtastic_MeshPacket *MeshPacketQueue::remove(NodeNum from, PacketId id, bool tx_normal, bool tx_late)
 {
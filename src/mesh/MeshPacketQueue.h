@@ -2,6 +2,7 @@
 
 #include "MeshTypes.h"
 
+#include <functional>
 #include <queue>
 
 /**
@@ -35,6 +36,9 @@ class MeshPacketQueue
 
     meshtastic_MeshPacket *getFront();
 
+    /** Remove and return the first (highest priority) packet for which canSend() returns true, or NULL if there is none */
+    meshtastic_MeshPacket *dequeueFirst(const std::function<bool(const meshtastic_MeshPacket *)> &canSend);
+
     /** Attempt to find and remove a packet from this queue.  Returns the packet which was removed from the queue */
     meshtastic_MeshPacket *remove(NodeNum from, PacketId id, bool tx_normal = true, bool tx_late = true);
 
@@ -16,6 +16,9 @@
 #include "meshUtils.h"
 #include "modules/NodeInfoModule.h"
 #include "modules/PositionModule.h"
+#if HAS_TELEMETRY
+#include "modules/Telemetry/TelemetryBatch.h"
+#endif
 #include "power.h"
 #include <assert.h>
 #include <string>
@@ -45,11 +48,20 @@ the new node can build its node db)
 
 MeshService *service;
 
+#ifdef ARCH_PORTDUINO
+// Each of these waits in a queue of MAX_RX_TOPHONE for the phone, floods beyond it fall back to malloc
+static MemorySlab<meshtastic_MqttClientProxyMessage> staticMqttClientProxyMessagePool(MAX_RX_TOPHONE);
+
+static MemorySlab<meshtastic_QueueStatus> staticQueueStatusPool(MAX_RX_TOPHONE);
+
+static MemorySlab<meshtastic_ClientNotification> staticClientNotificationPool(MAX_RX_TOPHONE);
+#else
 static MemoryDynamic<meshtastic_MqttClientProxyMessage> staticMqttClientProxyMessagePool;
 
 static MemoryDynamic<meshtastic_QueueStatus> staticQueueStatusPool;
 
 static MemoryDynamic<meshtastic_ClientNotification> staticClientNotificationPool;
+#endif
 
 Allocator<meshtastic_MqttClientProxyMessage> &mqttClientProxyMessagePool = staticMqttClientProxyMessagePool;
 
@@ -103,6 +115,12 @@ int MeshService::handleFromRadio(const meshtastic_MeshPacket *mp)
         }
     }
 
+#if HAS_TELEMETRY
+    // The phone can't read the batch itself, it gets the windows that Router::handleReceived expands instead
+    if (TelemetryBatch::isBatch(*mp))
+        return 0;
+#endif
+
     printPacket("Forwarding to phone", mp);
     sendToPhone(packetPool.allocCopy(*mp));
 
@@ -285,7 +303,7 @@ void MeshService::sendToPhone(meshtastic_MeshPacket *p)
 
 #ifdef ARCH_ESP32
 #if !MESHTASTIC_EXCLUDE_STOREFORWARD
-    if (moduleConfig.store_forward.enabled && storeForwardModule->isServer() &&
+    if (moduleConfig.store_forward.enabled && storeForwardModule && storeForwardModule->isServer() &&
         p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_APP) {
         releaseToPool(p); // Copy is already stored in StoreForward history
         fromNum++;        // Notify observers for packet from radio
@@ -309,6 +327,7 @@ void MeshService::sendToPhone(meshtastic_MeshPacket *p)
         }
     }
 
+    LATENCY_BEGIN(TO_PHONE_QUEUE, p); // Before enqueueing, the phone might fetch it right away
     if (toPhoneQueue.enqueue(p, 0) == false) {
         LOG_CRIT("Failed to queue a packet into toPhoneQueue!");
         abort();
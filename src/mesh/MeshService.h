@@ -8,6 +8,7 @@
 #include "MemoryPool.h"
 #include "MeshRadio.h"
 #include "MeshTypes.h"
+#include "PacketLatency.h"
 #include "Observer.h"
 #include "PointerQueue.h"
 #if defined(ARCH_PORTDUINO)
@@ -82,7 +83,12 @@ class MeshService
 
     /// Return the next packet destined to the phone.  FIXME, somehow use fromNum to allow the phone to retry the
     /// last few packets if needs to.
-    meshtastic_MeshPacket *getForPhone() { return toPhoneQueue.dequeuePtr(0); }
+    meshtastic_MeshPacket *getForPhone()
+    {
+        meshtastic_MeshPacket *p = toPhoneQueue.dequeuePtr(0);
+        LATENCY_END(TO_PHONE_QUEUE, p);
+        return p;
+    }
 
     /// Allows the bluetooth handler to free packets after they have been sent
     void releaseToPool(meshtastic_MeshPacket *p) { packetPool.release(p); }
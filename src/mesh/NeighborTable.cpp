@@ -0,0 +1,116 @@
+#include "NeighborTable.h"
+
+void NeighborTable::clear()
+{
+    for (uint16_t b = 0; b < NUM_BUCKETS; b++)
+        buckets[b] = NONE;
+    for (int16_t i = 0; i < NEIGHBOR_TABLE_SIZE; i++)
+        slots[i].next = i + 1 < NEIGHBOR_TABLE_SIZE ? i + 1 : NONE;
+    freeSlots = 0;
+    head = tail = NONE;
+    count = 0;
+}
+
+int16_t NeighborTable::lookup(NodeNum node) const
+{
+    for (int16_t i = buckets[bucketOf(node)]; i != NONE; i = slots[i].nextInBucket)
+        if (slots[i].neighbor.node == node)
+            return i;
+    return NONE;
+}
+
+void NeighborTable::unlink(int16_t i)
+{
+    Slot &s = slots[i];
+    if (s.prev != NONE)
+        slots[s.prev].next = s.next;
+    else
+        head = s.next;
+    if (s.next != NONE)
+        slots[s.next].prev = s.prev;
+    else
+        tail = s.prev;
+}
+
+void NeighborTable::insertByExpiry(int16_t i)
+{
+    uint32_t expiry = slots[i].neighbor.expiry();
+    int16_t after = tail;
+    while (after != NONE && (int32_t)(slots[after].neighbor.expiry() - expiry) > 0)
+        after = slots[after].prev;
+
+    slots[i].prev = after;
+    slots[i].next = after != NONE ? slots[after].next : head;
+    if (slots[i].next != NONE)
+        slots[slots[i].next].prev = i;
+    else
+        tail = i;
+    if (after != NONE)
+        slots[after].next = i;
+    else
+        head = i;
+}
+
+void NeighborTable::remove(int16_t i)
+{
+    unlink(i);
+
+    int16_t *link = &buckets[bucketOf(slots[i].neighbor.node)];
+    while (*link != i)
+        link = &slots[*link].nextInBucket;
+    *link = slots[i].nextInBucket;
+
+    slots[i].next = freeSlots;
+    freeSlots = i;
+    count--;
+}
+
+NeighborTable::Neighbor *NeighborTable::update(NodeNum node, float snr, uint32_t now, uint32_t intervalSecs,
+                                               uint32_t defaultIntervalSecs)
+{
+    int16_t i = lookup(node);
+    if (i != NONE) {
+        Neighbor &n = slots[i].neighbor;
+        n.snr += (snr - n.snr) / NEIGHBOR_SNR_SMOOTHING;
+        n.lastRxTime = now;
+        if (intervalSecs)
+            n.broadcastIntervalSecs = intervalSecs;
+        unlink(i);
+        insertByExpiry(i);
+        return &n;
+    }
+
+    if (freeSlots == NONE) {
+        LOG_WARN("Neighbor table is full, replace the one closest to expiry, 0x%x", slots[head].neighbor.node);
+        remove(head);
+    }
+    i = freeSlots;
+    freeSlots = slots[i].next;
+    count++;
+
+    slots[i].neighbor = {node, now, intervalSecs ? intervalSecs : defaultIntervalSecs, snr};
+    uint16_t b = bucketOf(node);
+    slots[i].nextInBucket = buckets[b];
+    buckets[b] = i;
+    insertByExpiry(i);
+    return &slots[i].neighbor;
+}
+
+const NeighborTable::Neighbor *NeighborTable::find(NodeNum node, uint32_t now) const
+{
+    int16_t i = lookup(node);
+    if (i == NONE || (int32_t)(now - slots[i].neighbor.expiry()) > 0)
+        return nullptr;
+    return &slots[i].neighbor;
+}
+
+void NeighborTable::removeExpired(uint32_t now, NodeNum keep)
+{
+    for (int16_t i = head, next; i != NONE && (int32_t)(now - slots[i].neighbor.expiry()) > 0; i = next) {
+        next = slots[i].next;
+        if (slots[i].neighbor.node != keep) {
+            LOG_DEBUG("Remove neighbor with node ID 0x%x", slots[i].neighbor.node);
+            remove(i);
+        }
+    }
+}
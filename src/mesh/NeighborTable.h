@@ -0,0 +1,90 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "configuration.h"
+
+/// Direct neighbors we keep track of, routers in busy meshes can hear well over a hundred
+#ifndef NEIGHBOR_TABLE_SIZE
+#if defined(ARCH_ESP32) || defined(ARCH_PORTDUINO)
+#define NEIGHBOR_TABLE_SIZE 128
+#else
+#define NEIGHBOR_TABLE_SIZE 32
+#endif
+#endif
+
+/// Weight of a new SNR sample is 1/NEIGHBOR_SNR_SMOOTHING, 1 keeps only the last one
+#ifndef NEIGHBOR_SNR_SMOOTHING
+#define NEIGHBOR_SNR_SMOOTHING 4
+#endif
+
+/**
+ * Fixed size table of the nodes we hear directly, with the smoothed SNR of each.
+ *
+ * Lookups go through a hash of the node number, so updating a neighbor for every received packet doesn't walk the table.
+ * The neighbors are also kept in a list ordered by when they expire (twice their broadcast interval after we last heard
+ * them), which makes removing the expired ones and picking one to replace when the table is full cheap too.
+ */
+class NeighborTable
+{
+  public:
+    struct Neighbor {
+        NodeNum node;
+        uint32_t lastRxTime;            // Seconds since 1970
+        uint32_t broadcastIntervalSecs; // How often the neighbor sends NeighborInfo
+        float snr;                      // Moving average
+
+        uint32_t expiry() const { return lastRxTime + broadcastIntervalSecs * 2; }
+    };
+
+    NeighborTable() { clear(); }
+
+    void clear();
+
+    /**
+     * Record that we heard 'node' directly at 'now' (seconds since 1970).
+     * @param intervalSecs broadcast interval of the neighbor, 0 if unknown to keep the one we have
+     * @param defaultIntervalSecs what to assume for a new neighbor if intervalSecs is 0
+     */
+    Neighbor *update(NodeNum node, float snr, uint32_t now, uint32_t intervalSecs, uint32_t defaultIntervalSecs);
+
+    /// A neighbor that hasn't expired at 'now', or nullptr
+    const Neighbor *find(NodeNum node, uint32_t now) const;
+
+    /// Forget the neighbors that expired before 'now', except 'keep'
+    void removeExpired(uint32_t now, NodeNum keep);
+
+    uint16_t size() const { return count; }
+
+    /// Call f(const Neighbor &) for each neighbor, the one that expires last first
+    template <typename F> void forEach(F f) const
+    {
+        for (int16_t i = tail; i != NONE; i = slots[i].prev)
+            f(slots[i].neighbor);
+    }
+
+  private:
+    static const int16_t NONE = -1;
+    static const uint16_t NUM_BUCKETS = NEIGHBOR_TABLE_SIZE; // Keep a power of two
+
+    struct Slot {
+        Neighbor neighbor;
+        int16_t prev, next; // Expiry list, 'next' also chains the free slots
+        int16_t nextInBucket;
+    };
+
+    Slot slots[NEIGHBOR_TABLE_SIZE];
+    int16_t buckets[NUM_BUCKETS];
+    int16_t head, tail; // Expires first, expires last
+    int16_t freeSlots;
+    uint16_t count;
+
+    static uint16_t bucketOf(NodeNum node) { return ((node ^ (node >> 16)) * 0x45d9f3bUL) & (NUM_BUCKETS - 1); }
+
+    int16_t lookup(NodeNum node) const;
+    void remove(int16_t i);
+    void unlink(int16_t i);
+    /// Put a slot into the expiry list by its expiry time, usually that is right at the tail
+    void insertByExpiry(int16_t i);
+};
+
+static_assert((NEIGHBOR_TABLE_SIZE & (NEIGHBOR_TABLE_SIZE - 1)) == 0, "NEIGHBOR_TABLE_SIZE must be a power of two");
@@ -1,4 +1,6 @@
 #include "NextHopRouter.h"
+#include "RTC.h"
+#include "modules/NeighborInfoModule.h"
 
 NextHopRouter::NextHopRouter() {}
 
@@ -17,7 +19,7 @@ ErrorCode NextHopRouter::send(meshtastic_MeshPacket *p)
     p->relay_node = nodeDB->getLastByteOfNodeNum(getNodeNum()); // First set the relayer to us
     wasSeenRecently(p);                                         // FIXME, move this to a sniffSent method
 
-    p->next_hop = getNextHop(p->to, p->relay_node); // set the next hop
+    p->next_hop = getNextHop(p->to, p->relay_node, p->want_ack); // set the next hop
     LOG_DEBUG("Setting next hop for packet with dest %x to %x", p->to, p->next_hop);
 
     // If it's from us, ReliableRouter already handles retransmissions if want_ack is set. If a next hop is set and hop limit is
@@ -121,7 +123,7 @@ bool NextHopRouter::perhapsRelay(const meshtastic_MeshPacket *p)
  * Get the next hop for a destination, given the relay node
  * @return the node number of the next hop, 0 if no preference (fallback to FloodingRouter)
  */
-uint8_t NextHopRouter::getNextHop(NodeNum to, uint8_t relay_node)
+uint8_t NextHopRouter::getNextHop(NodeNum to, uint8_t relay_node, bool wantAck)
 {
     // When we're a repeater router->sniffReceived will call NextHopRouter directly without checking for broadcast
     if (isBroadcast(to))
@@ -136,6 +138,20 @@ uint8_t NextHopRouter::getNextHop(NodeNum to, uint8_t relay_node)
         } else
             LOG_WARN("Next hop for 0x%x is 0x%x, same as relayer; set no pref", to, node->next_hop);
     }
+
+    // Nothing learned yet, but if we hear the destination directly and well there is no need for anybody to relay. If it
+    // doesn't get through, the last retransmission floods and we don't try this for the destination again. Without want_ack
+    // nothing would stop the retransmissions, so those are flooded right away.
+    if (wantAck && neighborInfoModule) {
+        for (NodeNum failed : directHopFailed) {
+            if (failed == to)
+                return NO_NEXT_HOP_PREFERENCE;
+        }
+        const NeighborTable::Neighbor *neighbor = neighborInfoModule->getNeighbors().find(to, getTime());
+        uint8_t toByte = nodeDB->getLastByteOfNodeNum(to);
+        if (neighbor && neighbor->snr >= NEIGHBOR_DIRECT_MIN_SNR && toByte != relay_node)
+            return toByte;
+    }
     return NO_NEXT_HOP_PREFERENCE;
 }
 
@@ -227,6 +243,11 @@ int32_t NextHopRouter::doRetransmissions()
                 if (!isBroadcast(p.packet->to)) {
                     if (p.numRetransmissions == 1) {
                         // Last retransmission, reset next_hop (fallback to FloodingRouter)
+                        if (p.packet->next_hop == nodeDB->getLastByteOfNodeNum(p.packet->to)) {
+                            // We sent straight to the destination, don't count on hearing it meaning it hears us
+                            directHopFailed[directHopFailedNext] = p.packet->to;
+                            directHopFailedNext = (directHopFailedNext + 1) % NEIGHBOR_DIRECT_MAX_FAILED;
+                        }
                         p.packet->next_hop = NO_NEXT_HOP_PREFERENCE;
                         // Also reset it in the nodeDB
                         meshtastic_NodeInfoLite *sentTo = nodeDB->getMeshNode(p.packet->to);
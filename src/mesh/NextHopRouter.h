@@ -3,6 +3,16 @@
 #include "FloodingRouter.h"
 #include <unordered_map>
 
+/// Smoothed SNR (dB) at which we send straight to a destination we hear directly, rather than let the mesh relay it
+#ifndef NEIGHBOR_DIRECT_MIN_SNR
+#define NEIGHBOR_DIRECT_MIN_SNR -5.0f
+#endif
+
+/// Number of destinations we remember not to send straight to after doing so ended in a fallback to flooding
+#ifndef NEIGHBOR_DIRECT_MAX_FAILED
+#define NEIGHBOR_DIRECT_MAX_FAILED 8
+#endif
+
 /**
  * An identifier for a globally unique message - a pair of the sending nodenum and the packet id assigned
  * to that message
@@ -139,11 +149,19 @@ class NextHopRouter : public FloodingRouter
     void setNextTx(PendingPacket *pending);
 
   private:
+    /**
+     * Destinations we heard directly, but which didn't get a packet we sent straight to them (e.g. over an asymmetric link),
+     * the oldest is replaced first
+     */
+    NodeNum directHopFailed[NEIGHBOR_DIRECT_MAX_FAILED] = {};
+    uint8_t directHopFailedNext = 0;
+
     /**
      * Get the next hop for a destination, given the relay node
+     * @param wantAck only then a direct neighbor can be used as next hop, as the ACK stops our retransmissions
      * @return the node number of the next hop, 0 if no preference (fallback to FloodingRouter)
      */
-    uint8_t getNextHop(NodeNum to, uint8_t relay_node);
+    uint8_t getNextHop(NodeNum to, uint8_t relay_node, bool wantAck);
 
     /** Check if we should be relaying this packet if so, do so.
      *  @return true if we did relay */
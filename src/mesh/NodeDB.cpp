@@ -438,6 +438,9 @@ bool NodeDB::factoryReset(bool eraseBleBonds)
     if (FSCom.exists("/static/rangetest.csv") && !FSCom.remove("/static/rangetest.csv")) {
         LOG_ERROR("Could not remove rangetest.csv file");
     }
+    if (FSCom.exists("/static/rangetest.bin") && !FSCom.remove("/static/rangetest.bin")) {
+        LOG_ERROR("Could not remove rangetest.bin file");
+    }
 #endif
     spiLock->unlock();
     // second, install default state (this will deal with the duplicate mac address issue)
@@ -0,0 +1,216 @@
+#include "PacketAggregator.h"
+#include "MeshService.h"
+#include "NodeDB.h"
+#include "Router.h"
+#include "Throttle.h"
+#include "main.h"
+#include "mesh-pb-constants.h"
+#include "sleep.h"
+
+PacketAggregator *packetAggregator;
+
+PacketAggregator::PacketAggregator() : concurrency::OSThread("PacketAggregator")
+{
+    preflightSleepObserver.observe(&preflightSleep);
+    notifyRebootObserver.observe(&notifyReboot);
+}
+
+size_t PacketAggregator::recordSize(const meshtastic_MeshPacket *p)
+{
+    return AGGREGATE_RECORD_HEADER + (p->decoded.request_id ? sizeof(uint32_t) : 0) + p->decoded.payload.size;
+}
+
+bool PacketAggregator::canAggregate(const meshtastic_MeshPacket *p)
+{
+    if (p->which_payload_variant != meshtastic_MeshPacket_decoded_tag || !isFromUs(p) || p->to == NODENUM_BROADCAST_NO_LORA)
+        return false;
+    if (p->want_ack || p->decoded.want_response || p->pki_encrypted || p->decoded.reply_id || p->decoded.emoji)
+        return false; // needs its own packet id to be ACKed or replied to
+    if (p->decoded.portnum == AGGREGATE_PORTNUM)
+        return false;
+    return recordSize(p) <= meshtastic_Constants_DATA_PAYLOAD_LEN / 2;
+}
+
+PacketAggregator::Bucket *PacketAggregator::findBucket(const meshtastic_MeshPacket *p)
+{
+    for (auto &b : buckets) {
+        if (b.count && b.to == p->to && b.channel == p->channel && b.hop_limit == p->hop_limit)
+            return &b;
+    }
+    return NULL;
+}
+
+bool PacketAggregator::hold(meshtastic_MeshPacket *p)
+{
+    if (!canAggregate(p))
+        return false;
+    if (rebootAtMsec) {
+        flushAll(); // Don't hold anything back from the few seconds we have left
+        return false;
+    }
+
+    // Phone apps leave the priority of text and admin messages unset, Router::send would only raise it after we held them
+    fixPriority(p);
+
+    Bucket *b = findBucket(p);
+    bool isAck = p->decoded.portnum == meshtastic_PortNum_ROUTING_APP;
+    if (isAck && !b)
+        return false; // ACKs never wait for company
+    if (!isAck && p->priority >= meshtastic_MeshPacket_Priority_RELIABLE)
+        return false;
+
+    if (b && (b->count == AGGREGATE_MAX_PACKETS || b->size + recordSize(p) > meshtastic_Constants_DATA_PAYLOAD_LEN)) {
+        flush(*b);
+        b = NULL;
+        if (isAck)
+            return false;
+    }
+
+    if (!b) {
+        for (auto &free : buckets) {
+            if (!free.count) {
+                b = &free;
+                break;
+            }
+        }
+        if (!b)
+            return false; // all buckets in use, just send it
+        b->to = p->to;
+        b->channel = p->channel;
+        b->hop_limit = p->hop_limit;
+        b->firstHeldMsec = millis();
+        b->size = 0;
+
+        bool otherPending = false;
+        for (auto &other : buckets) {
+            if (other.count)
+                otherPending = true;
+        }
+        if (!otherPending) // otherwise we are already scheduled to run earlier
+            setIntervalFromNow(USERPREFS_PACKET_AGGREGATION_HOLD_MSEC);
+    }
+
+    LOG_DEBUG("Hold packet id=0x%x portnum=%d for aggregation to 0x%x", p->id, p->decoded.portnum, p->to);
+    b->packets[b->count++] = p;
+    b->size += recordSize(p);
+
+    if (isAck)
+        flush(*b);
+    return true;
+}
+
+void PacketAggregator::flush(Bucket &b)
+{
+    if (b.count == 1) {
+        router->send(b.packets[0]);
+    } else if (b.count > 1) {
+        meshtastic_MeshPacket *c = router->allocForSending();
+        c->to = b.to;
+        c->channel = b.channel;
+        c->hop_limit = b.hop_limit;
+        c->decoded.portnum = AGGREGATE_PORTNUM;
+        c->priority = meshtastic_MeshPacket_Priority_BACKGROUND;
+
+        uint8_t *out = c->decoded.payload.bytes;
+        for (uint8_t i = 0; i < b.count; i++) {
+            const meshtastic_Data &d = b.packets[i]->decoded;
+            *out++ = d.portnum & 0xff;
+            *out++ = (d.portnum >> 8) & 0xff;
+            *out++ = d.request_id ? AGGREGATE_FLAG_REQUEST_ID : 0;
+            *out++ = d.payload.size;
+            if (d.request_id) {
+                for (uint8_t j = 0; j < sizeof(uint32_t); j++)
+                    *out++ = (d.request_id >> (8 * j)) & 0xff;
+            }
+            memcpy(out, d.payload.bytes, d.payload.size);
+            out += d.payload.size;
+            c->priority = max(c->priority, b.packets[i]->priority);
+            packetPool.release(b.packets[i]);
+        }
+        c->decoded.payload.size = out - c->decoded.payload.bytes;
+
+        LOG_INFO("Send %d packets aggregated in id=0x%x (%d bytes)", b.count, c->id, c->decoded.payload.size);
+        router->send(c);
+    }
+    b.count = 0;
+}
+
+bool PacketAggregator::flushAll()
+{
+    bool held = false;
+    for (auto &b : buckets) {
+        if (b.count) {
+            held = true;
+            flush(b);
+        }
+    }
+    return held;
+}
+
+int32_t PacketAggregator::runOnce()
+{
+    int32_t nextRun = INT32_MAX;
+    for (auto &b : buckets) {
+        if (!b.count)
+            continue;
+        if (!Throttle::isWithinTimespanMs(b.firstHeldMsec, USERPREFS_PACKET_AGGREGATION_HOLD_MSEC)) {
+            flush(b);
+        } else {
+            int32_t remaining = USERPREFS_PACKET_AGGREGATION_HOLD_MSEC - (millis() - b.firstHeldMsec);
+            nextRun = min(nextRun, remaining);
+        }
+    }
+    return nextRun;
+}
+
+bool PacketAggregator::isContainer(const meshtastic_MeshPacket *p)
+{
+    return p->which_payload_variant == meshtastic_MeshPacket_decoded_tag && p->decoded.portnum == AGGREGATE_PORTNUM;
+}
+
+uint8_t PacketAggregator::unpack(const meshtastic_MeshPacket *container,
+                                 void (*deliver)(meshtastic_MeshPacket *p, RxSource src), RxSource src)
+{
+    const uint8_t *in = container->decoded.payload.bytes;
+    const uint8_t *end = in + container->decoded.payload.size;
+    uint8_t delivered = 0;
+
+    while (in + AGGREGATE_RECORD_HEADER <= end) {
+        uint16_t portnum = in[0] | (in[1] << 8);
+        uint8_t flags = in[2];
+        uint8_t len = in[3];
+        in += AGGREGATE_RECORD_HEADER;
+
+        uint32_t requestId = 0;
+        if (flags & AGGREGATE_FLAG_REQUEST_ID) {
+            if (in + sizeof(uint32_t) > end)
+                break;
+            for (uint8_t j = 0; j < sizeof(uint32_t); j++)
+                requestId |= (uint32_t)in[j] << (8 * j);
+            in += sizeof(uint32_t);
+        }
+        if (in + len > end || portnum == AGGREGATE_PORTNUM) {
+            LOG_WARN("Malformed aggregate container id=0x%x", container->id);
+            break;
+        }
+
+        meshtastic_MeshPacket *p = packetPool.allocCopy(*container);
+        memset(&p->decoded, 0, sizeof(p->decoded));
+        p->decoded.portnum = (meshtastic_PortNum)portnum;
+        p->decoded.request_id = requestId;
+        // Records never want a response, so the sender's bitfield (ok to MQTT) is the one they would have had on their own
+        p->decoded.has_bitfield = container->decoded.has_bitfield;
+        p->decoded.bitfield = container->decoded.bitfield;
+        p->decoded.payload.size = len;
+        memcpy(p->decoded.payload.bytes, in, len);
+        in += len;
+
+        // Keep hops away intact, but make sure nobody relays the record on its own
+        p->hop_start = p->hop_start > p->hop_limit ? p->hop_start - p->hop_limit : 0;
+        p->hop_limit = 0;
+
+        deliver(p, src);
+        delivered++;
+    }
+    return delivered;
+}
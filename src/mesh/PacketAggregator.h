@@ -0,0 +1,104 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "Observer.h"
+#include "concurrency/OSThread.h"
+#include "configuration.h"
+
+#ifndef USERPREFS_PACKET_AGGREGATION
+#define USERPREFS_PACKET_AGGREGATION 0
+#endif
+
+/// How long we hold low priority packets, waiting for others to share a frame with
+#ifndef USERPREFS_PACKET_AGGREGATION_HOLD_MSEC
+#define USERPREFS_PACKET_AGGREGATION_HOLD_MSEC 3000
+#endif
+
+/// Unassigned portnum at the top of the core range (0-63) for container payloads, until an official one is assigned.
+/// Not from the private range (256-511), where it could collide with what users run on their own meshes.
+#define AGGREGATE_PORTNUM ((meshtastic_PortNum)63)
+
+#define AGGREGATE_MAX_BUCKETS 4     // Number of distinct (destination, channel) pairs we hold packets for at once
+#define AGGREGATE_MAX_PACKETS 6     // Max number of packets we merge into one container
+#define AGGREGATE_RECORD_HEADER 4   // portnum (2 bytes LE), flags, payload length
+#define AGGREGATE_FLAG_REQUEST_ID 1 // record is followed by a 4 byte LE request_id before the payload
+
+/**
+ * Opt-in aggregation stage for small packets we originate, sitting between Router::sendLocal and the TX queue.
+ *
+ * Every LoRa frame pays the full preamble and header airtime, which dominates for small telemetry, position and routing
+ * packets at the slow presets. Low priority packets to the same destination and channel are held briefly and then sent as
+ * one container packet on AGGREGATE_PORTNUM, of which the payload is a sequence of records:
+ *
+ *   [portnum lo][portnum hi][flags][length]([request_id, if AGGREGATE_FLAG_REQUEST_ID])[payload]
+ *
+ * Relays forward containers like any other packet. Receivers unpack them in Router::handleReceived and hand every record to
+ * the modules as if it arrived on its own, nodes without support just ignore the unknown portnum.
+ * Routing ACKs never wait, but are piggybacked on a pending container for the same destination, which is then sent at once.
+ * Everything held is flushed when we are about to sleep or reboot.
+ */
+class PacketAggregator : private concurrency::OSThread
+{
+  public:
+    PacketAggregator();
+
+    /**
+     * Take a packet from us to be sent as part of a container later.
+     * @return false if the packet can't be aggregated and should be sent as usual
+     */
+    bool hold(meshtastic_MeshPacket *p);
+
+    /// @return true if this decoded packet is an aggregate container
+    static bool isContainer(const meshtastic_MeshPacket *p);
+
+    /**
+     * Unpack a decoded container into freshly allocated packets and pass each of them to deliver(), which must release them.
+     * The unpacked packets have their hop_limit zeroed (keeping hops away), so only the container itself is ever relayed.
+     * @return number of records delivered
+     */
+    static uint8_t unpack(const meshtastic_MeshPacket *container, void (*deliver)(meshtastic_MeshPacket *p, RxSource src),
+                          RxSource src);
+
+  protected:
+    virtual int32_t runOnce() override;
+
+  private:
+    struct Bucket {
+        NodeNum to;
+        ChannelIndex channel;
+        uint8_t hop_limit;
+        uint32_t firstHeldMsec;
+        size_t size; // Encoded container payload size so far
+        uint8_t count;
+        meshtastic_MeshPacket *packets[AGGREGATE_MAX_PACKETS];
+    };
+
+    Bucket buckets[AGGREGATE_MAX_BUCKETS] = {};
+
+    bool canAggregate(const meshtastic_MeshPacket *p);
+
+    /// Size of the record for this packet in a container
+    static size_t recordSize(const meshtastic_MeshPacket *p);
+
+    Bucket *findBucket(const meshtastic_MeshPacket *p);
+
+    /// Send whatever the bucket holds, as a container if there is more than one packet
+    void flush(Bucket &b);
+
+    /// Flush all buckets, @return true if anything was held
+    bool flushAll();
+
+    /// Returning non-zero holds off sleep, so the radio gets to send what we just flushed
+    int preflightSleepCb(void *unused = NULL) { return flushAll() ? 1 : 0; }
+    int onReboot(void *unused = NULL)
+    {
+        flushAll();
+        return 0;
+    }
+    CallbackObserver<PacketAggregator, void *> preflightSleepObserver =
+        CallbackObserver<PacketAggregator, void *>(this, &PacketAggregator::preflightSleepCb);
+    CallbackObserver<PacketAggregator, void *> notifyRebootObserver =
+        CallbackObserver<PacketAggregator, void *>(this, &PacketAggregator::onReboot);
+};
+
+extern PacketAggregator *packetAggregator;
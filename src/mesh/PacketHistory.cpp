@@ -1,4 +1,5 @@
 #include "PacketHistory.h"
+#include "PacketProfiler.h"
 #include "configuration.h"
 #include "mesh-pb-constants.h"
 
@@ -18,6 +19,7 @@ PacketHistory::PacketHistory()
  */
 bool PacketHistory::wasSeenRecently(const meshtastic_MeshPacket *p, bool withUpdate, bool *wasFallback, bool *weWereNextHop)
 {
+    PROFILE_STAGE(HISTORY);
     if (p->id == 0) {
         LOG_DEBUG("Ignore message with zero id");
         return false; // Not a floodable message ID, so we don't care
@@ -131,6 +133,33 @@ bool PacketHistory::wasRelayer(const uint8_t relayer, std::unordered_set<PacketR
     return false;
 }
 
+/* Count the distinct relayers of a packet in the history given an ID and sender, not counting excludeRelayer
+ * @return number of distinct relayers, at most NUM_RELAYERS */
+uint8_t PacketHistory::getNumRelayers(const uint32_t id, const NodeNum sender, const uint8_t excludeRelayer)
+{
+    PacketRecord r = {.sender = sender, .id = id, .rxTimeMsec = 0, .next_hop = 0};
+    auto found = recentPackets.find(r);
+
+    if (found == recentPackets.end()) {
+        return 0;
+    }
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < NUM_RELAYERS; i++) {
+        uint8_t relayer = found->relayed_by[i];
+        if (relayer == 0 || relayer == excludeRelayer)
+            continue;
+        bool duplicate = false;
+        for (uint8_t j = 0; j < i; j++) {
+            if (found->relayed_by[j] == relayer)
+                duplicate = true;
+        }
+        if (!duplicate)
+            count++;
+    }
+    return count;
+}
+
 // Remove a relayer from the list of relayers of a packet in the history given an ID and sender
 void PacketHistory::removeRelayer(const uint8_t relayer, const uint32_t id, const NodeNum sender)
 {
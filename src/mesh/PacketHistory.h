@@ -63,6 +63,10 @@ class PacketHistory
      * @return true if node was indeed a relayer, false if not */
     bool wasRelayer(const uint8_t relayer, std::unordered_set<PacketRecord, PacketRecordHashFunction>::iterator r);
 
+    /* Count the distinct relayers of a packet in the history given an ID and sender, not counting excludeRelayer
+     * @return number of distinct relayers, at most NUM_RELAYERS */
+    uint8_t getNumRelayers(const uint32_t id, const NodeNum sender, const uint8_t excludeRelayer = 0);
+
     // Remove a relayer from the list of relayers of a packet in the history given an ID and sender
     void removeRelayer(const uint8_t relayer, const uint32_t id, const NodeNum sender);
 };
\ No newline at end of file
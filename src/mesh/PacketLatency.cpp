@@ -0,0 +1,148 @@
+#include "PacketLatency.h"
+
+#if MESHTASTIC_PACKET_LATENCY
+#include "RadioInterface.h"
+#include "concurrency/LockGuard.h"
+#include "mesh-pb-constants.h"
+#include <cstring>
+#ifdef ARCH_PORTDUINO
+#include <mutex>
+#endif
+
+struct Stamp {
+    NodeNum from;
+    PacketId id;
+    LatencyStage stage;
+    uint32_t usec;
+};
+
+// One for each packet that can be waiting in the TX, fromRadio and toPhone queues, so none is overwritten while still queued
+static constexpr uint16_t numStamps = MAX_TX_QUEUE + MAX_RX_FROMRADIO + MAX_RX_TOPHONE;
+static Stamp stamps[numStamps];
+static uint16_t nextStamp;
+
+volatile uint32_t PacketLatency::isrMicros;
+LatencyHistogram PacketLatency::histograms[(int)LatencyStage::COUNT];
+
+// The phone queue is drained from the BLE task on some platforms. On portduino concurrency::Lock does nothing, but the web
+// server reads the histograms from a real thread of its own
+#ifdef ARCH_PORTDUINO
+static std::mutex latencyLock;
+struct LatencyGuard {
+    std::lock_guard<std::mutex> guard{latencyLock};
+};
+#else
+static concurrency::Lock latencyLock;
+struct LatencyGuard {
+    concurrency::LockGuard guard{&latencyLock};
+};
+#endif
+
+static const char *stageNames[] = {"isr_to_thread", "from_radio_queue", "decode", "modules", "to_phone_queue", "tx_queue"};
+
+uint16_t LatencyHistogram::bucketFor(uint32_t usec)
+{
+    if (usec < LATENCY_SUB_BUCKETS)
+        return usec;
+    if (usec > LATENCY_MAX_USEC)
+        usec = LATENCY_MAX_USEC;
+    // Octave is the position of the highest bit, the sub bucket the bits right below it
+    uint8_t octave = 31 - __builtin_clz(usec);
+    uint8_t sub = (usec >> (octave - 2)) & (LATENCY_SUB_BUCKETS - 1);
+    return (octave - 1) * LATENCY_SUB_BUCKETS + sub;
+}
+
+uint32_t LatencyHistogram::bucketUpperBound(uint16_t bucket)
+{
+    if (bucket < LATENCY_SUB_BUCKETS)
+        return bucket;
+    uint8_t octave = bucket / LATENCY_SUB_BUCKETS + 1;
+    uint8_t sub = bucket % LATENCY_SUB_BUCKETS;
+    return ((LATENCY_SUB_BUCKETS + sub + 1) << (octave - 2)) - 1;
+}
+
+void LatencyHistogram::record(uint32_t usec)
+{
+    uint16_t &b = buckets[bucketFor(usec)];
+    if (b < UINT16_MAX)
+        b++;
+    count++;
+    if (usec > maxUsec)
+        maxUsec = usec;
+}
+
+uint32_t LatencyHistogram::percentile(float p) const
+{
+    uint32_t total = 0;
+    for (auto b : buckets)
+        total += b;
+    uint32_t wanted = total * p / 100;
+    uint32_t seen = 0;
+    for (uint16_t i = 0; i < sizeof(buckets) / sizeof(buckets[0]); i++) {
+        seen += buckets[i];
+        if (seen > wanted)
+            return min(bucketUpperBound(i), maxUsec);
+    }
+    return maxUsec;
+}
+
+void LatencyHistogram::reset()
+{
+    memset(buckets, 0, sizeof(buckets));
+    count = maxUsec = 0;
+}
+
+void PacketLatency::begin(LatencyStage stage, const meshtastic_MeshPacket *p)
+{
+    LatencyGuard g;
+    Stamp &s = stamps[nextStamp];
+    nextStamp = (nextStamp + 1) % numStamps;
+    s.from = p->from;
+    s.id = p->id;
+    s.stage = stage;
+    s.usec = micros();
+}
+
+void PacketLatency::end(LatencyStage stage, const meshtastic_MeshPacket *p)
+{
+    if (!p)
+        return;
+    LatencyGuard g;
+    for (auto &s : stamps) {
+        if (s.stage == stage && s.id == p->id && s.from == p->from && s.usec) {
+            histograms[(int)stage].record(micros() - s.usec);
+            s.usec = 0;
+            return;
+        }
+    }
+}
+
+void PacketLatency::record(LatencyStage stage, uint32_t usec)
+{
+    LatencyGuard g;
+    histograms[(int)stage].record(usec);
+}
+
+LatencyHistogram PacketLatency::snapshot(LatencyStage stage)
+{
+    LatencyGuard g;
+    return histograms[(int)stage];
+}
+
+const char *PacketLatency::stageName(LatencyStage stage)
+{
+    return stageNames[(int)stage];
+}
+
+void PacketLatency::logSummary()
+{
+    for (int i = 0; i < (int)LatencyStage::COUNT; i++) {
+        LatencyHistogram h = snapshot((LatencyStage)i);
+        if (!h.getCount())
+            continue;
+        LOG_INFO("latency %s n=%u p50=%uus p90=%uus p99=%uus max=%uus", stageNames[i], h.getCount(), h.percentile(50),
+                 h.percentile(90), h.percentile(99), h.getMax());
+    }
+}
+
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "configuration.h"
+
+/// Time spent by packets in each stage from ISR to delivery, off by default because of the RAM and CPU it costs
+#ifndef MESHTASTIC_PACKET_LATENCY
+#define MESHTASTIC_PACKET_LATENCY 0
+#endif
+
+#if MESHTASTIC_PACKET_LATENCY
+
+enum class LatencyStage : uint8_t {
+    ISR_TO_THREAD,    // From isrRxLevel0 to handleReceiveInterrupt running
+    FROM_RADIO_QUEUE, // Waiting in Router::fromRadioQueue
+    DECODE,           // perhapsDecode
+    MODULES,          // MeshModule::callModules
+    TO_PHONE_QUEUE,   // Waiting in MeshService::toPhoneQueue until the phone fetches it
+    TX_QUEUE,         // Waiting in RadioLibInterface::txQueue until it is sent
+    COUNT
+};
+
+/**
+ * HDR-style histogram in fixed memory: buckets are linear within every power of two, so the relative error stays
+ * below 1/LATENCY_SUB_BUCKETS from 1us up to LATENCY_MAX_USEC.
+ */
+#define LATENCY_SUB_BUCKETS 4
+#define LATENCY_OCTAVES 25 // Up to 2^25us, about 33s
+#define LATENCY_MAX_USEC ((1UL << LATENCY_OCTAVES) - 1)
+
+class LatencyHistogram
+{
+  public:
+    void record(uint32_t usec);
+
+    /// Upper bound of the bucket holding the given percentile (0-100) of the samples
+    uint32_t percentile(float p) const;
+
+    uint32_t getCount() const { return count; }
+    uint32_t getMax() const { return maxUsec; }
+    void reset();
+
+  private:
+    uint16_t buckets[LATENCY_OCTAVES * LATENCY_SUB_BUCKETS] = {}; // saturating
+    uint32_t count = 0;
+    uint32_t maxUsec = 0;
+
+    static uint16_t bucketFor(uint32_t usec);
+    static uint32_t bucketUpperBound(uint16_t bucket);
+};
+
+/**
+ * Packets can't carry extra fields, so the start of the queue stages is stamped in a table keyed by (from, id), with room
+ * for every packet the timed queues can hold at once. A packet that is dropped from a queue simply ages out of the table.
+ */
+class PacketLatency
+{
+  public:
+    static void begin(LatencyStage stage, const meshtastic_MeshPacket *p);
+    static void end(LatencyStage stage, const meshtastic_MeshPacket *p);
+    static void record(LatencyStage stage, uint32_t usec);
+
+    /// Consistent copy of a histogram, for readers on other threads (e.g. the portduino web server)
+    static LatencyHistogram snapshot(LatencyStage stage);
+    static const char *stageName(LatencyStage stage);
+
+    /// Log p50/p90/p99/max for every stage
+    static void logSummary();
+
+    /// Set from the RX ISR, so it's just a volatile store there
+    static volatile uint32_t isrMicros;
+
+  private:
+    static LatencyHistogram histograms[(int)LatencyStage::COUNT];
+};
+
+/// Times the enclosing scope
+class LatencyScope
+{
+  public:
+    explicit LatencyScope(LatencyStage stage) : stage(stage), start(micros()) {}
+    ~LatencyScope() { PacketLatency::record(stage, micros() - start); }
+
+  private:
+    LatencyStage stage;
+    uint32_t start;
+};
+
+#define LATENCY_ISR() (PacketLatency::isrMicros = micros())
+#define LATENCY_BEGIN(stage, p) PacketLatency::begin(LatencyStage::stage, p)
+#define LATENCY_END(stage, p) PacketLatency::end(LatencyStage::stage, p)
+#define LATENCY_RECORD(stage, usec) PacketLatency::record(LatencyStage::stage, usec)
+#define LATENCY_SCOPE(stage) LatencyScope _latencyScope(LatencyStage::stage)
+#else
+#define LATENCY_ISR()
+#define LATENCY_BEGIN(stage, p)
+#define LATENCY_END(stage, p)
+#define LATENCY_RECORD(stage, usec)
+#define LATENCY_SCOPE(stage)
+#endif
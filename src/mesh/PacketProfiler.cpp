@@ -0,0 +1,35 @@
+#include "PacketProfiler.h"
+
+#if ARCH_PORTDUINO
+
+PacketProfiler::Stat PacketProfiler::stats[(int)PacketStage::COUNT];
+
+static const char *stageNames[] = {"decode", "history", "modules", "mqtt"};
+
+void PacketProfiler::add(PacketStage stage, uint32_t usec)
+{
+    Stat &s = stats[(int)stage];
+    s.count++;
+    s.totalUsec += usec;
+    if (usec > s.maxUsec)
+        s.maxUsec = usec;
+}
+
+void PacketProfiler::log()
+{
+    for (int i = 0; i < (int)PacketStage::COUNT; i++) {
+        const Stat &s = stats[i];
+        if (!s.count)
+            continue;
+        LOG_INFO("Stage %-8s %8u calls, %8.1f us mean, %6u us max, %8.1f ms total", stageNames[i], s.count,
+                 (double)s.totalUsec / s.count, s.maxUsec, s.totalUsec / 1000.0);
+    }
+}
+
+void PacketProfiler::reset()
+{
+    for (auto &s : stats)
+        s = {};
+}
+
+#endif
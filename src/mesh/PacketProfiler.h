@@ -0,0 +1,55 @@
+#pragma once
+
+#include "configuration.h"
+
+#if ARCH_PORTDUINO
+#include <chrono>
+#include <cstdint>
+
+/// Stages of handling a received packet we keep timing for
+enum class PacketStage : uint8_t { DECODE, HISTORY, MODULES, MQTT, COUNT };
+
+/**
+ * Per-stage CPU time spent on received packets, for profiling meshtasticd on real (replayed) traffic.
+ * Only used from the main loop, which is where the router runs on portduino.
+ */
+class PacketProfiler
+{
+  public:
+    static void add(PacketStage stage, uint32_t usec);
+
+    /// Log count, mean and max per stage
+    static void log();
+
+    static void reset();
+
+  private:
+    struct Stat {
+        uint32_t count;
+        uint64_t totalUsec;
+        uint32_t maxUsec;
+    };
+
+    static Stat stats[(int)PacketStage::COUNT];
+};
+
+/// Times the enclosing scope
+class PacketProfileScope
+{
+  public:
+    explicit PacketProfileScope(PacketStage stage) : stage(stage), start(std::chrono::steady_clock::now()) {}
+    ~PacketProfileScope()
+    {
+        PacketProfiler::add(stage, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+                                       .count());
+    }
+
+  private:
+    PacketStage stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define PROFILE_STAGE(stage) PacketProfileScope _profileScope(PacketStage::stage)
+#else
+#define PROFILE_STAGE(stage)
+#endif
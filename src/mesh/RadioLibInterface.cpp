@@ -1,6 +1,7 @@
 #include "RadioLibInterface.h"
 #include "MeshTypes.h"
 #include "NodeDB.h"
+#include "PacketLatency.h"
 #include "PowerMon.h"
 #include "SPILock.h"
 #include "Throttle.h"
@@ -11,6 +12,7 @@
 #include <pb_decode.h>
 #include <pb_encode.h>
 
+#include "platform/portduino/PacketTrace.h"
 #if ARCH_PORTDUINO
 #include "PortduinoGlue.h"
 #include "meshUtils.h"
@@ -68,6 +70,7 @@ void INTERRUPT_ATTR RadioLibInterface::isrLevel0Common(PendingISR cause)
 
 void INTERRUPT_ATTR RadioLibInterface::isrRxLevel0()
 {
+    LATENCY_ISR();
     isrLevel0Common(ISR_RX);
 }
 
@@ -172,6 +175,7 @@ ErrorCode RadioLibInterface::send(meshtastic_MeshPacket *p)
     printPacket("enqueue for send", p);
 
     LOG_DEBUG("txGood=%d,txRelay=%d,rxGood=%d,rxBad=%d", txGood, txRelay, rxGood, rxBad);
+    LATENCY_BEGIN(TX_QUEUE, p);
     ErrorCode res = txQueue.enqueue(p) ? ERRNO_OK : ERRNO_UNKNOWN;
 
     if (res != ERRNO_OK) { // we weren't able to queue it, so we must drop it to prevent leaks
@@ -274,16 +278,23 @@ void RadioLibInterface::onNotify(uint32_t notification)
                     if (isChannelActive()) { // check if there is currently a LoRa packet on the channel
                         startReceive();      // try receiving this packet, afterwards we'll be trying to transmit again
                         setTransmitDelay();
+                    } else if (!(txp = dequeueWithinTxBudget())) {
+                        // Only deferrable low priority packets left and no duty cycle budget for them, wait for it to refill
+                        meshtastic_MeshPacket *front = txQueue.getFront();
+                        uint32_t wait = airTime->getMsUntilTxBudget(getPacketTime(front), isDeferrable(front));
+                        LOG_DEBUG("Defer low priority TX by %ums for the duty cycle budget", wait);
+                        // Check back regularly, so packets that can't be deferred (ACKs, text) queued meanwhile are not held up
+                        wait = min(max(wait, (uint32_t)slotTimeMsec), (uint32_t)TX_BUDGET_RECHECK_MSEC);
+                        notifyLater(wait, TRANSMIT_DELAY_COMPLETED, false);
                     } else {
                         // Send any outgoing packets we have ready as fast as possible to keep the time between channel scan and
                         // actual transmission as short as possible
-                        txp = txQueue.dequeue();
-                        assert(txp);
+                        LATENCY_END(TX_QUEUE, txp);
                         bool sent = startSend(txp);
                         if (sent) {
                             // Packet has been sent, count it toward our TX airtime utilization.
                             uint32_t xmitMsec = getPacketTime(txp);
-                            airTime->logAirtime(TX_LOG, xmitMsec);
+                            airTime->logAirtime(TX_LOG, xmitMsec, txp);
                         }
                         LOG_DEBUG("%d packets remain in the TX queue", txQueue.getMaxLen() - txQueue.getFree());
                     }
@@ -298,6 +309,30 @@ void RadioLibInterface::onNotify(uint32_t notification)
     }
 }
 
+/**
+ * Low priority packets we originate (telemetry, position, nodeinfo, ...) are deferred when the duty cycle budget runs low.
+ * Relays are never deferred: they are encrypted, so fixPriority gives ACKs and text the same DEFAULT priority as the rest.
+ */
+bool RadioLibInterface::isDeferrable(const meshtastic_MeshPacket *p)
+{
+    return isFromUs(p) && p->priority < meshtastic_MeshPacket_Priority_RELIABLE;
+}
+
+/**
+ * Dequeue the packet to send next. Packets that can't be deferred always go first; if the front one is deferrable and does
+ * not fit in the duty cycle budget, a smaller deferrable packet that does fit is packed in instead.
+ * @return NULL if nothing may be sent right now
+ */
+meshtastic_MeshPacket *RadioLibInterface::dequeueWithinTxBudget()
+{
+    uint32_t now = millis();
+    return txQueue.dequeueFirst([this, now](const meshtastic_MeshPacket *p) {
+        if (p->tx_after && (int32_t)(p->tx_after - now) > 0)
+            return false; // still waiting in the late rebroadcast window
+        return !isDeferrable(p) || airTime->isTxAllowedBudget(getPacketTime(p), true);
+    });
+}
+
 void RadioLibInterface::setTransmitDelay()
 {
     meshtastic_MeshPacket *p = txQueue.getFront();
@@ -473,7 +508,9 @@ void RadioLibInterface::handleReceiveInterrupt()
 
             printPacket("Lora RX", mp);
 
-            airTime->logAirtime(RX_LOG, xmitMsec);
+            airTime->logAirtime(RX_LOG, xmitMsec, mp);
+            LATENCY_RECORD(ISR_TO_THREAD, micros() - PacketLatency::isrMicros);
+            TRACE_PACKET(TraceEvent::RADIO, mp);
 
             deliverToReceiver(mp);
         }
@@ -16,6 +16,9 @@
 
 #define RADIOLIB_PIN_TYPE uint32_t
 
+// How often we check back on the TX queue while low priority packets wait for duty cycle budget
+#define TX_BUDGET_RECHECK_MSEC 2000
+
 // In addition to the default Rx flags, we need the PREAMBLE_DETECTED flag to detect whether we are actively receiving
 #define MESHTASTIC_RADIOLIB_IRQ_RX_FLAGS (RADIOLIB_IRQ_RX_DEFAULT_FLAGS | (1 << RADIOLIB_IRQ_PREAMBLE_DETECTED))
 
@@ -163,6 +166,12 @@ class RadioLibInterface : public RadioInterface, protected concurrency::Notified
      */
     void startTransmitTimerSNR(float snr);
 
+    /** Low priority packets (telemetry, position, nodeinfo, ...) are deferred when the duty cycle budget runs low */
+    static bool isDeferrable(const meshtastic_MeshPacket *p);
+
+    /** Dequeue the packet to send next while honoring the duty cycle budget, NULL if nothing may be sent right now */
+    meshtastic_MeshPacket *dequeueWithinTxBudget();
+
     void handleTransmitInterrupt();
     void handleReceiveInterrupt();
 
@@ -4,17 +4,25 @@
 #include "MeshRadio.h"
 #include "MeshService.h"
 #include "NodeDB.h"
+#include "PacketAggregator.h"
+#include "PacketLatency.h"
+#include "PacketProfiler.h"
 #include "RTC.h"
+#include "compression/TextCompression.h"
 #include "configuration.h"
 #include "detect/LoRaRadioType.h"
 #include "main.h"
 #include "mesh-pb-constants.h"
 #include "meshUtils.h"
 #include "modules/RoutingModule.h"
+#if HAS_TELEMETRY
+#include "modules/Telemetry/TelemetryBatch.h"
+#endif
 #if !MESHTASTIC_EXCLUDE_MQTT
 #include "mqtt/MQTT.h"
 #endif
 #include "Default.h"
+#include "platform/portduino/PacketTrace.h"
 #if ARCH_PORTDUINO
 #include "platform/portduino/PortduinoGlue.h"
 #endif
@@ -22,17 +30,18 @@
 #include "serialization/MeshPacketSerializer.h"
 #endif
 
-#define MAX_RX_FROMRADIO                                                                                                         \
-    4 // max number of packets destined to our queue, we dispatch packets quickly so it doesn't need to be big
-
 // I think this is right, one packet for each of the three fifos + one packet being currently assembled for TX or RX
 // And every TX packet might have a retransmission packet or an ack alive at any moment
 #define MAX_PACKETS                                                                                                              \
     (MAX_RX_TOPHONE + MAX_RX_FROMRADIO + 2 * MAX_TX_QUEUE +                                                                      \
      2) // max number of packets which can be in flight (either queued from reception or queued for sending)
 
-// static MemoryPool<MeshPacket> staticPool(MAX_PACKETS);
+#ifdef ARCH_PORTDUINO
+// Sized for the usual load, floods beyond it fall back to malloc
+static MemorySlab<meshtastic_MeshPacket> staticPool(2 * MAX_PACKETS);
+#else
 static MemoryDynamic<meshtastic_MeshPacket> staticPool;
+#endif
 
 Allocator<meshtastic_MeshPacket> &packetPool = staticPool;
 
@@ -66,6 +75,7 @@ int32_t Router::runOnce()
 {
     meshtastic_MeshPacket *mp;
     while ((mp = fromRadioQueue.dequeuePtr(0)) != NULL) {
+        LATENCY_END(FROM_RADIO_QUEUE, mp);
         // printPacket("handle fromRadioQ", mp);
         perhapsHandleReceived(mp);
     }
@@ -80,6 +90,9 @@ int32_t Router::runOnce()
  */
 void Router::enqueueReceivedMessage(meshtastic_MeshPacket *p)
 {
+    if (!isFromUs(p)) // Capture for replay, but not our own packets looped back by sendLocal
+        TRACE_PACKET(TraceEvent::ENQUEUE, p);
+    LATENCY_BEGIN(FROM_RADIO_QUEUE, p);
     // Try enqueue until successful
     while (!fromRadioQueue.enqueue(p, 0)) {
         meshtastic_MeshPacket *old_p;
@@ -195,6 +208,10 @@ ErrorCode Router::sendLocal(meshtastic_MeshPacket *p, RxSource src)
             }
         }
 
+        // Small low priority packets might get to share a frame with others
+        if (packetAggregator && packetAggregator->hold(p))
+            return ERRNO_OK;
+
         return send(p);
     }
 }
@@ -271,6 +288,10 @@ ErrorCode Router::send(meshtastic_MeshPacket *p)
 
     fixPriority(p); // Before encryption, fix the priority if it's unset
 
+    // Remember the portnum for airtime accounting, relays we could not decode stay UNKNOWN_APP
+    meshtastic_PortNum portnum = p->which_payload_variant == meshtastic_MeshPacket_decoded_tag ? p->decoded.portnum
+                                                                                                : meshtastic_PortNum_UNKNOWN_APP;
+
     // If the packet is not yet encrypted, do so now
     if (p->which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
         ChannelIndex chIndex = p->channel; // keep as a local because we are about to change it
@@ -299,6 +320,9 @@ ErrorCode Router::send(meshtastic_MeshPacket *p)
 #endif
 
     assert(iface); // This should have been detected already in sendLocal (or we just received a packet from outside)
+    // Note: this counts packets when queued, so rebroadcasts cancelled later on are included as well
+    airTime->logPortnumAirtime(TX_LOG, portnum, iface->getPacketTime(p));
+    TRACE_PACKET(isFromUs(p) ? TraceEvent::TX : TraceEvent::ROUTE, p);
     return iface->send(p);
 }
 
@@ -330,6 +354,8 @@ void Router::sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Rout
 
 DecodeState perhapsDecode(meshtastic_MeshPacket *p)
 {
+    PROFILE_STAGE(DECODE);
+    LATENCY_SCOPE(DECODE);
     concurrency::LockGuard g(cryptLock);
 
     if (config.device.role == meshtastic_Config_DeviceConfig_Role_REPEATER &&
@@ -421,25 +447,9 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
         if (p->decoded.has_bitfield)
             p->decoded.want_response |= p->decoded.bitfield & BITFIELD_WANT_RESPONSE_MASK;
 
-        /* Not actually ever used.
-        // Decompress if needed. jm
-        if (p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP) {
-            // Decompress the payload
-            char compressed_in[meshtastic_Constants_DATA_PAYLOAD_LEN] = {};
-            char decompressed_out[meshtastic_Constants_DATA_PAYLOAD_LEN] = {};
-            int decompressed_len;
-
-            memcpy(compressed_in, p->decoded.payload.bytes, p->decoded.payload.size);
-
-            decompressed_len = unishox2_decompress_simple(compressed_in, p->decoded.payload.size, decompressed_out);
-
-            // LOG_DEBUG("**Decompressed length - %d ", decompressed_len);
-
-            memcpy(p->decoded.payload.bytes, decompressed_out, decompressed_len);
-
-            // Switch the port from PortNum_TEXT_MESSAGE_COMPRESSED_APP to PortNum_TEXT_MESSAGE_APP
-            p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
-        } */
+        // Decompress if needed, so the rest of the firmware and the phone only ever see TEXT_MESSAGE_APP
+        TextCompression::perhapsDecompress(p);
+        TextCompression::perhapsAddPeer(p);
 
         printPacket("decoded message", p);
 #if ENABLE_JSON_LOGGING
@@ -449,9 +459,11 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
             LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
         }
 #endif
+        TRACE_PACKET(TraceEvent::DECODE, p);
         return DecodeState::DECODE_SUCCESS;
     } else {
         LOG_WARN("No suitable channel found for decoding, hash was 0x%x!", p->channel);
+        TRACE_DROP(DECODE_FAILURE, p);
         return DecodeState::DECODE_FAILURE;
     }
 }
@@ -470,44 +482,16 @@ meshtastic_Routing_Error perhapsEncode(meshtastic_MeshPacket *p)
             p->decoded.has_bitfield = true;
             p->decoded.bitfield |= (config.lora.config_ok_to_mqtt << BITFIELD_OK_TO_MQTT_SHIFT);
             p->decoded.bitfield |= (p->decoded.want_response << BITFIELD_WANT_RESPONSE_SHIFT);
+#if TEXT_COMPRESSION_MESH_EXTENSIONS
+            // We can always decompress, so let others know they can send us compressed text
+            p->decoded.bitfield |= BITFIELD_TEXT_COMPRESSION_MASK;
+#endif
         }
 
-        size_t numbytes = pb_encode_to_bytes(bytes, sizeof(bytes), &meshtastic_Data_msg, &p->decoded);
-
-        /* Not actually used, so save the cycles
-        //  TODO: Allow modules to opt into compression.
-        if (p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_APP) {
-
-            char original_payload[meshtastic_Constants_DATA_PAYLOAD_LEN];
-            memcpy(original_payload, p->decoded.payload.bytes, p->decoded.payload.size);
-
-            char compressed_out[meshtastic_Constants_DATA_PAYLOAD_LEN] = {0};
-
-            int compressed_len;
-            compressed_len = unishox2_compress_simple(original_payload, p->decoded.payload.size, compressed_out);
-
-            LOG_DEBUG("Original length - %d ", p->decoded.payload.size);
-            LOG_DEBUG("Compressed length - %d ", compressed_len);
-            LOG_DEBUG("Original message - %s ", p->decoded.payload.bytes);
-
-            // If the compressed length is greater than or equal to the original size, don't use the compressed form
-            if (compressed_len >= p->decoded.payload.size) {
+        // Only replaces the payload if the compressed form is smaller
+        TextCompression::perhapsCompress(p);
 
-                LOG_DEBUG("Not using compressing message");
-                // Set the uncompressed payload variant anyway. Shouldn't hurt?
-                // p->decoded.which_payloadVariant = Data_payload_tag;
-
-                // Otherwise we use the compressor
-            } else {
-                LOG_DEBUG("Use compressed message");
-                // Copy the compressed data into the meshpacket
-
-                p->decoded.payload.size = compressed_len;
-                memcpy(p->decoded.payload.bytes, compressed_out, compressed_len);
-
-                p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP;
-            }
-        } */
+        size_t numbytes = pb_encode_to_bytes(bytes, sizeof(bytes), &meshtastic_Data_msg, &p->decoded);
 
         if (numbytes + MESHTASTIC_HEADER_LENGTH > MAX_LORA_PAYLOAD_LEN)
             return meshtastic_Routing_Error_TOO_LARGE;
@@ -594,6 +578,13 @@ NodeNum Router::getNodeNum()
     return nodeDB->getNodeNum();
 }
 
+static void deliverUnpacked(meshtastic_MeshPacket *p, RxSource src)
+{
+    printPacket("handleReceived(UNPACKED)", p);
+    MeshModule::callModules(*p, src);
+    packetPool.release(p);
+}
+
 /**
  * Handle any packet that is received by an interface on this node.
  * Note: some packets may merely being passed through this node and will be forwarded elsewhere.
@@ -648,10 +639,36 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
     } else {
         printPacket("packet decoding failed or skipped (no PSK?)", p);
     }
+    if (src == RX_SRC_RADIO) { // Not our own packets, or those from the phone or MQTT
+        if (decodedState == DecodeState::DECODE_SUCCESS)
+            rxDecoded++;
+        else
+            rxUndecodable++;
+    }
+
+    if (src == RX_SRC_RADIO && iface) {
+        airTime->logPortnumAirtime(RX_LOG,
+                                   decodedState == DecodeState::DECODE_SUCCESS ? p->decoded.portnum
+                                                                               : meshtastic_PortNum_UNKNOWN_APP,
+                                   iface->getPacketTime(p_encrypted));
+    }
 
     // call modules here
     if (!skipHandle) {
-        MeshModule::callModules(*p, src);
+        {
+            PROFILE_STAGE(MODULES);
+            LATENCY_SCOPE(MODULES);
+            MeshModule::callModules(*p, src);
+        }
+
+        // Hand the records of an aggregate container to the modules as well, the container itself is what gets relayed
+        if (decodedState == DecodeState::DECODE_SUCCESS && PacketAggregator::isContainer(p))
+            PacketAggregator::unpack(p, deliverUnpacked, src);
+#if HAS_TELEMETRY
+        // Likewise the windows of a telemetry batch, as the telemetry modules and the phone only know single samples
+        if (decodedState == DecodeState::DECODE_SUCCESS && TelemetryBatch::isBatch(*p))
+            TelemetryBatch::expand(*p, deliverUnpacked, src);
+#endif
 
 #if !MESHTASTIC_EXCLUDE_MQTT
         // Mark as pki_encrypted if it is not yet decoded and MQTT encryption is also enabled, hash matches and it's a DM not to
@@ -661,8 +678,10 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
             p_encrypted->pki_encrypted = true;
         // After potentially altering it, publish received message to MQTT if we're not the original transmitter of the packet
         if ((decodedState == DecodeState::DECODE_SUCCESS || p_encrypted->pki_encrypted) && moduleConfig.mqtt.enabled &&
-            !isFromUs(p) && mqtt)
+            !isFromUs(p) && mqtt) {
+            PROFILE_STAGE(MQTT);
             mqtt->onSend(*p_encrypted, *p, p->channel);
+        }
 #endif
     }
 
@@ -682,9 +701,11 @@ void Router::perhapsHandleReceived(meshtastic_MeshPacket *p)
         LOG_TRACE("%s", MeshPacketSerializer::JsonSerializeEncrypted(p).c_str());
     }
 #endif
+    TRACE_PACKET(TraceEvent::RX, p);
     // assert(radioConfig.has_preferences);
     if (is_in_repeated(config.lora.ignore_incoming, p->from)) {
         LOG_DEBUG("Ignore msg, 0x%x is in our ignore list", p->from);
+        TRACE_DROP(IGNORE_LIST, p);
         packetPool.release(p);
         return;
     }
@@ -692,24 +713,28 @@ void Router::perhapsHandleReceived(meshtastic_MeshPacket *p)
     meshtastic_NodeInfoLite const *node = nodeDB->getMeshNode(p->from);
     if (node != NULL && node->is_ignored) {
         LOG_DEBUG("Ignore msg, 0x%x is ignored", p->from);
+        TRACE_DROP(IGNORED_NODE, p);
         packetPool.release(p);
         return;
     }
 
     if (p->from == NODENUM_BROADCAST) {
         LOG_DEBUG("Ignore msg from broadcast address");
+        TRACE_DROP(FROM_BROADCAST, p);
         packetPool.release(p);
         return;
     }
 
     if (config.lora.ignore_mqtt && p->via_mqtt) {
         LOG_DEBUG("Msg came in via MQTT from 0x%x", p->from);
+        TRACE_DROP(IGNORE_MQTT, p);
         packetPool.release(p);
         return;
     }
 
     if (shouldFilterReceived(p)) {
         LOG_DEBUG("Incoming msg was filtered from 0x%x", p->from);
+        TRACE_DROP(FILTERED, p);
         packetPool.release(p);
         return;
     }
@@ -62,6 +62,9 @@ class Router : protected concurrency::OSThread, protected PacketHistory
     /** Return Underlying interface's TX queue status */
     meshtastic_QueueStatus getQueueStatus();
 
+    /// Airtime in msec of a packet of the given length on our interface, 0 if we don't have one
+    uint32_t getPacketTime(uint32_t totalPacketLen) { return iface ? iface->getPacketTime(totalPacketLen) : 0; }
+
     /**
      * @return our local nodenum */
     NodeNum getNodeNum();
@@ -90,6 +93,10 @@ class Router : protected concurrency::OSThread, protected PacketHistory
     /* Statistics for the amount of duplicate received packets and the amount of times we cancel a relay because someone did it
         before us */
     uint32_t rxDupe = 0, txRelayCanceled = 0;
+    /// Packets received from the radio that we could or could not decrypt
+    uint32_t rxDecoded = 0, rxUndecodable = 0;
+
+    int getFromRadioQueueDepth() { return fromRadioQueue.numUsed(); }
 
   protected:
     friend class RoutingModule;
@@ -161,5 +168,8 @@ PacketId generatePacketId();
 
 #define BITFIELD_WANT_RESPONSE_SHIFT 1
 #define BITFIELD_OK_TO_MQTT_SHIFT 0
+// Sender can decompress TEXT_MESSAGE_COMPRESSED_APP, not allocated upstream so only used with TEXT_COMPRESSION_MESH_EXTENSIONS
+#define BITFIELD_TEXT_COMPRESSION_SHIFT 2
 #define BITFIELD_WANT_RESPONSE_MASK (1 << BITFIELD_WANT_RESPONSE_SHIFT)
-#define BITFIELD_OK_TO_MQTT_MASK (1 << BITFIELD_OK_TO_MQTT_SHIFT)
\ No newline at end of file
+#define BITFIELD_OK_TO_MQTT_MASK (1 << BITFIELD_OK_TO_MQTT_SHIFT)
+#define BITFIELD_TEXT_COMPRESSION_MASK (1 << BITFIELD_TEXT_COMPRESSION_SHIFT)
\ No newline at end of file
@@ -85,5 +85,5 @@ class StreamAPI : public PhoneAPI
     uint8_t txBuf[MAX_STREAM_BUF_SIZE] = {0};
 
     /// Low level function to emit a protobuf encapsulated log record
-    void emitLogRecord(meshtastic_LogRecord_Level level, const char *src, const char *format, va_list arg);
+    void emitLogRecord(meshtastic_LogRecord_Level level, const char *src, const char *message);
 };
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "TextCompression.h"
+#include "Router.h"
+#include "configuration.h"
+#include "mesh-pb-constants.h"
+#include "unishox2.h"
+
+#if TEXT_COMPRESSION_MESH_EXTENSIONS
+// Frequent sequences in mesh chat, picked greedily on a corpus of typical messages (see test/test_compression)
+static const char *USX_FREQ_SEQ_MESH[] = {" the ", " you", "ing ", "Meshtastic", "ight", "anyone"};
+
+#define USX_PSET_MESH USX_HCODES_DFLT, USX_HCODE_LENS_DFLT, USX_FREQ_SEQ_MESH, USX_TEMPLATES
+#else
+#define USX_PSET_MESH USX_PSET_DFLT
+#endif
+
+NodeNum TextCompression::peers[TEXT_COMPRESSION_MAX_PEERS];
+uint8_t TextCompression::nextPeer = 0;
+TextCompression::Relay TextCompression::relays[TEXT_COMPRESSION_MAX_RELAYS];
+uint8_t TextCompression::nextRelay = 0;
+
+int TextCompression::compress(const char *in, int len, char *out, int olen)
+{
+    return unishox2_compress(in, len, out, olen, USX_PSET_MESH);
+}
+
+int TextCompression::decompress(const char *in, int len, char *out, int olen)
+{
+    return unishox2_decompress(in, len, out, olen, USX_PSET_MESH);
+}
+
+bool TextCompression::perhapsCompress(meshtastic_MeshPacket *p)
+{
+    if (p->which_payload_variant != meshtastic_MeshPacket_decoded_tag ||
+        p->decoded.portnum != meshtastic_PortNum_TEXT_MESSAGE_APP)
+        return false;
+
+    if (!isFromUs(p)) {
+        // perhapsDecode gave us plain text, relay it the way the sender chose to send it
+        if (!arrivedCompressed(p))
+            return false;
+    } else if (USERPREFS_TEXT_COMPRESSION == TEXT_COMPRESSION_OFF ||
+               (USERPREFS_TEXT_COMPRESSION == TEXT_COMPRESSION_NEGOTIATED && (isBroadcast(p->to) || !isPeer(p->to)))) {
+        return false;
+    }
+
+    char compressed[meshtastic_Constants_DATA_PAYLOAD_LEN];
+    int compressedLen =
+        compress((const char *)p->decoded.payload.bytes, p->decoded.payload.size, compressed, sizeof(compressed));
+    if (compressedLen <= 0 || compressedLen >= (int)p->decoded.payload.size) {
+        LOG_DEBUG("Text of %d bytes does not compress, send as is", p->decoded.payload.size);
+        return false;
+    }
+
+    LOG_DEBUG("Compressed text from %d to %d bytes", p->decoded.payload.size, compressedLen);
+    memcpy(p->decoded.payload.bytes, compressed, compressedLen);
+    p->decoded.payload.size = compressedLen;
+    p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP;
+    return true;
+}
+
+bool TextCompression::perhapsDecompress(meshtastic_MeshPacket *p)
+{
+    if (p->which_payload_variant != meshtastic_MeshPacket_decoded_tag ||
+        p->decoded.portnum != meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP)
+        return false;
+
+    char decompressed[meshtastic_Constants_DATA_PAYLOAD_LEN];
+    int decompressedLen = decompress((const char *)p->decoded.payload.bytes, p->decoded.payload.size, decompressed,
+                                     sizeof(decompressed));
+    if (decompressedLen < 0 || decompressedLen > (int)sizeof(decompressed)) {
+        LOG_WARN("Failed to decompress text from 0x%x", p->from);
+        return false;
+    }
+
+    memcpy(p->decoded.payload.bytes, decompressed, decompressedLen);
+    p->decoded.payload.size = decompressedLen;
+    p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    addPeer(p->from);
+    if (!isFromUs(p) && !arrivedCompressed(p)) {
+        relays[nextRelay] = {p->from, p->id};
+        nextRelay = (nextRelay + 1) % TEXT_COMPRESSION_MAX_RELAYS;
+    }
+    return true;
+}
+
+void TextCompression::perhapsAddPeer(const meshtastic_MeshPacket *p)
+{
+#if TEXT_COMPRESSION_MESH_EXTENSIONS
+    if (p->which_payload_variant == meshtastic_MeshPacket_decoded_tag && p->decoded.has_bitfield &&
+        (p->decoded.bitfield & BITFIELD_TEXT_COMPRESSION_MASK) && !isFromUs(p))
+        addPeer(p->from);
+#endif
+}
+
+bool TextCompression::arrivedCompressed(const meshtastic_MeshPacket *p)
+{
+    for (auto &r : relays) {
+        if (r.id == p->id && r.from == p->from)
+            return r.id != 0;
+    }
+    return false;
+}
+
+void TextCompression::addPeer(NodeNum n)
+{
+    if (isPeer(n))
+        return;
+    peers[nextPeer] = n;
+    nextPeer = (nextPeer + 1) % TEXT_COMPRESSION_MAX_PEERS;
+}
+
+bool TextCompression::isPeer(NodeNum n)
+{
+    for (auto peer : peers) {
+        if (peer == n)
+            return n != 0;
+    }
+    return false;
+}
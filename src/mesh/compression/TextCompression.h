@@ -0,0 +1,79 @@
+#pragma once
+
+#include "MeshTypes.h"
+
+/**
+ * 0: never compress, but still decompress TEXT_MESSAGE_COMPRESSED_APP we receive
+ * 1: compress DMs to nodes that can decompress, as told by compressed text they sent (or the bitfield of their packets, see
+ *    TEXT_COMPRESSION_MESH_EXTENSIONS)
+ * 2: compress all text we originate, for meshes where every node supports it
+ */
+#define TEXT_COMPRESSION_OFF 0
+#define TEXT_COMPRESSION_NEGOTIATED 1
+#define TEXT_COMPRESSION_ALWAYS 2
+
+#ifndef USERPREFS_TEXT_COMPRESSION
+#define USERPREFS_TEXT_COMPRESSION TEXT_COMPRESSION_NEGOTIATED
+#endif
+
+/**
+ * Off by default, for meshes where every node runs a build with it on: advertise support in bit
+ * BITFIELD_TEXT_COMPRESSION_SHIFT of Data.bitfield (not allocated upstream) and use the mesh chat dictionary, which
+ * stock unishox2 decoders can't read. Otherwise the stock unishox2 tables are used and peers are only learnt from the
+ * compressed text they send.
+ */
+#ifndef TEXT_COMPRESSION_MESH_EXTENSIONS
+#define TEXT_COMPRESSION_MESH_EXTENSIONS 0
+#endif
+
+/// Number of nodes we remember to accept compressed text
+#define TEXT_COMPRESSION_MAX_PEERS 32
+
+/// Number of compressed packets from others we remember, to relay them compressed as well
+#define TEXT_COMPRESSION_MAX_RELAYS 16
+
+/**
+ * Unishox2 compression of text payloads (text messages, canned messages) on TEXT_MESSAGE_COMPRESSED_APP, optionally with a
+ * preset dictionary of sequences that are frequent in mesh chat. Payloads are only replaced when the compressed form is
+ * smaller.
+ */
+class TextCompression
+{
+  public:
+    /// @return compressed length, output is never larger than olen
+    static int compress(const char *in, int len, char *out, int olen);
+    /// @return decompressed length, or a negative value on malformed input
+    static int decompress(const char *in, int len, char *out, int olen);
+
+    /**
+     * Compress a TEXT_MESSAGE_APP packet in place if it is smaller. Packets we originate are compressed if allowed for their
+     * destination, packets we relay only if they reached us compressed.
+     * @return true if the packet was changed to TEXT_MESSAGE_COMPRESSED_APP
+     */
+    static bool perhapsCompress(meshtastic_MeshPacket *p);
+
+    /**
+     * Decompress a decoded TEXT_MESSAGE_COMPRESSED_APP packet back into TEXT_MESSAGE_APP and remember that the sender
+     * supports compressed text
+     * @return true if the packet was changed to TEXT_MESSAGE_APP
+     */
+    static bool perhapsDecompress(meshtastic_MeshPacket *p);
+
+    /// Remember that a node can decompress text, if the bitfield of a decoded packet from it says so (mesh extensions only)
+    static void perhapsAddPeer(const meshtastic_MeshPacket *p);
+
+  private:
+    static NodeNum peers[TEXT_COMPRESSION_MAX_PEERS];
+    static uint8_t nextPeer;
+
+    struct Relay {
+        NodeNum from;
+        PacketId id;
+    };
+    static Relay relays[TEXT_COMPRESSION_MAX_RELAYS];
+    static uint8_t nextRelay;
+
+    static void addPeer(NodeNum n);
+    static bool isPeer(NodeNum n);
+    static bool arrivedCompressed(const meshtastic_MeshPacket *p);
+};
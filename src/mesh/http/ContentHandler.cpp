@@ -5,6 +5,7 @@
 #include "airtime.h"
 #include "main.h"
 #include "mesh/http/ContentHelper.h"
+#include "modules/RangeTestModule.h"
 #include "mesh/http/WebServer.h"
 #if HAS_WIFI
 #include "mesh/wifi/WiFiAPClient.h"
@@ -98,6 +99,11 @@ void registerHandlers(HTTPServer *insecureServer, HTTPSServer *secureServer)
     ResourceNode *nodeJsonFsBrowseStatic = new ResourceNode("/json/fs/browse/static", "GET", &handleFsBrowseStatic);
     ResourceNode *nodeJsonDelete = new ResourceNode("/json/fs/delete/static", "DELETE", &handleFsDeleteStatic);
 
+#if RANGETEST_BINARY
+    // Converted from the binary file, at the same place the CSV file would be
+    ResourceNode *nodeRangeTestCsv = new ResourceNode(RANGETEST_CSV_FILE, "GET", &handleRangeTestCsv);
+#endif
+
     ResourceNode *nodeRoot = new ResourceNode("/*", "GET", &handleStatic);
 
     // Secure nodes
@@ -118,6 +124,9 @@ void registerHandlers(HTTPServer *insecureServer, HTTPSServer *secureServer)
     //    secureServer->registerNode(nodeUpdateFs);
     //    secureServer->registerNode(nodeDeleteFs);
     secureServer->registerNode(nodeAdmin);
+#if RANGETEST_BINARY
+    secureServer->registerNode(nodeRangeTestCsv);
+#endif
     //    secureServer->registerNode(nodeAdminFs);
     //    secureServer->registerNode(nodeAdminSettings);
     //    secureServer->registerNode(nodeAdminSettingsApply);
@@ -140,6 +149,9 @@ void registerHandlers(HTTPServer *insecureServer, HTTPSServer *secureServer)
     //    insecureServer->registerNode(nodeUpdateFs);
     //    insecureServer->registerNode(nodeDeleteFs);
     insecureServer->registerNode(nodeAdmin);
+#if RANGETEST_BINARY
+    insecureServer->registerNode(nodeRangeTestCsv);
+#endif
     //    insecureServer->registerNode(nodeAdminFs);
     //    insecureServer->registerNode(nodeAdminSettings);
     //    insecureServer->registerNode(nodeAdminSettingsApply);
@@ -643,6 +655,32 @@ void handleReport(HTTPRequest *req, HTTPResponse *res)
     jsonObjAirtime["seconds_per_period"] = new JSONValue(int(airTime->getSecondsPerPeriod()));
     jsonObjAirtime["periods_to_log"] = new JSONValue(airTime->getPeriodsToLog());
 
+    // data->airtime->breakdown, for the current period only
+    const AirtimeBreakdown &breakdown = airTime->getBreakdown();
+    JSONObject jsonObjPortnumTX, jsonObjPortnumRX, jsonObjNodes;
+    for (uint8_t i = 0; i < breakdown.portnumTX.size(); i++) {
+        jsonObjPortnumTX[std::to_string(breakdown.portnumTX.get(i).key)] =
+            new JSONValue((int)breakdown.portnumTX.get(i).airtime_ms);
+    }
+    for (uint8_t i = 0; i < breakdown.portnumRX.size(); i++) {
+        jsonObjPortnumRX[std::to_string(breakdown.portnumRX.get(i).key)] =
+            new JSONValue((int)breakdown.portnumRX.get(i).airtime_ms);
+    }
+    for (uint8_t i = 0; i < breakdown.nodes.size(); i++) {
+        char nodeId[16];
+        snprintf(nodeId, sizeof(nodeId), "!%08x", breakdown.nodes.get(i).key);
+        jsonObjNodes[nodeId] = new JSONValue((int)breakdown.nodes.get(i).airtime_ms);
+    }
+    JSONObject jsonObjBreakdown;
+    jsonObjBreakdown["portnum_tx"] = new JSONValue(jsonObjPortnumTX);
+    jsonObjBreakdown["portnum_rx"] = new JSONValue(jsonObjPortnumRX);
+    jsonObjBreakdown["top_nodes"] = new JSONValue(jsonObjNodes);
+    jsonObjBreakdown["origin_tx"] = new JSONValue((int)breakdown.originTX_ms);
+    jsonObjBreakdown["relay_tx"] = new JSONValue((int)breakdown.relayTX_ms);
+    jsonObjBreakdown["origin_rx"] = new JSONValue((int)breakdown.originRX_ms);
+    jsonObjBreakdown["relay_rx"] = new JSONValue((int)breakdown.relayRX_ms);
+    jsonObjAirtime["breakdown"] = new JSONValue(jsonObjBreakdown);
+
     // data->wifi
     JSONObject jsonObjWifi;
     jsonObjWifi["rssi"] = new JSONValue(WiFi.RSSI());
@@ -767,6 +805,14 @@ void handleNodes(HTTPRequest *req, HTTPResponse *res)
     delete value;
 }
 
+void handleRangeTestCsv(HTTPRequest *req, HTTPResponse *res)
+{
+    res->setHeader("Content-Type", "text/csv");
+    res->setHeader("Content-Disposition", "attachment; filename=rangetest.csv");
+    if (rangeTestModuleRadio)
+        rangeTestModuleRadio->writeCsv(*res);
+}
+
 /*
     This supports the Apple Captive Network Assistant (CNA) Portal
 */
@@ -18,6 +18,11 @@
 #define MAX_RX_TOPHONE 32
 #endif
 
+/// max number of packets destined to our queue, we dispatch packets quickly so it doesn't need to be big
+#ifndef MAX_RX_FROMRADIO
+#define MAX_RX_FROMRADIO 4
+#endif
+
 /// Verify baseline assumption of node size. If it increases, we need to reevaluate
 /// the impact of its memory footprint, notably on MAX_NUM_NODES.
 static_assert(sizeof(meshtastic_NodeInfoLite) <= 192, "NodeInfoLite size increased. Reconsider impact on MAX_NUM_NODES.");
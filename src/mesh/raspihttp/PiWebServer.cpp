@@ -38,13 +38,18 @@ mail:   marchammermann@googlemail.com
 #if __has_include(<ulfius.h>)
 #include "PiWebServer.h"
 #include "NodeDB.h"
+#include "PacketLatency.h"
 #include "PhoneAPI.h"
 #include "PowerFSM.h"
 #include "RadioLibInterface.h"
+#include "Router.h"
 #include "airtime.h"
 #include "graphics/Screen.h"
 #include "main.h"
 #include "mesh/wifi/WiFiAPClient.h"
+#if !MESHTASTIC_EXCLUDE_MQTT
+#include "mqtt/MQTT.h"
+#endif
 #include "sleep.h"
 #include <openssl/bn.h>
 #include <openssl/evp.h>
@@ -57,6 +62,7 @@ mail:   marchammermann@googlemail.com
 #include <yder.h>
 
 #include <cstring>
+#include <mutex>
 #include <string>
 
 #include "PortduinoFS.h"
@@ -302,6 +308,115 @@ int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res,
     return U_CALLBACK_COMPLETE;
 }
 
+/*
+ * OpenMetrics (Prometheus) text exposition of our operational metrics.
+ * Written into a static buffer, so scraping doesn't allocate anything on the heap.
+ */
+#define METRICS_BUFFER_SIZE (32 * 1024)
+
+static char metricsBuf[METRICS_BUFFER_SIZE];
+static size_t metricsLen;
+static std::mutex metricsLock;
+
+static void metricsPrintf(const char *format, ...)
+{
+    if (metricsLen >= sizeof(metricsBuf))
+        return;
+    va_list arg;
+    va_start(arg, format);
+    int n = vsnprintf(metricsBuf + metricsLen, sizeof(metricsBuf) - metricsLen, format, arg);
+    va_end(arg);
+    if (n > 0)
+        metricsLen = min(metricsLen + n, sizeof(metricsBuf));
+}
+
+static void metric(const char *name, const char *type, const char *help, double value)
+{
+    metricsPrintf("# TYPE meshtastic_%s %s\n# HELP meshtastic_%s %s\n", name, type, name, help);
+    metricsPrintf("meshtastic_%s%s %g\n", name, strcmp(type, "counter") == 0 ? "_total" : "", value);
+}
+
+int handleMetrics(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    std::lock_guard<std::mutex> guard(metricsLock);
+    metricsLen = 0;
+
+    // These are read from the mesh thread without locking, a scrape may be off by a packet
+    if (RadioLibInterface::instance) {
+        meshtastic_QueueStatus qs = RadioLibInterface::instance->getQueueStatus();
+        metric("tx_queue_depth", "gauge", "Packets waiting in the radio TX queue", qs.maxlen - qs.free);
+        metric("rx_good", "counter", "Packets received from the radio", RadioLibInterface::instance->rxGood);
+        metric("rx_bad", "counter", "Packets received from the radio with errors", RadioLibInterface::instance->rxBad);
+        metric("tx_good", "counter", "Packets sent by the radio", RadioLibInterface::instance->txGood);
+        metric("tx_relay", "counter", "Packets relayed by the radio", RadioLibInterface::instance->txRelay);
+    }
+    if (router) {
+        metric("from_radio_queue_depth", "gauge", "Received packets waiting for the router", router->getFromRadioQueueDepth());
+        metric("rx_decoded", "counter", "Received packets we could decrypt", router->rxDecoded);
+        metric("rx_undecodable", "counter", "Received packets we could not decrypt", router->rxUndecodable);
+        metric("rx_dupe", "counter", "Received packets we had seen before", router->rxDupe);
+        metric("tx_relay_canceled", "counter", "Relays canceled because another node was first", router->txRelayCanceled);
+    }
+#if !MESHTASTIC_EXCLUDE_MQTT
+    if (mqtt)
+        metric("mqtt_queue_depth", "gauge", "Messages waiting to be published to MQTT", mqtt->getQueueDepth());
+#endif
+    metric("packet_pool_in_use", "gauge", "Packets allocated from the packet pool", packetPool.getInUse());
+    if (airTime) {
+        metric("channel_utilization_ratio", "gauge", "Channel utilization", airTime->channelUtilizationPercent() / 100);
+        metric("air_util_tx_ratio", "gauge", "Our share of airtime in the last hour", airTime->utilizationTXPercent() / 100);
+    }
+    if (nodeDB)
+        metric("nodes", "gauge", "Nodes in the NodeDB", nodeDB->getNumMeshNodes());
+
+    metricsPrintf("# TYPE meshtastic_thread_runtime_seconds counter\n"
+                  "# HELP meshtastic_thread_runtime_seconds CPU time spent in each thread\n");
+    concurrency::OSThread::forEachThread([](const concurrency::OSThread &t) {
+        metricsPrintf("meshtastic_thread_runtime_seconds_total{thread=\"%s\"} %.6f\n", t.ThreadName.c_str(),
+                      t.getRuntimeUsec() / 1e6);
+    });
+#if MESHTASTIC_PACKET_LATENCY
+    metricsPrintf("# TYPE meshtastic_packet_latency_seconds summary\n"
+                  "# HELP meshtastic_packet_latency_seconds Time packets spend in each stage\n");
+    for (int i = 0; i < (int)LatencyStage::COUNT; i++) {
+        LatencyHistogram h = PacketLatency::snapshot((LatencyStage)i);
+        const char *stage = PacketLatency::stageName((LatencyStage)i);
+        for (float q : {50.0f, 90.0f, 99.0f})
+            metricsPrintf("meshtastic_packet_latency_seconds{stage=\"%s\",quantile=\"%g\"} %g\n", stage, q / 100,
+                          h.percentile(q) / 1e6);
+        metricsPrintf("meshtastic_packet_latency_seconds_count{stage=\"%s\"} %u\n", stage, h.getCount());
+    }
+#endif
+    metricsPrintf("# EOF\n");
+
+    ulfius_add_header_to_response(res, "Content-Type", "application/openmetrics-text; version=1.0.0; charset=utf-8");
+    ulfius_set_binary_body_response(res, 200, metricsBuf, metricsLen);
+    return U_CALLBACK_COMPLETE;
+}
+
+#if MESHTASTIC_PACKET_LATENCY
+/*
+ * Per-stage packet latency percentiles, as JSON
+ */
+int handleJsonLatency(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    char body[128 * (int)LatencyStage::COUNT];
+    size_t len = snprintf(body, sizeof(body), "{");
+    for (int i = 0; i < (int)LatencyStage::COUNT; i++) {
+        LatencyHistogram h = PacketLatency::snapshot((LatencyStage)i);
+        len += snprintf(body + len, sizeof(body) - len,
+                        "%s\"%s\":{\"count\":%u,\"p50_us\":%u,\"p90_us\":%u,\"p99_us\":%u,\"max_us\":%u}", i ? "," : "",
+                        PacketLatency::stageName((LatencyStage)i), h.getCount(), h.percentile(50), h.percentile(90),
+                        h.percentile(99), h.getMax());
+    }
+    snprintf(body + len, sizeof(body) - len, "}");
+
+    ulfius_add_header_to_response(res, "Content-Type", "application/json");
+    ulfius_set_string_body_response(res, 200, body);
+    return U_CALLBACK_COMPLETE;
+}
+#endif
+
 /*
 OpenSSL RSA Key Gen
 */
@@ -503,6 +618,10 @@ PiWebServerThread::PiWebServerThread()
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/fromradio/*", 1, &handleAPIv1FromRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "PUT", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/metrics", 1, &handleMetrics, NULL);
+#if MESHTASTIC_PACKET_LATENCY
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/json/latency", 1, &handleJsonLatency, NULL);
+#endif
 
         // Add callback function to all endpoints for the Web Server
         ulfius_add_endpoint_by_val(&instanceWeb, "GET", NULL, "/*", 2, &callback_static_file, &configWeb);
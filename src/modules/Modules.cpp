@@ -1,4 +1,7 @@
 #include "configuration.h"
+#include "BootTimeline.h"
+#include "concurrency/OSThread.h"
+#include <vector>
 #if !MESHTASTIC_EXCLUDE_INPUTBROKER
 #include "input/ExpressLRSFiveWay.h"
 #include "input/InputBroker.h"
@@ -100,6 +103,58 @@
 // TacticalMessageModule requires a screen // Commenting this out as we are enabling for headless
 #include "modules/TacticalMessageModule.h"
 
+// Construct the modules that are only needed on a timer or for rare packets from the main loop, once setup() is done,
+// instead of in setupModules(). That way the radio is up and handling packets sooner after a reset.
+#ifndef MESHTASTIC_LAZY_MODULES
+#define MESHTASTIC_LAZY_MODULES 1
+#endif
+
+struct LazyModule {
+    const char *name;
+    void (*construct)();
+};
+
+/// Constructs the deferred modules one per run, so the other threads get to run in between
+class LazyModuleThread : public concurrency::OSThread
+{
+  public:
+    std::vector<LazyModule> pending;
+
+    LazyModuleThread() : OSThread("LazyModules") {}
+
+  protected:
+    int32_t runOnce() override
+    {
+        if (next < pending.size()) {
+            uint32_t start = millis();
+            pending[next].construct();
+            BootTimeline::span(pending[next].name, start);
+            next++;
+            return 0;
+        }
+        pending.clear();
+        pending.shrink_to_fit();
+        BootTimeline::print();
+        return disable();
+    }
+
+  private:
+    size_t next = 0;
+};
+
+static LazyModuleThread *lazyModuleThread;
+
+static void deferModule(const char *name, void (*construct)())
+{
+#if MESHTASTIC_LAZY_MODULES
+    if (!lazyModuleThread)
+        lazyModuleThread = new LazyModuleThread();
+    lazyModuleThread->pending.push_back({name, construct});
+#else
+    construct();
+#endif
+}
+
 /**
  * Create module instances here.  If you are adding a new module, you must 'new' it here (or somewhere else)
  */
@@ -131,7 +186,7 @@ void setupModules()
         neighborInfoModule = new NeighborInfoModule();
 #endif
 #if !MESHTASTIC_EXCLUDE_DETECTIONSENSOR
-        detectionSensorModule = new DetectionSensorModule();
+        deferModule("DetectionSensor", [] { detectionSensorModule = new DetectionSensorModule(); });
 #endif
 #if !MESHTASTIC_EXCLUDE_ATAK
         atakPluginModule = new AtakPluginModule();
@@ -141,16 +196,16 @@ void setupModules()
         dropzoneModule = new DropzoneModule();
 #endif
 #if !MESHTASTIC_EXCLUDE_GENERIC_THREAD_MODULE
-        new GenericThreadModule();
+        deferModule("GenericThread", [] { new GenericThreadModule(); });
 #endif
         // Note: if the rest of meshtastic doesn't need to explicitly use your module, you do not need to assign the instance
         // to a global variable.
 
 #if !MESHTASTIC_EXCLUDE_REMOTEHARDWARE
-        new RemoteHardwareModule();
+        deferModule("RemoteHardware", [] { new RemoteHardwareModule(); });
 #endif
 #if !MESHTASTIC_EXCLUDE_POWERSTRESS
-        new PowerStressModule();
+        deferModule("PowerStress", [] { new PowerStressModule(); });
 #endif
         // Example: Put your module here
         // new ReplyModule();
@@ -203,10 +258,10 @@ void setupModules()
 // TacticalMessageModule requires a screen // Commenting this out
         tacticalMessageModule = new TacticalMessageModule();
 #if ARCH_PORTDUINO
-        new HostMetricsModule();
+        deferModule("HostMetrics", [] { new HostMetricsModule(); });
 #endif
 #if HAS_TELEMETRY
-        new DeviceTelemetryModule();
+        deferModule("DeviceTelemetry", [] { new DeviceTelemetryModule(); });
 #endif
 #if HAS_SENSOR && !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR
         new EnvironmentTelemetryModule();
@@ -226,7 +281,7 @@ void setupModules()
 #if (defined(ARCH_ESP32) || defined(ARCH_NRF52) || defined(ARCH_RP2040)) && !defined(CONFIG_IDF_TARGET_ESP32S2) &&               \
     !defined(CONFIG_IDF_TARGET_ESP32C3)
 #if !MESHTASTIC_EXCLUDE_SERIAL
-        new SerialModule();
+        deferModule("Serial", [] { new SerialModule(); });
 #endif
 #endif
 #ifdef ARCH_ESP32
@@ -240,7 +295,7 @@ void setupModules()
 #endif
 #if defined(ARCH_ESP32) || defined(ARCH_PORTDUINO)
 #if !MESHTASTIC_EXCLUDE_STOREFORWARD
-        storeForwardModule = new StoreForwardModule();
+        deferModule("StoreForward", [] { storeForwardModule = new StoreForwardModule(); });
 #endif
 #endif
 #if defined(ARCH_ESP32) || defined(ARCH_NRF52) || defined(ARCH_RP2040) || defined(ARCH_PORTDUINO)
@@ -248,7 +303,7 @@ void setupModules()
         externalNotificationModule = new ExternalNotificationModule();
 #endif
 #if !MESHTASTIC_EXCLUDE_RANGETEST && !MESHTASTIC_EXCLUDE_GPS
-        new RangeTestModule();
+        deferModule("RangeTest", [] { new RangeTestModule(); });
 #endif
 #endif
     } else {
@@ -256,7 +311,7 @@ void setupModules()
         adminModule = new AdminModule();
 #endif
 #if HAS_TELEMETRY
-        new DeviceTelemetryModule();
+        deferModule("DeviceTelemetry", [] { new DeviceTelemetryModule(); });
 #endif
 #if !MESHTASTIC_EXCLUDE_TRACEROUTE
         traceRouteModule = new TraceRouteModule();
@@ -29,9 +29,9 @@ NOTE: for debugging only
 void NeighborInfoModule::printNodeDBNeighbors()
 {
     LOG_DEBUG("Our NodeDB contains %d neighbors", neighbors.size());
-    for (size_t i = 0; i < neighbors.size(); i++) {
-        LOG_DEBUG("Node %d: node_id=0x%x, snr=%.2f", i, neighbors[i].node_id, neighbors[i].snr);
-    }
+    int i = 0;
+    neighbors.forEach(
+        [&i](const NeighborTable::Neighbor &n) { LOG_DEBUG("Node %d: node_id=0x%x, snr=%.2f", i++, n.node, n.snr); });
 }
 
 /* Send our initial owner announcement 35 seconds after we start (to give network time to setup) */
@@ -67,15 +67,16 @@ uint32_t NeighborInfoModule::collectNeighborInfo(meshtastic_NeighborInfo *neighb
 
     cleanUpNeighbors();
 
-    for (auto nbr : neighbors) {
-        if ((neighborInfo->neighbors_count < MAX_NUM_NEIGHBORS) && (nbr.node_id != my_node_id)) {
-            neighborInfo->neighbors[neighborInfo->neighbors_count].node_id = nbr.node_id;
+    // The neighbors that we'll keep the longest come first, so those are the ones we send if there are too many
+    neighbors.forEach([&](const NeighborTable::Neighbor &nbr) {
+        if ((neighborInfo->neighbors_count < MAX_NUM_NEIGHBORS) && (nbr.node != my_node_id)) {
+            neighborInfo->neighbors[neighborInfo->neighbors_count].node_id = nbr.node;
             neighborInfo->neighbors[neighborInfo->neighbors_count].snr = nbr.snr;
             // Note: we don't set the last_rx_time and node_broadcast_intervals_secs here, because we don't want to send this over
             // the mesh
             neighborInfo->neighbors_count++;
         }
-    }
+    });
     printNodeDBNeighbors();
     return neighborInfo->neighbors_count;
 }
@@ -85,19 +86,8 @@ uint32_t NeighborInfoModule::collectNeighborInfo(meshtastic_NeighborInfo *neighb
 */
 void NeighborInfoModule::cleanUpNeighbors()
 {
-    uint32_t now = getTime();
-    NodeNum my_node_id = nodeDB->getNodeNum();
-    for (auto it = neighbors.rbegin(); it != neighbors.rend();) {
-        // We will remove a neighbor if we haven't heard from them in twice the broadcast interval
-        // cannot use isWithinTimespanMs() as it->last_rx_time is seconds since 1970
-        if ((now - it->last_rx_time > it->node_broadcast_interval_secs * 2) && (it->node_id != my_node_id)) {
-            LOG_DEBUG("Remove neighbor with node ID 0x%x", it->node_id);
-            it = std::vector<meshtastic_Neighbor>::reverse_iterator(
-                neighbors.erase(std::next(it).base())); // Erase the element and update the iterator
-        } else {
-            ++it;
-        }
-    }
+    // We will remove a neighbor if we haven't heard from them in twice the broadcast interval
+    neighbors.removeExpired(getTime(), nodeDB->getNodeNum());
 }
 
 /* Send neighbor info to the mesh */
@@ -174,44 +164,17 @@ void NeighborInfoModule::updateNeighbors(const meshtastic_MeshPacket &mp, const
     }
 }
 
-meshtastic_Neighbor *NeighborInfoModule::getOrCreateNeighbor(NodeNum originalSender, NodeNum n,
-                                                             uint32_t node_broadcast_interval_secs, float snr)
+NeighborTable::Neighbor *NeighborInfoModule::getOrCreateNeighbor(NodeNum originalSender, NodeNum n,
+                                                                 uint32_t node_broadcast_interval_secs, float snr)
 {
     // our node and the phone are the same node (not neighbors)
     if (n == 0) {
         n = nodeDB->getNodeNum();
     }
-    // look for one in the existing list
-    for (size_t i = 0; i < neighbors.size(); i++) {
-        if (neighbors[i].node_id == n) {
-            // if found, update it
-            neighbors[i].snr = snr;
-            neighbors[i].last_rx_time = getTime();
-            // Only if this is the original sender, the broadcast interval corresponds to it
-            if (originalSender == n && node_broadcast_interval_secs != 0)
-                neighbors[i].node_broadcast_interval_secs = node_broadcast_interval_secs;
-            return &neighbors[i];
-        }
-    }
-    // otherwise, allocate one and assign data to it
-
-    meshtastic_Neighbor new_nbr = meshtastic_Neighbor_init_zero;
-    new_nbr.node_id = n;
-    new_nbr.snr = snr;
-    new_nbr.last_rx_time = getTime();
-    // Only if this is the original sender, the broadcast interval corresponds to it
-    if (originalSender == n && node_broadcast_interval_secs != 0)
-        new_nbr.node_broadcast_interval_secs = node_broadcast_interval_secs;
-    else // Assume the same broadcast interval as us for the neighbor if we don't know it
-        new_nbr.node_broadcast_interval_secs = moduleConfig.neighbor_info.update_interval;
-
-    if (neighbors.size() < MAX_NUM_NEIGHBORS) {
-        neighbors.push_back(new_nbr);
-    } else {
-        // If we have too many neighbors, replace the oldest one
-        LOG_WARN("Neighbor DB is full, replace oldest neighbor");
-        neighbors.erase(neighbors.begin());
-        neighbors.push_back(new_nbr);
-    }
-    return &neighbors.back();
-}
\ No newline at end of file
+    // Only if this is the original sender, the broadcast interval corresponds to it. Otherwise assume the same broadcast
+    // interval as us for a new neighbor.
+    uint32_t interval = originalSender == n ? node_broadcast_interval_secs : 0;
+    return neighbors.update(n, snr, getTime(), interval,
+                            Default::getConfiguredOrDefault(moduleConfig.neighbor_info.update_interval,
+                                                            default_neighbor_info_broadcast_secs));
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "NeighborTable.h"
 #include "ProtobufModule.h"
 #define MAX_NUM_NEIGHBORS 10 // also defined in NeighborInfo protobuf options
 
@@ -10,7 +11,7 @@ class NeighborInfoModule : public ProtobufModule<meshtastic_NeighborInfo>, priva
     CallbackObserver<NeighborInfoModule, const meshtastic::Status *> nodeStatusObserver =
         CallbackObserver<NeighborInfoModule, const meshtastic::Status *>(this, &NeighborInfoModule::handleStatusUpdate);
 
-    std::vector<meshtastic_Neighbor> neighbors;
+    NeighborTable neighbors;
 
   public:
     /*
@@ -21,6 +22,9 @@ class NeighborInfoModule : public ProtobufModule<meshtastic_NeighborInfo>, priva
     /* Reset neighbor info after clearing nodeDB*/
     void resetNeighbors();
 
+    /* The nodes we hear directly, for routing */
+    const NeighborTable &getNeighbors() const { return neighbors; }
+
   protected:
     /*
      * Called to handle a particular incoming message
@@ -43,7 +47,8 @@ class NeighborInfoModule : public ProtobufModule<meshtastic_NeighborInfo>, priva
     meshtastic_NeighborInfo *allocateNeighborInfoPacket();
 
     // Find a neighbor in our DB, create an empty neighbor if missing
-    meshtastic_Neighbor *getOrCreateNeighbor(NodeNum originalSender, NodeNum n, uint32_t node_broadcast_interval_secs, float snr);
+    NeighborTable::Neighbor *getOrCreateNeighbor(NodeNum originalSender, NodeNum n, uint32_t node_broadcast_interval_secs,
+                                                 float snr);
 
     /*
      * Send info on our node's neighbors into the mesh
@@ -60,8 +60,8 @@ int32_t RangeTestModule::runOnce()
                 return (5000);      // Sending first message 5 seconds after initialization.
             } else {
                 LOG_INFO("Init Range Test Module -- Receiver");
-                return disable();
-                // This thread does not need to run as a receiver
+                // As a receiver this thread only writes out the saved packets now and then
+                return moduleConfig.range_test.save ? RANGETEST_FLUSH_MSEC : disable();
             }
         } else {
 
@@ -88,8 +88,8 @@ int32_t RangeTestModule::runOnce()
                     return (senderHeartbeat);
                 }
             } else {
-                return disable();
-                // This thread does not need to run as a receiver
+                rangeTestModuleRadio->flush();
+                return moduleConfig.range_test.save ? RANGETEST_FLUSH_MSEC : disable();
             }
         }
     } else {
@@ -185,117 +185,226 @@ bool RangeTestModuleRadio::appendFile(const meshtastic_MeshPacket &mp)
     auto &p = mp.decoded;
 
     meshtastic_NodeInfoLite *n = nodeDB->getMeshNode(getFrom(&mp));
-    /*
-        LOG_DEBUG("-----------------------------------------");
-        LOG_DEBUG("p.payload.bytes  \"%s\"", p.payload.bytes);
-        LOG_DEBUG("p.payload.size   %d", p.payload.size);
-        LOG_DEBUG("---- Received Packet:");
-        LOG_DEBUG("mp.from          %d", mp.from);
-        LOG_DEBUG("mp.rx_snr        %f", mp.rx_snr);
-        LOG_DEBUG("mp.hop_limit     %d", mp.hop_limit);
-        LOG_DEBUG("---- Node Information of Received Packet (mp.from):");
-        LOG_DEBUG("n->user.long_name         %s", n->user.long_name);
-        LOG_DEBUG("n->user.short_name        %s", n->user.short_name);
-        LOG_DEBUG("n->has_position           %d", n->has_position);
-        LOG_DEBUG("n->position.latitude_i    %d", n->position.latitude_i);
-        LOG_DEBUG("n->position.longitude_i   %d", n->position.longitude_i);
-        LOG_DEBUG("---- Current device location information:");
-        LOG_DEBUG("gpsStatus->getLatitude()     %d", gpsStatus->getLatitude());
-        LOG_DEBUG("gpsStatus->getLongitude()    %d", gpsStatus->getLongitude());
-        LOG_DEBUG("gpsStatus->getHasLock()      %d", gpsStatus->getHasLock());
-        LOG_DEBUG("gpsStatus->getDOP()          %d", gpsStatus->getDOP());
-        LOG_DEBUG("-----------------------------------------");
-    */
-    concurrency::LockGuard g(spiLock);
-    if (!FSBegin()) {
-        LOG_DEBUG("An Error has occurred while mounting the filesystem");
-        return 0;
+    RangeTestRecord &r = buffer[buffered];
+    memset(&r, 0, sizeof(r));
+
+    r.time = getTime();
+    r.from = getFrom(&mp);
+    if (n) {
+        r.senderLatitude = n->position.latitude_i;
+        r.senderLongitude = n->position.longitude_i;
+    }
+    if (gpsStatus->getIsConnected() || config.position.fixed_position) {
+        r.rxLatitude = gpsStatus->getLatitude();
+        r.rxLongitude = gpsStatus->getLongitude();
+        r.rxAltitude = gpsStatus->getAltitude();
+    } else {
+        // When the phone API is in use, the node info will be updated with position
+        meshtastic_NodeInfoLite *us = nodeDB->getMeshNode(nodeDB->getNodeNum());
+        r.rxLatitude = us->position.latitude_i;
+        r.rxLongitude = us->position.longitude_i;
+        r.rxAltitude = us->position.altitude;
     }
+    r.rxSnr = mp.rx_snr;
 
-    if (FSCom.totalBytes() - FSCom.usedBytes() < 51200) {
-        LOG_DEBUG("Filesystem doesn't have enough free space. Aborting write");
-        return 0;
+    if (r.senderLatitude && r.senderLongitude && gpsStatus->getLatitude() && gpsStatus->getLongitude()) {
+        r.distance = GeoCoord::latLongToMeter(r.senderLatitude * 1e-7, r.senderLongitude * 1e-7, gpsStatus->getLatitude() * 1e-7,
+                                              gpsStatus->getLongitude() * 1e-7);
     }
 
-    FSCom.mkdir("/static");
+    r.hopLimit = mp.hop_limit;
+    r.payloadSize = min(p.payload.size, (pb_size_t)RANGETEST_PAYLOAD_LEN);
+    memcpy(r.payload, p.payload.bytes, r.payloadSize);
 
-    // If the file doesn't exist, write the header.
-    if (!FSCom.exists("/static/rangetest.csv")) {
-        //--------- Write to file
-        File fileToWrite = FSCom.open("/static/rangetest.csv", FILE_WRITE);
+    if (++buffered == RANGETEST_BUFFER_RECORDS)
+        flush();
+#endif
 
-        if (!fileToWrite) {
-            LOG_ERROR("There was an error opening the file for writing");
-            return 0;
-        }
+    return 1;
+}
 
-        // Print the CSV header
-        if (fileToWrite.println(
-                "time,from,sender name,sender lat,sender long,rx lat,rx long,rx elevation,rx snr,distance,hop limit,payload")) {
-            LOG_INFO("File was written");
-        } else {
-            LOG_ERROR("File write failed");
-        }
-        fileToWrite.flush();
-        fileToWrite.close();
-    }
+void RangeTestModuleRadio::flush()
+{
+#ifdef ARCH_ESP32
+    if (!buffered)
+        return;
 
-    //--------- Append content to file
-    File fileToAppend = FSCom.open("/static/rangetest.csv", FILE_APPEND);
+    concurrency::LockGuard g(spiLock);
+    if (!FSBegin()) {
+        LOG_DEBUG("An Error has occurred while mounting the filesystem");
+        return;
+    }
 
-    if (!fileToAppend) {
-        LOG_ERROR("There was an error opening the file for appending");
-        return 0;
+    if (FSCom.totalBytes() - FSCom.usedBytes() < 51200) {
+        LOG_DEBUG("Filesystem doesn't have enough free space. Aborting write");
+        buffered = 0;
+        return;
     }
 
-    struct timeval tv;
-    if (!gettimeofday(&tv, NULL)) {
-        long hms = tv.tv_sec % SEC_PER_DAY;
-        hms = (hms + SEC_PER_DAY) % SEC_PER_DAY;
+    FSCom.mkdir("/static");
+#if RANGETEST_BINARY
+    bool written = writeBinaryFile();
+#else
+    bool written = writeCsvFile();
+#endif
+    if (written)
+        LOG_DEBUG("Range test wrote %u packets", buffered);
+    buffered = 0;
+#endif
+}
+
+void RangeTestModuleRadio::printCsvRow(Print &out, const RangeTestRecord &r)
+{
+#ifdef ARCH_ESP32
+    if (r.time) {
+        long hms = r.time % SEC_PER_DAY;
 
         // Tear apart hms into h:m:s
         int hour = hms / SEC_PER_HOUR;
         int min = (hms % SEC_PER_HOUR) / SEC_PER_MIN;
         int sec = (hms % SEC_PER_HOUR) % SEC_PER_MIN; // or hms % SEC_PER_MIN
 
-        fileToAppend.printf("%02d:%02d:%02d,", hour, min, sec); // Time
+        out.printf("%02d:%02d:%02d,", hour, min, sec); // Time
     } else {
-        fileToAppend.printf("??:??:??,"); // Time
+        out.printf("??:??:??,"); // Time
     }
 
-    fileToAppend.printf("%d,", getFrom(&mp));                   // From
-    fileToAppend.printf("%s,", n->user.long_name);              // Long Name
-    fileToAppend.printf("%f,", n->position.latitude_i * 1e-7);  // Sender Lat
-    fileToAppend.printf("%f,", n->position.longitude_i * 1e-7); // Sender Long
-    if (gpsStatus->getIsConnected() || config.position.fixed_position) {
-        fileToAppend.printf("%f,", gpsStatus->getLatitude() * 1e-7);  // RX Lat
-        fileToAppend.printf("%f,", gpsStatus->getLongitude() * 1e-7); // RX Long
-        fileToAppend.printf("%d,", gpsStatus->getAltitude());         // RX Altitude
-    } else {
-        // When the phone API is in use, the node info will be updated with position
-        meshtastic_NodeInfoLite *us = nodeDB->getMeshNode(nodeDB->getNodeNum());
-        fileToAppend.printf("%f,", us->position.latitude_i * 1e-7);  // RX Lat
-        fileToAppend.printf("%f,", us->position.longitude_i * 1e-7); // RX Long
-        fileToAppend.printf("%d,", us->position.altitude);           // RX Altitude
+    // The name is looked up when writing, the binary format doesn't keep it
+    meshtastic_NodeInfoLite *n = nodeDB->getMeshNode(r.from);
+
+    out.printf("%d,", r.from);                     // From
+    out.printf("%s,", n ? n->user.long_name : ""); // Long Name
+    out.printf("%f,", r.senderLatitude * 1e-7);    // Sender Lat
+    out.printf("%f,", r.senderLongitude * 1e-7);   // Sender Long
+    out.printf("%f,", r.rxLatitude * 1e-7);        // RX Lat
+    out.printf("%f,", r.rxLongitude * 1e-7);       // RX Long
+    out.printf("%d,", r.rxAltitude);               // RX Altitude
+    out.printf("%f,", r.rxSnr);                    // RX SNR
+    if (r.distance)
+        out.printf("%f,", r.distance); // Distance in meters
+    else
+        out.printf("0,");
+    out.printf("%d,", r.hopLimit); // Packet Hop Limit
+
+    // TODO: If quotes are found in the payload, it has to be escaped.
+    out.printf("\"%.*s\"\n", r.payloadSize, r.payload);
+#endif
+}
+
+static const char *csvHeader =
+    "time,from,sender name,sender lat,sender long,rx lat,rx long,rx elevation,rx snr,distance,hop limit,payload";
+
+// Must hold spiLock
+bool RangeTestModuleRadio::writeCsvFile()
+{
+#ifdef ARCH_ESP32
+    // If the file doesn't exist, write the header.
+    bool fresh = !FSCom.exists(RANGETEST_CSV_FILE);
+    File f = FSCom.open(RANGETEST_CSV_FILE, fresh ? FILE_WRITE : FILE_APPEND);
+    if (!f) {
+        LOG_ERROR("There was an error opening the file for appending");
+        return false;
     }
+    if (fresh)
+        f.println(csvHeader);
+    for (uint8_t i = 0; i < buffered; i++)
+        printCsvRow(f, buffer[i]);
+    f.close();
+    return true;
+#else
+    return false;
+#endif
+}
 
-    fileToAppend.printf("%f,", mp.rx_snr); // RX SNR
+#if RANGETEST_BINARY
+struct RangeTestFileHeader {
+    char magic[4];
+    uint32_t recordSize;
+    uint32_t count; // Records in use, the rest of the file is preallocated
+};
+static const char rangeTestMagic[4] = {'M', 'T', 'R', 'T'};
 
-    if (n->position.latitude_i && n->position.longitude_i && gpsStatus->getLatitude() && gpsStatus->getLongitude()) {
-        float distance = GeoCoord::latLongToMeter(n->position.latitude_i * 1e-7, n->position.longitude_i * 1e-7,
-                                                  gpsStatus->getLatitude() * 1e-7, gpsStatus->getLongitude() * 1e-7);
-        fileToAppend.printf("%f,", distance); // Distance in meters
+static bool readHeader(File &f, RangeTestFileHeader &h)
+{
+    return f && f.read((uint8_t *)&h, sizeof(h)) == sizeof(h) && memcmp(h.magic, rangeTestMagic, sizeof(h.magic)) == 0 &&
+           h.recordSize == sizeof(RangeTestRecord);
+}
+#endif
+
+// Must hold spiLock
+bool RangeTestModuleRadio::writeBinaryFile()
+{
+#if defined(ARCH_ESP32) && RANGETEST_BINARY
+    RangeTestFileHeader h;
+    File f = FSCom.open(RANGETEST_BIN_FILE, "r+");
+    uint32_t allocated = 0;
+    if (readHeader(f, h)) {
+        allocated = (f.size() - sizeof(h)) / sizeof(RangeTestRecord);
     } else {
-        fileToAppend.printf("0,");
+        if (f)
+            f.close();
+        f = FSCom.open(RANGETEST_BIN_FILE, FILE_O_WRITE);
+        if (!f) {
+            LOG_ERROR("There was an error opening the file for writing");
+            return false;
+        }
+        memcpy(h.magic, rangeTestMagic, sizeof(h.magic));
+        h.recordSize = sizeof(RangeTestRecord);
+        h.count = 0;
+        f.write((const uint8_t *)&h, sizeof(h));
     }
 
-    fileToAppend.printf("%d,", mp.hop_limit); // Packet Hop Limit
+    // Grow the file a chunk of records at a time, so most flushes just overwrite space that is already allocated
+    static_assert(RANGETEST_PREALLOC_RECORDS >= RANGETEST_BUFFER_RECORDS, "a flush must fit in one chunk");
+    if (h.count + buffered > allocated) {
+        RangeTestRecord zero = {};
+        f.seek(sizeof(h) + allocated * sizeof(RangeTestRecord));
+        for (uint32_t i = 0; i < RANGETEST_PREALLOC_RECORDS; i++)
+            f.write((const uint8_t *)&zero, sizeof(zero));
+    }
 
-    // TODO: If quotes are found in the payload, it has to be escaped.
-    fileToAppend.printf("\"%s\"\n", p.payload.bytes);
-    fileToAppend.flush();
-    fileToAppend.close();
+    f.seek(sizeof(h) + h.count * sizeof(RangeTestRecord));
+    f.write((const uint8_t *)buffer, buffered * sizeof(RangeTestRecord));
+    h.count += buffered;
+    f.seek(0);
+    f.write((const uint8_t *)&h, sizeof(h));
+    f.close();
+    return true;
+#else
+    return false;
 #endif
+}
 
-    return 1;
-}
\ No newline at end of file
+void RangeTestModuleRadio::writeCsv(Print &out)
+{
+    flush();
+    out.println(csvHeader);
+#if defined(ARCH_ESP32) && RANGETEST_BINARY
+    // Only hold the lock for a chunk of records at a time, so we don't block the radio while the client downloads
+    RangeTestRecord chunk[RANGETEST_READ_RECORDS];
+    uint32_t offset = 0, count = 1;
+    while (offset < count) {
+        uint32_t n;
+        {
+            concurrency::LockGuard g(spiLock);
+            RangeTestFileHeader h;
+            File f = FSCom.open(RANGETEST_BIN_FILE, FILE_O_READ);
+            if (!readHeader(f, h)) {
+                if (f)
+                    f.close();
+                return;
+            }
+            count = h.count;
+            n = min(count - offset, (uint32_t)RANGETEST_READ_RECORDS);
+            f.seek(sizeof(h) + offset * sizeof(RangeTestRecord));
+            n = f.read((uint8_t *)chunk, n * sizeof(RangeTestRecord)) / sizeof(RangeTestRecord);
+            f.close();
+        }
+        if (!n)
+            return;
+        for (uint32_t i = 0; i < n; i++)
+            printCsvRow(out, chunk[i]);
+        offset += n;
+    }
+#endif
+}
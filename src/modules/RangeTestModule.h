@@ -3,9 +3,41 @@
 #include "SinglePortModule.h"
 #include "concurrency/OSThread.h"
 #include "configuration.h"
+#include "sleep.h"
 #include <Arduino.h>
 #include <functional>
 
+// Keep the received range test packets in a compact binary file, converted to CSV when downloaded from the web server
+#ifndef RANGETEST_BINARY
+#define RANGETEST_BINARY 0
+#endif
+
+// Received packets are buffered in RAM and written to the filesystem in one go when this many are buffered, every
+// RANGETEST_FLUSH_MSEC and before we shut down or reboot
+#define RANGETEST_BUFFER_RECORDS 16
+#define RANGETEST_FLUSH_MSEC (60 * 1000)
+// The binary file grows this many (zeroed) records at a time
+#define RANGETEST_PREALLOC_RECORDS 64
+// Records read from the binary file per spiLock when converting it to CSV, these are on the stack of the web server
+#define RANGETEST_READ_RECORDS 4
+// Whole payloads are kept, as the CSV always had them
+#define RANGETEST_PAYLOAD_LEN meshtastic_Constants_DATA_PAYLOAD_LEN
+
+#define RANGETEST_CSV_FILE "/static/rangetest.csv"
+#define RANGETEST_BIN_FILE "/static/rangetest.bin"
+
+struct RangeTestRecord {
+    uint32_t time; // Unix time, 0 if unknown
+    uint32_t from;
+    int32_t senderLatitude, senderLongitude;
+    int32_t rxLatitude, rxLongitude, rxAltitude;
+    float rxSnr;
+    float distance; // In meters, 0 if unknown
+    uint8_t hopLimit;
+    uint8_t payloadSize;
+    char payload[RANGETEST_PAYLOAD_LEN];
+};
+
 class RangeTestModule : private concurrency::OSThread
 {
     bool firstTime = 1;
@@ -28,10 +60,17 @@ class RangeTestModuleRadio : public SinglePortModule
 {
     uint32_t lastRxID = 0;
 
+#ifdef ARCH_ESP32 // The only platform which saves range test data
+    RangeTestRecord buffer[RANGETEST_BUFFER_RECORDS];
+    uint8_t buffered = 0;
+#endif
+
   public:
     RangeTestModuleRadio() : SinglePortModule("RangeTestModuleRadio", meshtastic_PortNum_RANGE_TEST_APP)
     {
         loopbackOk = true; // Allow locally generated messages to loop back to the client
+        notifyDeepSleepObserver.observe(&notifyDeepSleep);
+        notifyRebootObserver.observe(&notifyReboot);
     }
 
     /**
@@ -40,10 +79,16 @@ class RangeTestModuleRadio : public SinglePortModule
     void sendPayload(NodeNum dest = NODENUM_BROADCAST, bool wantReplies = false);
 
     /**
-     * Append range test data to the file on the Filesystem
+     * Append range test data to the file on the Filesystem, buffered until the next flush()
      */
     bool appendFile(const meshtastic_MeshPacket &mp);
 
+    /// Write the buffered range test data to the Filesystem
+    void flush();
+
+    /// Write everything saved so far as CSV, e.g. to a web server response
+    void writeCsv(Print &out);
+
   protected:
     /** Called to handle a particular incoming message
 
@@ -51,6 +96,21 @@ class RangeTestModuleRadio : public SinglePortModule
     it
     */
     virtual ProcessMessage handleReceived(const meshtastic_MeshPacket &mp) override;
+
+  private:
+    static void printCsvRow(Print &out, const RangeTestRecord &r);
+    bool writeCsvFile();
+    bool writeBinaryFile();
+
+    int onShutdown(void *unused)
+    {
+        flush();
+        return 0;
+    }
+    CallbackObserver<RangeTestModuleRadio, void *> notifyDeepSleepObserver =
+        CallbackObserver<RangeTestModuleRadio, void *>(this, &RangeTestModuleRadio::onShutdown);
+    CallbackObserver<RangeTestModuleRadio, void *> notifyRebootObserver =
+        CallbackObserver<RangeTestModuleRadio, void *>(this, &RangeTestModuleRadio::onShutdown);
 };
 
 extern RangeTestModuleRadio *rangeTestModuleRadio;
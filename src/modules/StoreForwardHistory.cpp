@@ -0,0 +1,244 @@
+#include "StoreForwardHistory.h"
+#include "FSCommon.h"
+#include "SPILock.h"
+
+#include <algorithm>
+
+#if STORE_FORWARD_PERSIST && defined(FSCom)
+#define STORE_FORWARD_HISTORY_DIR "/storeforward"
+#define STORE_FORWARD_HISTORY_TMP "/storeforward/history.tmp"
+
+// The file is a header followed by raw records, a file written by a build with another record layout is discarded
+static const char historyMagic[4] = {'M', 'T', 'S', 'F'};
+static const uint32_t historyHeaderLen = sizeof(historyMagic) + sizeof(uint32_t);
+#endif
+
+StoreForwardHistory::~StoreForwardHistory()
+{
+    free(records);
+    free(nextSameTo);
+}
+
+bool StoreForwardHistory::begin(uint32_t _capacity)
+{
+    capacity = _capacity;
+#if defined(ARCH_ESP32)
+    records = static_cast<PacketHistoryStruct *>(ps_calloc(capacity, sizeof(PacketHistoryStruct)));
+    nextSameTo = static_cast<uint32_t *>(ps_calloc(capacity, sizeof(uint32_t)));
+#else
+    records = static_cast<PacketHistoryStruct *>(calloc(capacity, sizeof(PacketHistoryStruct)));
+    nextSameTo = static_cast<uint32_t *>(calloc(capacity, sizeof(uint32_t)));
+#endif
+    if (!capacity || !records || !nextSameTo) {
+        LOG_ERROR("S&F - Unable to allocate history for %u records", capacity);
+        capacity = 0;
+        return false;
+    }
+#if STORE_FORWARD_PERSIST && defined(FSCom)
+    load();
+#endif
+    return true;
+}
+
+void StoreForwardHistory::add(const PacketHistoryStruct &record)
+{
+    if (!capacity)
+        return;
+    if (size() == capacity && firstSeq == 0)
+        LOG_WARN("S&F - History full, start to drop the oldest records");
+    append(record);
+#if STORE_FORWARD_PERSIST && defined(FSCom)
+    persist(record);
+#endif
+}
+
+void StoreForwardHistory::append(const PacketHistoryStruct &record)
+{
+    if (size() == capacity)
+        evictOldest();
+
+    if (nextSeq > firstSeq && record.time < at(nextSeq - 1).time)
+        orderedFrom = nextSeq;
+
+    uint32_t seq = nextSeq++;
+    records[slot(seq)] = record;
+    nextSameTo[slot(seq)] = NONE;
+
+    auto it = chains.find(record.to);
+    if (it != chains.end()) {
+        nextSameTo[slot(it->second.tail)] = seq;
+        it->second.tail = seq;
+    } else {
+        chains.emplace(record.to, Chain{seq, seq});
+    }
+}
+
+void StoreForwardHistory::evictOldest()
+{
+    uint32_t seq = firstSeq++;
+    auto it = chains.find(at(seq).to);
+    // The oldest record is always the head of its chain
+    it->second.head = nextSameTo[slot(seq)];
+    if (it->second.head == NONE)
+        chains.erase(it);
+}
+
+uint32_t StoreForwardHistory::firstAfter(uint32_t since) const
+{
+    // The times before orderedFrom may go back and forth, so those are scanned
+    uint32_t lo = std::max(firstSeq, orderedFrom), hi = nextSeq;
+    for (uint32_t s = firstSeq; s < lo; s++)
+        if (at(s).time > since)
+            return s;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (at(mid).time > since)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+uint32_t StoreForwardHistory::firstInChain(NodeNum to, uint32_t seq, uint32_t hint) const
+{
+    uint32_t s;
+    if (hint >= firstSeq && hint < nextSeq && hint <= seq && at(hint).to == to) {
+        s = hint;
+    } else if (to == NODENUM_BROADCAST) {
+        // Broadcasts are most of the log, so one is never far
+        for (s = seq; s < nextSeq; s++)
+            if (at(s).to == to)
+                return s;
+        return NONE;
+    } else {
+        auto it = chains.find(to);
+        if (it == chains.end())
+            return NONE;
+        s = it->second.head;
+    }
+    while (s != NONE && s < seq)
+        s = nextSameTo[slot(s)];
+    return s;
+}
+
+const PacketHistoryStruct *StoreForwardHistory::next(NodeNum dest, uint32_t since, StoreForwardCursor &cursor)
+{
+    if (!capacity)
+        return nullptr;
+
+    uint32_t start = std::max({cursor.next, firstSeq, firstAfter(since)});
+    uint32_t b = firstInChain(NODENUM_BROADCAST, start, cursor.broadcast);
+    uint32_t d = dest == NODENUM_BROADCAST ? NONE : firstInChain(dest, start, cursor.direct);
+
+    // Merge the two chains in order
+    while (b != NONE || d != NONE) {
+        uint32_t seq = std::min(b, d);
+        if (seq == b) {
+            cursor.broadcast = b;
+            b = nextSameTo[slot(b)];
+        } else {
+            cursor.direct = d;
+            d = nextSameTo[slot(d)];
+        }
+        const PacketHistoryStruct &r = at(seq);
+        // Client is only interested in packets not from itself
+        if (r.from != dest && r.time > since) {
+            cursor.next = seq + 1;
+            return &r;
+        }
+    }
+    cursor.next = nextSeq;
+    return nullptr;
+}
+
+uint32_t StoreForwardHistory::count(NodeNum dest, uint32_t since, StoreForwardCursor cursor, uint32_t max)
+{
+    uint32_t n = 0;
+    while (n < max && next(dest, since, cursor))
+        n++;
+    return n;
+}
+
+#if STORE_FORWARD_PERSIST && defined(FSCom)
+void StoreForwardHistory::load()
+{
+    concurrency::LockGuard g(spiLock);
+    auto f = FSCom.open(STORE_FORWARD_HISTORY_FILE, FILE_O_READ);
+    if (!f)
+        return;
+
+    char magic[sizeof(historyMagic)];
+    uint32_t recordSize = 0;
+    if (f.read((uint8_t *)magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, historyMagic, sizeof(magic)) != 0 ||
+        f.read((uint8_t *)&recordSize, sizeof(recordSize)) != sizeof(recordSize) || recordSize != sizeof(PacketHistoryStruct)) {
+        LOG_WARN("S&F - Discard history file of another format");
+        f.close();
+        FSCom.remove(STORE_FORWARD_HISTORY_FILE);
+        return;
+    }
+
+    // Only the newest records fit in the ring
+    persisted = (f.size() - historyHeaderLen) / sizeof(PacketHistoryStruct);
+    uint32_t skip = persisted > capacity ? persisted - capacity : 0;
+    f.seek(historyHeaderLen + skip * sizeof(PacketHistoryStruct));
+
+    PacketHistoryStruct r;
+    while (f.read((uint8_t *)&r, sizeof(r)) == sizeof(r))
+        append(r);
+    f.close();
+    LOG_INFO("S&F - Loaded %u of %u records from %s", size(), persisted, STORE_FORWARD_HISTORY_FILE);
+}
+
+void StoreForwardHistory::persist(const PacketHistoryStruct &record)
+{
+    // The ring already holds the record, so a compacted file has it too
+    if (persisted >= 2 * capacity) {
+        compact();
+        return;
+    }
+
+    concurrency::LockGuard g(spiLock);
+    bool fresh = !FSCom.exists(STORE_FORWARD_HISTORY_FILE);
+    if (fresh)
+        FSCom.mkdir(STORE_FORWARD_HISTORY_DIR);
+    auto f = FSCom.open(STORE_FORWARD_HISTORY_FILE, FILE_O_APPEND);
+    if (!f) {
+        LOG_ERROR("S&F - Unable to open %s", STORE_FORWARD_HISTORY_FILE);
+        return;
+    }
+    if (fresh) {
+        uint32_t recordSize = sizeof(PacketHistoryStruct);
+        f.write((const uint8_t *)historyMagic, sizeof(historyMagic));
+        f.write((const uint8_t *)&recordSize, sizeof(recordSize));
+        persisted = 0;
+    }
+    if (f.write((const uint8_t *)&record, sizeof(record)) == sizeof(record))
+        persisted++;
+    f.close();
+}
+
+void StoreForwardHistory::compact()
+{
+    {
+        concurrency::LockGuard g(spiLock);
+        auto f = FSCom.open(STORE_FORWARD_HISTORY_TMP, FILE_O_WRITE);
+        if (!f) {
+            LOG_ERROR("S&F - Unable to open %s", STORE_FORWARD_HISTORY_TMP);
+            return;
+        }
+        uint32_t recordSize = sizeof(PacketHistoryStruct);
+        f.write((const uint8_t *)historyMagic, sizeof(historyMagic));
+        f.write((const uint8_t *)&recordSize, sizeof(recordSize));
+        for (uint32_t seq = firstSeq; seq < nextSeq; seq++)
+            f.write((const uint8_t *)&at(seq), sizeof(PacketHistoryStruct));
+        f.close();
+    }
+    // renameFile() takes the lock itself
+    if (renameFile(STORE_FORWARD_HISTORY_TMP, STORE_FORWARD_HISTORY_FILE)) {
+        persisted = size();
+        LOG_INFO("S&F - Compacted %s to %u records", STORE_FORWARD_HISTORY_FILE, persisted);
+    }
+}
+#endif
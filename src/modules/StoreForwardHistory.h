@@ -0,0 +1,100 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "configuration.h"
+#include <unordered_map>
+
+/// Keep the history in an append-only file too, so it survives a restart. Off on MCUs, where the file would be larger than
+/// the flash filesystem.
+#ifndef STORE_FORWARD_PERSIST
+#ifdef ARCH_PORTDUINO
+#define STORE_FORWARD_PERSIST 1
+#else
+#define STORE_FORWARD_PERSIST 0
+#endif
+#endif
+
+#define STORE_FORWARD_HISTORY_FILE "/storeforward/history.dat"
+
+struct PacketHistoryStruct {
+    uint32_t time;
+    uint32_t to;
+    uint32_t from;
+    uint32_t id;
+    uint8_t channel;
+    uint32_t reply_id;
+    bool emoji;
+    uint8_t payload[meshtastic_Constants_DATA_PAYLOAD_LEN];
+    pb_size_t payload_size;
+};
+
+/// Where a client is in the history: the next record to look at, and the last records it visited in the broadcast chain and
+/// in the chain of its direct messages
+struct StoreForwardCursor {
+    uint32_t next = 0;
+    uint32_t broadcast = UINT32_MAX;
+    uint32_t direct = UINT32_MAX;
+};
+
+/**
+ * Store & Forward message log. Records are numbered by a sequence number that keeps counting up and live in a ring of
+ * fixed capacity, so the oldest record is dropped when it is full and the cursors of the clients stay valid.
+ *
+ * The records to each destination are chained in order, so a client only visits broadcasts and the messages to itself:
+ * a request costs O(results) plus a binary search for the start of the time window, not a scan of the whole log. Only the
+ * records from before the clock last went back (RTC step, time from the mesh, a reloaded file) are scanned one by one.
+ */
+class StoreForwardHistory
+{
+  public:
+    ~StoreForwardHistory();
+
+    /// Allocate room for 'capacity' records (in PSRAM where there is some) and load what was persisted
+    bool begin(uint32_t capacity);
+
+    void add(const PacketHistoryStruct &record);
+
+    /// Next record newer than 'since' for 'dest' (broadcasts and direct messages not sent by 'dest'), advancing the cursor
+    const PacketHistoryStruct *next(NodeNum dest, uint32_t since, StoreForwardCursor &cursor);
+
+    /// Number of records next() would return, counting no further than 'max'
+    uint32_t count(NodeNum dest, uint32_t since, StoreForwardCursor cursor, uint32_t max = UINT32_MAX);
+
+    uint32_t size() const { return nextSeq - firstSeq; }
+    uint32_t getCapacity() const { return capacity; }
+
+  private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Chain {
+        uint32_t head; // Oldest record to this destination that is still in the ring
+        uint32_t tail; // Newest one
+    };
+
+    PacketHistoryStruct *records = nullptr;
+    uint32_t *nextSameTo = nullptr; // Sequence number of the next record with the same 'to', or NONE
+    uint32_t capacity = 0;
+    uint32_t firstSeq = 0, nextSeq = 0;
+    uint32_t orderedFrom = 0; // From this sequence number on, record times never decrease
+    std::unordered_map<NodeNum, Chain> chains;
+
+    uint32_t slot(uint32_t seq) const { return seq % capacity; }
+    const PacketHistoryStruct &at(uint32_t seq) const { return records[slot(seq)]; }
+
+    void append(const PacketHistoryStruct &record);
+    void evictOldest();
+
+    /// First sequence number of a record with a time after 'since'
+    uint32_t firstAfter(uint32_t since) const;
+
+    /// First record to 'to' at or after 'seq', walking its chain from 'hint' (a record visited before) if that is still valid
+    uint32_t firstInChain(NodeNum to, uint32_t seq, uint32_t hint) const;
+
+#if STORE_FORWARD_PERSIST
+    uint32_t persisted = 0; // Records in the file, it is rewritten with just the ring when this reaches twice the capacity
+
+    void load();
+    void persist(const PacketHistoryStruct &record);
+    void compact();
+#endif
+};
@@ -35,16 +35,12 @@ int32_t StoreForwardModule::runOnce()
 #if defined(ARCH_ESP32) || defined(ARCH_PORTDUINO)
     if (moduleConfig.store_forward.enabled && is_server) {
         // Send out the message queue.
-        if (this->busy) {
-            // Only send packets if the channel is less than 25% utilized and until historyReturnMax
-            if (airTime->isTxAllowedChannelUtil(true) && this->requestCount < this->historyReturnMax) {
-                if (!storeForwardModule->sendPayload(this->busyTo, this->last_time)) {
-                    this->requestCount = 0;
-                    this->busy = false;
-                }
-            }
-        } else if (this->heartbeat && (!Throttle::isWithinTimespanMs(lastHeartbeat, heartbeatInterval * 1000)) &&
-                   airTime->isTxAllowedChannelUtil(true)) {
+        for (auto &s : sessions) {
+            if (s.to)
+                return replayBurst();
+        }
+        if (this->heartbeat && (!Throttle::isWithinTimespanMs(lastHeartbeat, heartbeatInterval * 1000)) &&
+            airTime->isTxAllowedChannelUtil(true)) {
             lastHeartbeat = millis();
             LOG_INFO("Send heartbeat");
             meshtastic_StoreAndForward sf = meshtastic_StoreAndForward_init_zero;
@@ -79,12 +75,7 @@ void StoreForwardModule::populatePSRAM()
     uint32_t numberOfPackets =
         (this->records ? this->records : (((memGet.getFreePsram() / 4) * 3) / sizeof(PacketHistoryStruct)));
     this->records = numberOfPackets;
-#if defined(ARCH_ESP32)
-    this->packetHistory = static_cast<PacketHistoryStruct *>(ps_calloc(numberOfPackets, sizeof(PacketHistoryStruct)));
-#elif defined(ARCH_PORTDUINO)
-    this->packetHistory = static_cast<PacketHistoryStruct *>(calloc(numberOfPackets, sizeof(PacketHistoryStruct)));
-
-#endif
+    this->history.begin(numberOfPackets);
 
     LOG_DEBUG("After PSRAM init: heap %d/%d PSRAM %d/%d", memGet.getFreeHeap(), memGet.getHeapSize(), memGet.getFreePsram(),
               memGet.getPsramSize());
@@ -99,16 +90,28 @@ void StoreForwardModule::populatePSRAM()
  */
 void StoreForwardModule::historySend(uint32_t secAgo, uint32_t to)
 {
-    this->last_time = getTime() < secAgo ? 0 : getTime() - secAgo;
-    uint32_t queueSize = getNumAvailablePackets(to, last_time);
-    if (queueSize > this->historyReturnMax)
-        queueSize = this->historyReturnMax;
-
-    if (queueSize) {
+    uint32_t since = getTime() < secAgo ? 0 : getTime() - secAgo;
+    uint32_t queueSize = getNumAvailablePackets(to, since);
+
+    // Let a client that comes back from a dead zone catch up faster if the channel has room for it
+    uint32_t returnMax = this->historyReturnMax;
+    if (!moduleConfig.store_forward.history_return_max &&
+        airTime->channelUtilizationPercent() < airTime->getPoliteChannelUtilPercent() / 2)
+        returnMax *= STORE_FORWARD_CATCHUP_FACTOR;
+    if (queueSize > returnMax)
+        queueSize = returnMax;
+
+    ReplaySession *session = findSession(to);
+    if (!session)
+        session = findSession(0);
+    if (queueSize && session) {
         LOG_INFO("S&F - Send %u message(s)", queueSize);
-        this->busy = true; // runOnce() will pickup the next steps once busy = true.
-        this->busyTo = to;
+        // runOnce() will pickup the next steps once there is a session.
+        session->to = to;
+        session->since = since;
+        session->remaining = queueSize;
     } else {
+        queueSize = 0;
         LOG_INFO("S&F - No history");
     }
     meshtastic_StoreAndForward sf = meshtastic_StoreAndForward_init_zero;
@@ -116,7 +119,7 @@ void StoreForwardModule::historySend(uint32_t secAgo, uint32_t to)
     sf.which_variant = meshtastic_StoreAndForward_history_tag;
     sf.variant.history.history_messages = queueSize;
     sf.variant.history.window = secAgo * 1000;
-    sf.variant.history.last_request = lastRequest[to];
+    sf.variant.history.last_request = lastRequest[to].next;
     storeForwardModule->sendMessage(to, sf);
     setIntervalFromNow(this->packetTimeMax); // Delay start of sending payloads
 }
@@ -130,20 +133,9 @@ void StoreForwardModule::historySend(uint32_t secAgo, uint32_t to)
  */
 uint32_t StoreForwardModule::getNumAvailablePackets(NodeNum dest, uint32_t last_time)
 {
-    uint32_t count = 0;
-    if (lastRequest.find(dest) == lastRequest.end()) {
-        lastRequest.emplace(dest, 0);
-    }
-    for (uint32_t i = lastRequest[dest]; i < this->packetHistoryTotalCount; i++) {
-        if (this->packetHistory[i].time && (this->packetHistory[i].time > last_time)) {
-            // Client is only interested in packets not from itself and only in broadcast packets or packets towards it.
-            if (this->packetHistory[i].from != dest &&
-                (this->packetHistory[i].to == NODENUM_BROADCAST || this->packetHistory[i].to == dest)) {
-                count++;
-            }
-        }
-    }
-    return count;
+    // Callers only need to know up to what they may return, so don't walk further than that
+    uint32_t limit = max(this->historyReturnMax * STORE_FORWARD_CATCHUP_FACTOR, (uint32_t)1);
+    return history.count(dest, last_time, lastRequest[dest], limit);
 }
 
 /**
@@ -154,25 +146,8 @@ uint32_t StoreForwardModule::getNumAvailablePackets(NodeNum dest, uint32_t last_
 meshtastic_MeshPacket *StoreForwardModule::getForPhone()
 {
     if (moduleConfig.store_forward.enabled && is_server) {
-        NodeNum to = nodeDB->getNodeNum();
-        if (!this->busy) {
-            // Get number of packets we're going to send in this loop
-            uint32_t histSize = getNumAvailablePackets(to, 0); // No time limit
-            if (histSize) {
-                this->busy = true;
-                this->busyTo = to;
-            } else {
-                return nullptr;
-            }
-        }
-
-        // We're busy with sending to us until no payload is available anymore
-        if (this->busy && this->busyTo == to) {
-            meshtastic_MeshPacket *p = preparePayload(to, 0, true); // No time limit
-            if (!p)                                                 // No more messages to send
-                this->busy = false;
-            return p;
-        }
+        // Our own cursor is separate from the ones of the clients, so no need to wait for them
+        return preparePayload(nodeDB->getNodeNum(), 0, true); // No time limit
     }
     return nullptr;
 }
@@ -186,25 +161,18 @@ void StoreForwardModule::historyAdd(const meshtastic_MeshPacket &mp)
 {
     const auto &p = mp.decoded;
 
-    if (this->packetHistoryTotalCount == this->records) {
-        LOG_WARN("S&F - PSRAM Full. Starting overwrite");
-        this->packetHistoryTotalCount = 0;
-        for (auto &i : lastRequest) {
-            i.second = 0; // Clear the last request index for each client device
-        }
-    }
-
-    this->packetHistory[this->packetHistoryTotalCount].time = getTime();
-    this->packetHistory[this->packetHistoryTotalCount].to = mp.to;
-    this->packetHistory[this->packetHistoryTotalCount].channel = mp.channel;
-    this->packetHistory[this->packetHistoryTotalCount].from = getFrom(&mp);
-    this->packetHistory[this->packetHistoryTotalCount].id = mp.id;
-    this->packetHistory[this->packetHistoryTotalCount].reply_id = p.reply_id;
-    this->packetHistory[this->packetHistoryTotalCount].emoji = (bool)p.emoji;
-    this->packetHistory[this->packetHistoryTotalCount].payload_size = p.payload.size;
-    memcpy(this->packetHistory[this->packetHistoryTotalCount].payload, p.payload.bytes, meshtastic_Constants_DATA_PAYLOAD_LEN);
-
-    this->packetHistoryTotalCount++;
+    PacketHistoryStruct record = {};
+    record.time = getTime();
+    record.to = mp.to;
+    record.channel = mp.channel;
+    record.from = getFrom(&mp);
+    record.id = mp.id;
+    record.reply_id = p.reply_id;
+    record.emoji = (bool)p.emoji;
+    record.payload_size = p.payload.size;
+    memcpy(record.payload, p.payload.bytes, p.payload.size);
+
+    this->history.add(record);
 }
 
 /**
@@ -220,12 +188,73 @@ bool StoreForwardModule::sendPayload(NodeNum dest, uint32_t last_time)
     if (p) {
         LOG_INFO("Send S&F Payload");
         service->sendToMesh(p);
-        this->requestCount++;
         return true;
     }
     return false;
 }
 
+/**
+ * Sends the next burst of history packets, taking turns between the clients that asked for it.
+ *
+ * The burst is sized to the headroom left under the polite channel utilization, and spaced so the replay alone doesn't use
+ * more than that headroom. It never takes more than half of the free TX queue or the low priority duty cycle budget, so a
+ * client catching up can't crowd out other traffic.
+ *
+ * @return The number of ms until the next burst.
+ */
+int32_t StoreForwardModule::replayBurst()
+{
+    float headroom = airTime->getPoliteChannelUtilPercent() - airTime->channelUtilizationPercent();
+    uint32_t queueFree = router->getQueueStatus().free;
+    if (headroom <= 0 || !queueFree)
+        return this->packetTimeMax;
+
+    // Assume full size frames, history texts are usually not far from that once encoded
+    uint32_t frameMsec = max(router->getPacketTime(meshtastic_Constants_DATA_PAYLOAD_LEN + sizeof(PacketHeader)), (uint32_t)1);
+    // Channel utilization is measured over a minute
+    uint32_t burst = headroom * MS_IN_MINUTE / 100 / frameMsec;
+    burst = min(burst, queueFree / 2);
+    burst = max(min(burst, (uint32_t)STORE_FORWARD_MAX_BURST), (uint32_t)1);
+
+    uint32_t sent = 0;
+    for (uint8_t tries = 0; sent < burst && tries < STORE_FORWARD_MAX_SESSIONS;) {
+        if (!airTime->isTxAllowedBudget(frameMsec, true))
+            break;
+        ReplaySession &s = sessions[nextSession];
+        nextSession = (nextSession + 1) % STORE_FORWARD_MAX_SESSIONS;
+        if (!s.to) {
+            tries++;
+            continue;
+        }
+        if (s.remaining && sendPayload(s.to, s.since)) {
+            s.remaining--;
+            sent++;
+            tries = 0;
+        } else {
+            s = ReplaySession(); // Done with this client
+        }
+    }
+
+    if (!sent)
+        return this->packetTimeMax;
+    LOG_DEBUG("S&F - Sent a burst of %u, ch. util %.1f%%", sent, airTime->channelUtilizationPercent());
+    return sent * frameMsec * 100 / headroom;
+}
+
+StoreForwardModule::ReplaySession *StoreForwardModule::findSession(NodeNum to)
+{
+    for (auto &s : sessions) {
+        if (s.to == to)
+            return &s;
+    }
+    return nullptr;
+}
+
+bool StoreForwardModule::isBusy()
+{
+    return !findSession(0);
+}
+
 /**
  * Prepares a payload to be sent to a specified destination node from the S&F packet history.
  *
@@ -235,54 +264,64 @@ bool StoreForwardModule::sendPayload(NodeNum dest, uint32_t last_time)
  */
 meshtastic_MeshPacket *StoreForwardModule::preparePayload(NodeNum dest, uint32_t last_time, bool local)
 {
-    for (uint32_t i = lastRequest[dest]; i < this->packetHistoryTotalCount; i++) {
-        if (this->packetHistory[i].time && (this->packetHistory[i].time > last_time)) {
-            /*  Copy the messages that were received by the server in the last msAgo
-                to the packetHistoryTXQueue structure.
-                Client not interested in packets from itself and only in broadcast packets or packets towards it. */
-            if (this->packetHistory[i].from != dest &&
-                (this->packetHistory[i].to == NODENUM_BROADCAST || this->packetHistory[i].to == dest)) {
-
-                meshtastic_MeshPacket *p = allocDataPacket();
-
-                p->to = local ? this->packetHistory[i].to : dest; // PhoneAPI can handle original `to`
-                p->from = this->packetHistory[i].from;
-                p->id = this->packetHistory[i].id;
-                p->channel = this->packetHistory[i].channel;
-                p->decoded.reply_id = this->packetHistory[i].reply_id;
-                p->rx_time = this->packetHistory[i].time;
-                p->decoded.emoji = (uint32_t)this->packetHistory[i].emoji;
-
-                // Let's assume that if the server received the S&F request that the client is in range.
-                //   TODO: Make this configurable.
-                p->want_ack = false;
-
-                if (local) { // PhoneAPI gets normal TEXT_MESSAGE_APP
-                    p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
-                    memcpy(p->decoded.payload.bytes, this->packetHistory[i].payload, this->packetHistory[i].payload_size);
-                    p->decoded.payload.size = this->packetHistory[i].payload_size;
-                } else {
-                    meshtastic_StoreAndForward sf = meshtastic_StoreAndForward_init_zero;
-                    sf.which_variant = meshtastic_StoreAndForward_text_tag;
-                    sf.variant.text.size = this->packetHistory[i].payload_size;
-                    memcpy(sf.variant.text.bytes, this->packetHistory[i].payload, this->packetHistory[i].payload_size);
-                    if (this->packetHistory[i].to == NODENUM_BROADCAST) {
-                        sf.rr = meshtastic_StoreAndForward_RequestResponse_ROUTER_TEXT_BROADCAST;
-                    } else {
-                        sf.rr = meshtastic_StoreAndForward_RequestResponse_ROUTER_TEXT_DIRECT;
-                    }
-
-                    p->decoded.payload.size = pb_encode_to_bytes(p->decoded.payload.bytes, sizeof(p->decoded.payload.bytes),
-                                                                 &meshtastic_StoreAndForward_msg, &sf);
-                }
+    /*  Copy the next message that was received by the server in the last msAgo
+        Client not interested in packets from itself and only in broadcast packets or packets towards it. */
+    const PacketHistoryStruct *record = this->history.next(dest, last_time, lastRequest[dest]);
+    if (!record)
+        return nullptr;
+
+    meshtastic_MeshPacket *p = allocDataPacket();
+
+    p->to = local ? record->to : dest; // PhoneAPI can handle original `to`
+    p->from = record->from;
+    p->id = record->id;
+    p->channel = record->channel;
+    p->decoded.reply_id = record->reply_id;
+    p->rx_time = record->time;
+    p->decoded.emoji = (uint32_t)record->emoji;
 
-                lastRequest[dest] = i + 1; // Update the last request index for the client device
+    // Let's assume that if the server received the S&F request that the client is in range.
+    //   TODO: Make this configurable.
+    p->want_ack = false;
 
-                return p;
-            }
+    if (local) { // PhoneAPI gets normal TEXT_MESSAGE_APP
+        p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+        memcpy(p->decoded.payload.bytes, record->payload, record->payload_size);
+        p->decoded.payload.size = record->payload_size;
+    } else {
+        meshtastic_StoreAndForward sf = meshtastic_StoreAndForward_init_zero;
+        sf.which_variant = meshtastic_StoreAndForward_text_tag;
+        sf.variant.text.size = record->payload_size;
+        memcpy(sf.variant.text.bytes, record->payload, record->payload_size);
+#if STORE_FORWARD_PACK_TEXT
+        // Append the texts that follow while they are from the same sender to the same destination, leaving room for the
+        // StoreAndForward encoding around them
+        StoreForwardCursor peek = lastRequest[dest];
+        const PacketHistoryStruct *more;
+        bool packed = false;
+        while (!record->reply_id && !record->emoji && (more = this->history.next(dest, last_time, peek)) &&
+               more->from == record->from && more->to == record->to && more->channel == record->channel && !more->reply_id &&
+               !more->emoji && sf.variant.text.size + 1 + more->payload_size <= meshtastic_Constants_DATA_PAYLOAD_LEN - 8) {
+            sf.variant.text.bytes[sf.variant.text.size++] = '\n';
+            memcpy(sf.variant.text.bytes + sf.variant.text.size, more->payload, more->payload_size);
+            sf.variant.text.size += more->payload_size;
+            lastRequest[dest] = peek;
+            packed = true;
         }
+        if (packed)
+            p->id = generatePacketId();
+#endif
+        if (record->to == NODENUM_BROADCAST) {
+            sf.rr = meshtastic_StoreAndForward_RequestResponse_ROUTER_TEXT_BROADCAST;
+        } else {
+            sf.rr = meshtastic_StoreAndForward_RequestResponse_ROUTER_TEXT_DIRECT;
+        }
+
+        p->decoded.payload.size =
+            pb_encode_to_bytes(p->decoded.payload.bytes, sizeof(p->decoded.payload.bytes), &meshtastic_StoreAndForward_msg, &sf);
     }
-    return nullptr;
+
+    return p;
 }
 
 /**
@@ -336,7 +375,7 @@ void StoreForwardModule::sendErrorTextMessage(NodeNum dest, bool want_response)
     pr->decoded.want_response = false;
     pr->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
     const char *str;
-    if (this->busy) {
+    if (isBusy()) {
         str = "S&F - Busy. Try again shortly.";
     } else {
         str = "S&F not permitted on the public channel.";
@@ -362,7 +401,7 @@ void StoreForwardModule::statsSend(uint32_t to)
     sf.rr = meshtastic_StoreAndForward_RequestResponse_ROUTER_STATS;
     sf.which_variant = meshtastic_StoreAndForward_stats_tag;
     sf.variant.stats.messages_total = this->records;
-    sf.variant.stats.messages_saved = this->packetHistoryTotalCount;
+    sf.variant.stats.messages_saved = this->history.size();
     sf.variant.stats.messages_max = this->records;
     sf.variant.stats.up_time = millis() / 1000;
     sf.variant.stats.requests = this->requests;
@@ -392,14 +431,14 @@ ProcessMessage StoreForwardModule::handleReceived(const meshtastic_MeshPacket &m
                 LOG_DEBUG("Legacy Request to send");
 
                 // Send the last 60 minutes of messages.
-                if (this->busy || channels.isDefaultChannel(mp.channel)) {
+                if ((isBusy() && !findSession(getFrom(&mp))) || channels.isDefaultChannel(mp.channel)) {
                     sendErrorTextMessage(getFrom(&mp), mp.decoded.want_response);
                 } else {
                     storeForwardModule->historySend(historyReturnWindow * 60, getFrom(&mp));
                 }
             } else {
                 storeForwardModule->historyAdd(mp);
-                LOG_INFO("S&F stored. Message history contains %u records now", this->packetHistoryTotalCount);
+                LOG_INFO("S&F stored. Message history contains %u records now", this->history.size());
             }
         } else if (!isFromUs(&mp) && mp.decoded.portnum == meshtastic_PortNum_STORE_FORWARD_APP) {
             auto &p = mp.decoded;
@@ -444,10 +483,10 @@ bool StoreForwardModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp,
     case meshtastic_StoreAndForward_RequestResponse_CLIENT_ABORT:
         if (is_server) {
             // stop sending stuff, the client wants to abort or has another error
-            if ((this->busy) && (this->busyTo == getFrom(&mp))) {
+            ReplaySession *session = findSession(getFrom(&mp));
+            if (session) {
                 LOG_ERROR("Client in ERROR or ABORT requested");
-                this->requestCount = 0;
-                this->busy = false;
+                *session = ReplaySession();
             }
         }
         break;
@@ -457,7 +496,7 @@ bool StoreForwardModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp,
             requests_history++;
             LOG_INFO("Client Request to send HISTORY");
             // Send the last 60 minutes of messages.
-            if (this->busy || channels.isDefaultChannel(mp.channel)) {
+            if ((isBusy() && !findSession(getFrom(&mp))) || channels.isDefaultChannel(mp.channel)) {
                 sendErrorTextMessage(getFrom(&mp), mp.decoded.want_response);
             } else {
                 if ((p->which_variant == meshtastic_StoreAndForward_history_tag) && (p->variant.history.window > 0)) {
@@ -486,7 +525,7 @@ bool StoreForwardModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp,
     case meshtastic_StoreAndForward_RequestResponse_CLIENT_STATS:
         if (is_server) {
             LOG_INFO("Client Request to send STATS");
-            if (this->busy) {
+            if (isBusy()) {
                 storeForwardModule->sendMessage(getFrom(&mp), meshtastic_StoreAndForward_RequestResponse_ROUTER_BUSY);
                 LOG_INFO("S&F - Busy. Try again shortly");
             } else {
@@ -500,7 +539,7 @@ bool StoreForwardModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp,
         if (is_client) {
             LOG_DEBUG("StoreAndForward_RequestResponse_ROUTER_BUSY");
             // retry in messages_saved * packetTimeMax ms
-            retry_delay = millis() + getNumAvailablePackets(this->busyTo, this->last_time) * packetTimeMax *
+            retry_delay = millis() + getNumAvailablePackets(getFrom(&mp), 0) * packetTimeMax *
                                          (meshtastic_StoreAndForward_RequestResponse_ROUTER_ERROR ? 2 : 1);
         }
         break;
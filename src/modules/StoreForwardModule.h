@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ProtobufModule.h"
+#include "StoreForwardHistory.h"
 #include "concurrency/OSThread.h"
 #include "mesh/generated/meshtastic/storeforward.pb.h"
 
@@ -9,36 +10,49 @@
 #include <functional>
 #include <unordered_map>
 
-struct PacketHistoryStruct {
-    uint32_t time;
-    uint32_t to;
-    uint32_t from;
-    uint32_t id;
-    uint8_t channel;
-    uint32_t reply_id;
-    bool emoji;
-    uint8_t payload[meshtastic_Constants_DATA_PAYLOAD_LEN];
-    pb_size_t payload_size;
-};
+// Clients whose history is replayed at the same time, round-robin
+#ifndef STORE_FORWARD_MAX_SESSIONS
+#define STORE_FORWARD_MAX_SESSIONS 4
+#endif
+
+// Most history packets handed to the radio in one go, when the channel is quiet
+#ifndef STORE_FORWARD_MAX_BURST
+#define STORE_FORWARD_MAX_BURST 8
+#endif
+
+// On a quiet channel a client may get this many times historyReturnMax records, unless that was configured explicitly
+#ifndef STORE_FORWARD_CATCHUP_FACTOR
+#define STORE_FORWARD_CATCHUP_FACTOR 4
+#endif
+
+// Join consecutive short texts of the same sender to the same destination into one frame. Off by default, because the
+// joined message gets a new id, so clients can't tell anymore that they already had some of it.
+#ifndef STORE_FORWARD_PACK_TEXT
+#define STORE_FORWARD_PACK_TEXT 0
+#endif
 
 class StoreForwardModule : private concurrency::OSThread, public ProtobufModule<meshtastic_StoreAndForward>
 {
-    bool busy = 0;
-    uint32_t busyTo = 0;
     char routerMessage[meshtastic_Constants_DATA_PAYLOAD_LEN] = {0};
 
-    PacketHistoryStruct *packetHistory = 0;
-    uint32_t packetHistoryTotalCount = 0;
-    uint32_t last_time = 0;
-    uint32_t requestCount = 0;
+    StoreForwardHistory history;
+
+    // A client we are replaying the history to
+    struct ReplaySession {
+        NodeNum to = 0; // 0 if the slot is free
+        uint32_t since = 0;
+        uint32_t remaining = 0;
+    };
+    ReplaySession sessions[STORE_FORWARD_MAX_SESSIONS];
+    uint8_t nextSession = 0; // Round-robin position
 
     uint32_t packetTimeMax = 5000; // Interval between sending history packets as a server.
 
     bool is_client = false;
     bool is_server = false;
 
-    // Unordered_map stores the last request for each nodeNum (`to` field)
-    std::unordered_map<NodeNum, uint32_t> lastRequest;
+    // Unordered_map stores where each nodeNum (`to` field) is in the history
+    std::unordered_map<NodeNum, StoreForwardCursor> lastRequest;
 
   public:
     StoreForwardModule();
@@ -58,8 +72,10 @@ class StoreForwardModule : private concurrency::OSThread, public ProtobufModule<
     /**
      * Send our payload into the mesh
      */
-    bool sendPayload(NodeNum dest = NODENUM_BROADCAST, uint32_t packetHistory_index = 0);
-    meshtastic_MeshPacket *preparePayload(NodeNum dest, uint32_t packetHistory_index, bool local = false);
+    bool sendPayload(NodeNum dest = NODENUM_BROADCAST, uint32_t last_time = 0);
+    /// Send the next burst of history packets to the clients with a session, @return msec until the next burst
+    int32_t replayBurst();
+    meshtastic_MeshPacket *preparePayload(NodeNum dest, uint32_t last_time, bool local = false);
     void sendMessage(NodeNum dest, const meshtastic_StoreAndForward &payload);
     void sendMessage(NodeNum dest, meshtastic_StoreAndForward_RequestResponse rr);
     void sendErrorTextMessage(NodeNum dest, bool want_response);
@@ -84,6 +100,10 @@ class StoreForwardModule : private concurrency::OSThread, public ProtobufModule<
   private:
     void populatePSRAM();
 
+    ReplaySession *findSession(NodeNum to);
+    /// True if every session slot is in use
+    bool isBusy();
+
     // S&F Defaults
     uint32_t historyReturnMax = 25;     // Return maximum of 25 records by default.
     uint32_t historyReturnWindow = 240; // Return history of last 4 hours by default.
@@ -10,6 +10,7 @@
 #include "PowerFSM.h"
 #include "RTC.h"
 #include "Router.h"
+#include "TelemetryBatch.h"
 #include "detect/ScanI2CTwoWire.h"
 #include "main.h"
 #include <Throttle.h>
@@ -77,6 +78,8 @@ int32_t AirQualityTelemetryModule::runOnce()
         if (!moduleConfig.telemetry.air_quality_enabled)
             return disable();
 
+        meshtastic_Telemetry sample = meshtastic_Telemetry_init_zero;
+        bool sampled = false;
         switch (state) {
 #ifdef PMSA003I_ENABLE_PIN
         case State::IDLE:
@@ -91,18 +94,28 @@ int32_t AirQualityTelemetryModule::runOnce()
             // sensor is already warmed up; grab telemetry and send it
             LOG_DEBUG("runOnce(): state = active");
 
+#if TELEMETRY_BATCHING
+            if (batch.isSampleDue(millis()) && (sampled = getAirQualityTelemetry(&sample)))
+                batch.add(sample, millis());
+#endif
+
             if (((lastSentToMesh == 0) ||
                  !Throttle::isWithinTimespanMs(lastSentToMesh, Default::getConfiguredOrDefaultMsScaled(
                                                                    moduleConfig.telemetry.air_quality_interval,
                                                                    default_telemetry_broadcast_interval_secs, numOnlineNodes))) &&
                 airTime->isTxAllowedChannelUtil(config.device.role != meshtastic_Config_DeviceConfig_Role_SENSOR) &&
                 airTime->isTxAllowedAirUtil()) {
+#if TELEMETRY_BATCHING
+                if (batch.closeWindow(getTime()))
+                    TelemetryBatch::send(batch);
+#else
                 sendTelemetry();
+#endif
                 lastSentToMesh = millis();
             } else if (service->isToPhoneQueueEmpty()) {
                 // Just send to phone when it's not our time to send to mesh yet
                 // Only send while queue is empty (phone assumed connected)
-                sendTelemetry(NODENUM_BROADCAST, true);
+                sendTelemetry(NODENUM_BROADCAST, true, sampled ? &sample : nullptr);
             }
 
 #ifdef PMSA003I_ENABLE_PIN
@@ -111,7 +124,11 @@ int32_t AirQualityTelemetryModule::runOnce()
             state = State::IDLE;
 #endif /* PMSA003I_ENABLE_PIN */
 
+#if TELEMETRY_BATCHING
+            return min(sendToPhoneIntervalMs, (uint32_t)TELEMETRY_BATCH_SAMPLE_SECS * 1000);
+#else
             return sendToPhoneIntervalMs;
+#endif
         default:
             return disable();
         }
@@ -203,10 +220,12 @@ meshtastic_MeshPacket *AirQualityTelemetryModule::allocReply()
     return NULL;
 }
 
-bool AirQualityTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly)
+bool AirQualityTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly, const meshtastic_Telemetry *sample)
 {
     meshtastic_Telemetry m = meshtastic_Telemetry_init_zero;
-    if (getAirQualityTelemetry(&m)) {
+    if (sample)
+        m = *sample;
+    if (sample || getAirQualityTelemetry(&m)) {
         meshtastic_MeshPacket *p = allocDataProtobuf(m);
         p->to = dest;
         p->decoded.want_response = false;
@@ -7,6 +7,7 @@
 #include "Adafruit_PM25AQI.h"
 #include "NodeDB.h"
 #include "ProtobufModule.h"
+#include "TelemetryBatch.h"
 
 class AirQualityTelemetryModule : private concurrency::OSThread, public ProtobufModule<meshtastic_Telemetry>
 {
@@ -46,8 +47,9 @@ class AirQualityTelemetryModule : private concurrency::OSThread, public Protobuf
     virtual meshtastic_MeshPacket *allocReply() override;
     /**
      * Send our Telemetry into the mesh
+     * @param sample measurements already taken, the sensors are read if nullptr
      */
-    bool sendTelemetry(NodeNum dest = NODENUM_BROADCAST, bool wantReplies = false);
+    bool sendTelemetry(NodeNum dest = NODENUM_BROADCAST, bool wantReplies = false, const meshtastic_Telemetry *sample = nullptr);
 
   private:
     enum State {
@@ -62,6 +64,9 @@ class AirQualityTelemetryModule : private concurrency::OSThread, public Protobuf
     meshtastic_MeshPacket *lastMeasurementPacket;
     uint32_t sendToPhoneIntervalMs = SECONDS_IN_MINUTE * 1000; // Send to phone every minute
     uint32_t lastSentToMesh = 0;
+#if TELEMETRY_BATCHING
+    TelemetryAggregator batch{meshtastic_Telemetry_air_quality_metrics_tag};
+#endif
 };
 
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Default.h"
 #include "MeshService.h"
 #include "NodeDB.h"
+#include "PacketLatency.h"
 #include "PowerFSM.h"
 #include "RTC.h"
 #include "RadioLibInterface.h"
@@ -147,6 +148,20 @@ meshtastic_Telemetry DeviceTelemetryModule::getLocalStatsTelemetry()
     LOG_INFO("num_packets_tx=%i, num_packets_rx=%i, num_packets_rx_bad=%i", telemetry.variant.local_stats.num_packets_tx,
              telemetry.variant.local_stats.num_packets_rx, telemetry.variant.local_stats.num_packets_rx_bad);
 
+    const AirtimeBreakdown &breakdown = airTime->getBreakdown();
+    LOG_INFO("airtime origin_tx=%ums, relay_tx=%ums, origin_rx=%ums, relay_rx=%ums", breakdown.originTX_ms,
+             breakdown.relayTX_ms, breakdown.originRX_ms, breakdown.relayRX_ms);
+    int8_t topPortnum = breakdown.portnumRX.top();
+    int8_t topNode = breakdown.nodes.top();
+    if (topPortnum >= 0 && topNode >= 0) {
+        LOG_INFO("airtime top_rx_portnum=%u (%ums), top_node=0x%x (%ums)", breakdown.portnumRX.get(topPortnum).key,
+                 breakdown.portnumRX.get(topPortnum).airtime_ms, breakdown.nodes.get(topNode).key,
+                 breakdown.nodes.get(topNode).airtime_ms);
+    }
+#if MESHTASTIC_PACKET_LATENCY
+    PacketLatency::logSummary();
+#endif
+
     return telemetry;
 }
 
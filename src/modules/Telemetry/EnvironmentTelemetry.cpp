@@ -10,6 +10,7 @@
 #include "PowerFSM.h"
 #include "RTC.h"
 #include "Router.h"
+#include "TelemetryBatch.h"
 #include "UnitConversions.h"
 #include "main.h"
 #include "power.h"
@@ -159,6 +160,10 @@ NullSensor bmp3xxSensor;
 
 RCWL9620Sensor rcwl9620Sensor;
 CGRadSensSensor cgRadSens;
+
+// The sensors that can start a measurement and be read later, see TelemetrySensor::startMeasurement(). They are started all
+// at once, so the module waits for the slowest conversion once instead of for each sensor in turn.
+static TelemetrySensor *const batchedSensors[] = {&bme280Sensor, &bmp280Sensor, &sht31Sensor, &sht4xSensor};
 #endif
 #ifdef T1000X_SENSOR_EN
 #include "Sensor/T1000xSensor.h"
@@ -286,22 +291,54 @@ int32_t EnvironmentTelemetryModule::runOnce()
 #endif
         }
 
-        if (((lastSentToMesh == 0) ||
-             !Throttle::isWithinTimespanMs(lastSentToMesh, Default::getConfiguredOrDefaultMsScaled(
-                                                               moduleConfig.telemetry.environment_update_interval,
-                                                               default_telemetry_broadcast_interval_secs, numOnlineNodes))) &&
-            airTime->isTxAllowedChannelUtil(config.device.role != meshtastic_Config_DeviceConfig_Role_SENSOR) &&
-            airTime->isTxAllowedAirUtil()) {
+        uint32_t meshIntervalMs = Default::getConfiguredOrDefaultMsScaled(
+            moduleConfig.telemetry.environment_update_interval, default_telemetry_broadcast_interval_secs, numOnlineNodes);
+        bool toMesh = ((lastSentToMesh == 0) || !Throttle::isWithinTimespanMs(lastSentToMesh, meshIntervalMs)) &&
+                      airTime->isTxAllowedChannelUtil(config.device.role != meshtastic_Config_DeviceConfig_Role_SENSOR) &&
+                      airTime->isTxAllowedAirUtil();
+        bool toPhone = !toMesh &&
+                       ((lastSentToPhone == 0) || !Throttle::isWithinTimespanMs(lastSentToPhone, sendToPhoneIntervalMs)) &&
+                       (service->isToPhoneQueueEmpty());
+
+        // When batching, every TELEMETRY_BATCH_SAMPLE_SECS adds a sample to the current window
+        bool toBatch = TELEMETRY_BATCHING && batch.isSampleDue(millis());
+
+        if ((toMesh || toPhone || toBatch) && !measurementsStarted) {
+            // Start the sensors now and read them when we are called again, rather than block while each one converts
+            uint32_t wait = startMeasurements();
+            if (wait) {
+                measurementsStarted = true;
+                return wait;
+            }
+        }
+        measurementsStarted = false;
+
+        meshtastic_Telemetry sample = meshtastic_Telemetry_init_zero;
+        bool sampled = false;
+#if TELEMETRY_BATCHING
+        if (toBatch && (sampled = getEnvironmentTelemetry(&sample)))
+            batch.add(sample, millis());
+#endif
+
+        if (toMesh) {
+#if TELEMETRY_BATCHING
+            // A window is one update interval, the batch goes out once enough of them are done
+            if (batch.closeWindow(getTime()))
+                TelemetryBatch::send(batch);
+#else
             sendTelemetry();
+#endif
             lastSentToMesh = millis();
-        } else if (((lastSentToPhone == 0) || !Throttle::isWithinTimespanMs(lastSentToPhone, sendToPhoneIntervalMs)) &&
-                   (service->isToPhoneQueueEmpty())) {
+        } else if (toPhone) {
             // Just send to phone when it's not our time to send to mesh yet
             // Only send while queue is empty (phone assumed connected)
-            sendTelemetry(NODENUM_BROADCAST, true);
+            sendTelemetry(NODENUM_BROADCAST, true, sampled ? &sample : nullptr);
             lastSentToPhone = millis();
         }
     }
+#if TELEMETRY_BATCHING
+    result = min(result, (uint32_t)TELEMETRY_BATCH_SAMPLE_SECS * 1000);
+#endif
     return min(sendToPhoneIntervalMs, result);
 }
 
@@ -461,10 +498,27 @@ bool EnvironmentTelemetryModule::handleReceivedProtobuf(const meshtastic_MeshPac
     return false; // Let others look at this message also if they want
 }
 
+uint32_t EnvironmentTelemetryModule::startMeasurements()
+{
+    uint32_t wait = 0;
+#if !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR_EXTERNAL && !defined(T1000X_SENSOR_EN)
+    for (TelemetrySensor *sensor : batchedSensors)
+        if (sensor->hasSensor())
+            wait = max(wait, sensor->triggerMeasurement());
+#endif
+    return wait;
+}
+
 bool EnvironmentTelemetryModule::getEnvironmentTelemetry(meshtastic_Telemetry *m)
 {
     bool valid = true;
     bool hasSensor = false;
+
+    // Measurements started by runOnce() are done by now, only a request from elsewhere has to wait here
+    uint32_t wait = startMeasurements();
+    if (wait)
+        delay(wait);
+
     m->time = getTime();
     m->which_variant = meshtastic_Telemetry_environment_metrics_tag;
     m->variant.environment_metrics = meshtastic_EnvironmentMetrics_init_zero;
@@ -631,15 +685,17 @@ meshtastic_MeshPacket *EnvironmentTelemetryModule::allocReply()
     return NULL;
 }
 
-bool EnvironmentTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly)
+bool EnvironmentTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly, const meshtastic_Telemetry *sample)
 {
     meshtastic_Telemetry m = meshtastic_Telemetry_init_zero;
     m.which_variant = meshtastic_Telemetry_environment_metrics_tag;
     m.time = getTime();
+    if (sample)
+        m = *sample;
 #ifdef T1000X_SENSOR_EN
-    if (t1000xSensor.getMetrics(&m)) {
+    if (sample || t1000xSensor.getMetrics(&m)) {
 #else
-    if (getEnvironmentTelemetry(&m)) {
+    if (sample || getEnvironmentTelemetry(&m)) {
 #endif
         LOG_INFO("Send: barometric_pressure=%f, current=%f, gas_resistance=%f, relative_humidity=%f, temperature=%f",
                  m.variant.environment_metrics.barometric_pressure, m.variant.environment_metrics.current,
@@ -11,6 +11,7 @@
 #include "../mesh/generated/meshtastic/telemetry.pb.h"
 #include "NodeDB.h"
 #include "ProtobufModule.h"
+#include "TelemetryBatch.h"
 #include <OLEDDisplay.h>
 #include <OLEDDisplayUi.h>
 
@@ -46,11 +47,16 @@ class EnvironmentTelemetryModule : private concurrency::OSThread, public Protobu
     @return true if it contains valid data
     */
     bool getEnvironmentTelemetry(meshtastic_Telemetry *m);
+    /** Start the sensors that can measure in the background
+    @return msec until the slowest of them is done
+    */
+    uint32_t startMeasurements();
     virtual meshtastic_MeshPacket *allocReply() override;
     /**
      * Send our Telemetry into the mesh
+     * @param sample measurements already taken, the sensors are read if nullptr
      */
-    bool sendTelemetry(NodeNum dest = NODENUM_BROADCAST, bool wantReplies = false);
+    bool sendTelemetry(NodeNum dest = NODENUM_BROADCAST, bool wantReplies = false, const meshtastic_Telemetry *sample = nullptr);
 
     virtual AdminMessageHandleResult handleAdminMessageForModule(const meshtastic_MeshPacket &mp,
                                                                  meshtastic_AdminMessage *request,
@@ -63,6 +69,10 @@ class EnvironmentTelemetryModule : private concurrency::OSThread, public Protobu
     uint32_t lastSentToMesh = 0;
     uint32_t lastSentToPhone = 0;
     uint32_t sensor_read_error_count = 0;
+    bool measurementsStarted = false;
+#if TELEMETRY_BATCHING
+    TelemetryAggregator batch{meshtastic_Telemetry_environment_metrics_tag};
+#endif
 };
 
 #endif
\ No newline at end of file
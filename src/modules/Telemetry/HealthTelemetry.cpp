@@ -10,6 +10,7 @@
 #include "PowerFSM.h"
 #include "RTC.h"
 #include "Router.h"
+#include "TelemetryBatch.h"
 #include "UnitConversions.h"
 #include "main.h"
 #include "power.h"
@@ -69,22 +70,37 @@ int32_t HealthTelemetryModule::runOnce()
             return disable();
         }
 
+        meshtastic_Telemetry sample = meshtastic_Telemetry_init_zero;
+        bool sampled = false;
+#if TELEMETRY_BATCHING
+        if (batch.isSampleDue(millis()) && (sampled = getHealthTelemetry(&sample)))
+            batch.add(sample, millis());
+#endif
+
         if (((lastSentToMesh == 0) ||
              !Throttle::isWithinTimespanMs(lastSentToMesh, Default::getConfiguredOrDefaultMsScaled(
                                                                moduleConfig.telemetry.health_update_interval,
                                                                default_telemetry_broadcast_interval_secs, numOnlineNodes))) &&
             airTime->isTxAllowedChannelUtil(config.device.role != meshtastic_Config_DeviceConfig_Role_SENSOR) &&
             airTime->isTxAllowedAirUtil()) {
+#if TELEMETRY_BATCHING
+            if (batch.closeWindow(getTime()))
+                TelemetryBatch::send(batch);
+#else
             sendTelemetry();
+#endif
             lastSentToMesh = millis();
         } else if (((lastSentToPhone == 0) || !Throttle::isWithinTimespanMs(lastSentToPhone, sendToPhoneIntervalMs)) &&
                    (service->isToPhoneQueueEmpty())) {
             // Just send to phone when it's not our time to send to mesh yet
             // Only send while queue is empty (phone assumed connected)
-            sendTelemetry(NODENUM_BROADCAST, true);
+            sendTelemetry(NODENUM_BROADCAST, true, sampled ? &sample : nullptr);
             lastSentToPhone = millis();
         }
     }
+#if TELEMETRY_BATCHING
+    result = min(result, (uint32_t)TELEMETRY_BATCH_SAMPLE_SECS * 1000);
+#endif
     return min(sendToPhoneIntervalMs, result);
 }
 
@@ -205,12 +221,14 @@ meshtastic_MeshPacket *HealthTelemetryModule::allocReply()
     return NULL;
 }
 
-bool HealthTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly)
+bool HealthTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly, const meshtastic_Telemetry *sample)
 {
     meshtastic_Telemetry m = meshtastic_Telemetry_init_zero;
     m.which_variant = meshtastic_Telemetry_health_metrics_tag;
     m.time = getTime();
-    if (getHealthTelemetry(&m)) {
+    if (sample)
+        m = *sample;
+    if (sample || getHealthTelemetry(&m)) {
         LOG_INFO("Send: temperature=%f, heart_bpm=%d, spO2=%d", m.variant.health_metrics.temperature,
                  m.variant.health_metrics.heart_bpm, m.variant.health_metrics.spO2);
 
@@ -10,6 +10,7 @@
 #include "PowerTelemetry.h"
 #include "RTC.h"
 #include "Router.h"
+#include "TelemetryBatch.h"
 #include "main.h"
 #include "power.h"
 #include "sleep.h"
@@ -81,19 +82,35 @@ int32_t PowerTelemetryModule::runOnce()
         if (!moduleConfig.telemetry.power_measurement_enabled)
             return disable();
 
+        meshtastic_Telemetry sample = meshtastic_Telemetry_init_zero;
+        bool sampled = false;
+#if TELEMETRY_BATCHING
+        if (batch.isSampleDue(millis()) && (sampled = getPowerTelemetry(&sample)))
+            batch.add(sample, millis());
+#endif
+
         if (((lastSentToMesh == 0) || !Throttle::isWithinTimespanMs(lastSentToMesh, sendToMeshIntervalMs)) &&
             airTime->isTxAllowedAirUtil()) {
+#if TELEMETRY_BATCHING
+            if (batch.closeWindow(getTime()))
+                TelemetryBatch::send(batch);
+#else
             sendTelemetry();
+#endif
             lastSentToMesh = millis();
         } else if (((lastSentToPhone == 0) || !Throttle::isWithinTimespanMs(lastSentToPhone, sendToPhoneIntervalMs)) &&
                    (service->isToPhoneQueueEmpty())) {
             // Just send to phone when it's not our time to send to mesh yet
             // Only send while queue is empty (phone assumed connected)
-            sendTelemetry(NODENUM_BROADCAST, true);
+            sendTelemetry(NODENUM_BROADCAST, true, sampled ? &sample : nullptr);
             lastSentToPhone = millis();
         }
     }
+#if TELEMETRY_BATCHING
+    return min(min(sendToPhoneIntervalMs, sendToMeshIntervalMs), (uint32_t)TELEMETRY_BATCH_SAMPLE_SECS * 1000);
+#else
     return min(sendToPhoneIntervalMs, sendToMeshIntervalMs);
+#endif
 }
 
 bool PowerTelemetryModule::wantUIFrame()
@@ -220,12 +237,14 @@ meshtastic_MeshPacket *PowerTelemetryModule::allocReply()
     return NULL;
 }
 
-bool PowerTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly)
+bool PowerTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly, const meshtastic_Telemetry *sample)
 {
     meshtastic_Telemetry m = meshtastic_Telemetry_init_zero;
     m.which_variant = meshtastic_Telemetry_power_metrics_tag;
     m.time = getTime();
-    if (getPowerTelemetry(&m)) {
+    if (sample)
+        m = *sample;
+    if (sample || getPowerTelemetry(&m)) {
         LOG_INFO("Send: ch1_voltage=%f, ch1_current=%f, ch2_voltage=%f, ch2_current=%f, "
                  "ch3_voltage=%f, ch3_current=%f",
                  m.variant.power_metrics.ch1_voltage, m.variant.power_metrics.ch1_current, m.variant.power_metrics.ch2_voltage,
@@ -7,6 +7,7 @@
 #include "../mesh/generated/meshtastic/telemetry.pb.h"
 #include "NodeDB.h"
 #include "ProtobufModule.h"
+#include "TelemetryBatch.h"
 #include <OLEDDisplay.h>
 #include <OLEDDisplayUi.h>
 
@@ -44,8 +45,9 @@ class PowerTelemetryModule : private concurrency::OSThread, public ProtobufModul
     virtual meshtastic_MeshPacket *allocReply() override;
     /**
      * Send our Telemetry into the mesh
+     * @param sample measurements already taken, the sensors are read if nullptr
      */
-    bool sendTelemetry(NodeNum dest = NODENUM_BROADCAST, bool wantReplies = false);
+    bool sendTelemetry(NodeNum dest = NODENUM_BROADCAST, bool wantReplies = false, const meshtastic_Telemetry *sample = nullptr);
 
   private:
     bool firstTime = 1;
@@ -54,6 +56,9 @@ class PowerTelemetryModule : private concurrency::OSThread, public ProtobufModul
     uint32_t lastSentToMesh = 0;
     uint32_t lastSentToPhone = 0;
     uint32_t sensor_read_error_count = 0;
+#if TELEMETRY_BATCHING
+    TelemetryAggregator batch{meshtastic_Telemetry_power_metrics_tag};
+#endif
 };
 
 #endif
\ No newline at end of file
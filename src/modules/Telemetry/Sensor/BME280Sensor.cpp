@@ -18,16 +18,28 @@ int32_t BME280Sensor::runOnce()
     }
     status = bme280.begin(nodeTelemetrySensorsMap[sensorType].first, nodeTelemetrySensorsMap[sensorType].second);
 
+    setForcedSampling();
+
+    return initI2CSensor();
+}
+
+void BME280Sensor::setup() {}
+
+void BME280Sensor::setForcedSampling()
+{
     bme280.setSampling(Adafruit_BME280::MODE_FORCED,
                        Adafruit_BME280::SAMPLING_X1, // Temp. oversampling
                        Adafruit_BME280::SAMPLING_X1, // Pressure oversampling
                        Adafruit_BME280::SAMPLING_X1, // Humidity oversampling
                        Adafruit_BME280::FILTER_OFF, Adafruit_BME280::STANDBY_MS_1000);
-
-    return initI2CSensor();
 }
 
-void BME280Sensor::setup() {}
+uint32_t BME280Sensor::startMeasurement()
+{
+    // Writing the forced mode starts a conversion, which takes at most 9.3ms with single oversampling
+    setForcedSampling();
+    return 10;
+}
 
 bool BME280Sensor::getMetrics(meshtastic_Telemetry *measurement)
 {
@@ -36,7 +48,8 @@ bool BME280Sensor::getMetrics(meshtastic_Telemetry *measurement)
     measurement->variant.environment_metrics.has_barometric_pressure = true;
 
     LOG_DEBUG("BME280 getMetrics");
-    bme280.takeForcedMeasurement();
+    if (!measurementStarted)
+        bme280.takeForcedMeasurement();
     measurement->variant.environment_metrics.temperature = bme280.readTemperature();
     measurement->variant.environment_metrics.relative_humidity = bme280.readHumidity();
     measurement->variant.environment_metrics.barometric_pressure = bme280.readPressure() / 100.0F;
@@ -11,6 +11,8 @@ class BME280Sensor : public TelemetrySensor
   private:
     Adafruit_BME280 bme280;
 
+    void setForcedSampling();
+
   protected:
     virtual void setup() override;
 
@@ -18,6 +20,7 @@ class BME280Sensor : public TelemetrySensor
     BME280Sensor();
     virtual int32_t runOnce() override;
     virtual bool getMetrics(meshtastic_Telemetry *measurement) override;
+    virtual uint32_t startMeasurement() override;
 };
 
 #endif
\ No newline at end of file
@@ -11,6 +11,8 @@ class BMP280Sensor : public TelemetrySensor
   private:
     Adafruit_BMP280 bmp280;
 
+    void setForcedSampling();
+
   protected:
     virtual void setup() override;
 
@@ -18,6 +20,7 @@ class BMP280Sensor : public TelemetrySensor
     BMP280Sensor();
     virtual int32_t runOnce() override;
     virtual bool getMetrics(meshtastic_Telemetry *measurement) override;
+    virtual uint32_t startMeasurement() override;
 };
 
 #endif
\ No newline at end of file
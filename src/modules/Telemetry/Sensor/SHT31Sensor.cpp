@@ -4,6 +4,7 @@
 
 #include "../mesh/generated/meshtastic/telemetry.pb.h"
 #include "SHT31Sensor.h"
+#include "SensirionI2C.h"
 #include "TelemetrySensor.h"
 #include <Adafruit_SHT31.h>
 
@@ -25,12 +26,33 @@ void SHT31Sensor::setup()
     // Set up oversampling and filter initialization
 }
 
+uint32_t SHT31Sensor::startMeasurement()
+{
+    // Single shot, high repeatability, without clock stretching: 15.5ms at most
+    if (!SensirionI2C::sendCommand(nodeTelemetrySensorsMap[sensorType].second, nodeTelemetrySensorsMap[sensorType].first, 0x2400,
+                                   2))
+        return 0;
+    return 16;
+}
+
 bool SHT31Sensor::getMetrics(meshtastic_Telemetry *measurement)
 {
     measurement->variant.environment_metrics.has_temperature = true;
     measurement->variant.environment_metrics.has_relative_humidity = true;
-    measurement->variant.environment_metrics.temperature = sht31.readTemperature();
-    measurement->variant.environment_metrics.relative_humidity = sht31.readHumidity();
+
+    uint16_t raw[2];
+    if (measurementStarted &&
+        SensirionI2C::readWords(nodeTelemetrySensorsMap[sensorType].second, nodeTelemetrySensorsMap[sensorType].first, raw, 2)) {
+        measurement->variant.environment_metrics.temperature = -45.0f + 175.0f * raw[0] / 65535.0f;
+        measurement->variant.environment_metrics.relative_humidity = 100.0f * raw[1] / 65535.0f;
+        return true;
+    }
+
+    // Nothing started, or the result was read already
+    float temperature, humidity;
+    sht31.readBoth(&temperature, &humidity);
+    measurement->variant.environment_metrics.temperature = temperature;
+    measurement->variant.environment_metrics.relative_humidity = humidity;
 
     return true;
 }
@@ -4,8 +4,10 @@
 
 #include "../mesh/generated/meshtastic/telemetry.pb.h"
 #include "SHT4XSensor.h"
+#include "SensirionI2C.h"
 #include "TelemetrySensor.h"
 #include <Adafruit_SHT4x.h>
+#include <algorithm>
 
 SHT4XSensor::SHT4XSensor() : TelemetrySensor(meshtastic_TelemetrySensorType_SHT4X, "SHT4X") {}
 
@@ -37,11 +39,30 @@ void SHT4XSensor::setup()
     // Set up oversampling and filter initialization
 }
 
+uint32_t SHT4XSensor::startMeasurement()
+{
+    // High precision without heater, like getEvent() does by default: 8.3ms at most
+    TwoWire *bus = nodeTelemetrySensorsMap[sensorType].second;
+    if (!SensirionI2C::sendCommand(bus, nodeTelemetrySensorsMap[sensorType].first, 0xFD, 1))
+        return 0;
+    return 9;
+}
+
 bool SHT4XSensor::getMetrics(meshtastic_Telemetry *measurement)
 {
     measurement->variant.environment_metrics.has_temperature = true;
     measurement->variant.environment_metrics.has_relative_humidity = true;
 
+    uint16_t raw[2];
+    if (measurementStarted &&
+        SensirionI2C::readWords(nodeTelemetrySensorsMap[sensorType].second, nodeTelemetrySensorsMap[sensorType].first, raw, 2)) {
+        measurement->variant.environment_metrics.temperature = -45.0f + 175.0f * raw[0] / 65535.0f;
+        measurement->variant.environment_metrics.relative_humidity =
+            std::min(std::max(-6.0f + 125.0f * raw[1] / 65535.0f, 0.0f), 100.0f);
+        return true;
+    }
+
+    // Nothing started, or the result was read already
     sensors_event_t humidity, temp;
     sht4x.getEvent(&humidity, &temp);
     measurement->variant.environment_metrics.temperature = temp.temperature;
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Wire.h>
+#include <stdint.h>
+
+/**
+ * The single shot commands of the Sensirion humidity sensors, split so that the measurement can run while other sensors
+ * are busy too. The libraries only offer a call that sends the command and then waits for the result.
+ */
+namespace SensirionI2C
+{
+
+/// Send a command of 'len' bytes, most significant byte first
+inline bool sendCommand(TwoWire *bus, uint8_t address, uint16_t command, uint8_t len)
+{
+    bus->beginTransmission(address);
+    if (len == 2)
+        bus->write((uint8_t)(command >> 8));
+    bus->write((uint8_t)command);
+    return bus->endTransmission() == 0;
+}
+
+inline uint8_t crc8(const uint8_t *data, uint8_t len)
+{
+    uint8_t crc = 0xFF;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : crc << 1;
+    }
+    return crc;
+}
+
+/// Read 'count' 16 bit words, each followed by its CRC
+inline bool readWords(TwoWire *bus, uint8_t address, uint16_t *words, uint8_t count)
+{
+    uint8_t buf[3];
+    uint8_t len = count * sizeof(buf);
+    if (bus->requestFrom(address, len) != len)
+        return false;
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t k = 0; k < sizeof(buf); k++)
+            buf[k] = bus->read();
+        if (crc8(buf, 2) != buf[2])
+            return false;
+        words[i] = (buf[0] << 8) | buf[1];
+    }
+    return true;
+}
+
+} // namespace SensirionI2C
@@ -6,6 +6,7 @@
 #include "../mesh/generated/meshtastic/telemetry.pb.h"
 #include "MeshModule.h"
 #include "NodeDB.h"
+#include <Throttle.h>
 #include <utility>
 
 #if !ARCH_PORTDUINO
@@ -29,6 +30,10 @@ class TelemetrySensor
     meshtastic_TelemetrySensorType sensorType = meshtastic_TelemetrySensorType_SENSOR_UNSET;
     unsigned status;
     bool initialized = false;
+    // Set once startMeasurement() has run, getMetrics() then reads the results instead of measuring by itself
+    bool measurementStarted = false;
+    uint32_t lastMeasurementStart = 0;
+    uint32_t measurementTime = 0;
 
     int32_t initI2CSensor()
     {
@@ -58,6 +63,32 @@ class TelemetrySensor
     virtual bool isRunning() { return status > 0; }
 
     virtual bool getMetrics(meshtastic_Telemetry *measurement) = 0;
+
+    /**
+     * Start a measurement and return without waiting for it to finish, for sensors that can.
+     * @return msec until getMetrics() can read the result, 0 if getMetrics() has to measure by itself
+     */
+    virtual uint32_t startMeasurement() { return 0; }
+
+    /// Shortest time between two measurements
+    virtual uint32_t minimumInterval() { return DEFAULT_SENSOR_MINIMUM_WAIT_TIME_BETWEEN_READS; }
+
+    /**
+     * Start a measurement, unless the last one was started less than minimumInterval() ago, in which case getMetrics()
+     * reads that one again.
+     * @return msec until the result is ready
+     */
+    uint32_t triggerMeasurement()
+    {
+        if (measurementStarted && Throttle::isWithinTimespanMs(lastMeasurementStart, minimumInterval())) {
+            uint32_t elapsed = millis() - lastMeasurementStart;
+            return elapsed < measurementTime ? measurementTime - elapsed : 0;
+        }
+        measurementTime = startMeasurement();
+        lastMeasurementStart = millis();
+        measurementStarted = measurementTime > 0;
+        return measurementTime;
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,452 @@
+#include "TelemetryBatch.h"
+#include "MeshService.h"
+#include "Router.h"
+#include "configuration.h"
+#include "main.h"
+#include "mesh-pb-constants.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace TelemetryBatch
+{
+
+enum FieldType : uint8_t { F32, U8, U16, U32 };
+
+struct Field {
+    const char *name;
+    uint8_t hasOffset, valueOffset;
+    FieldType type;
+    uint16_t scale; // Fixed point factor, 100 keeps two decimals
+};
+
+#define FIELD(S, member, name, type, scale) {name, offsetof(S, has_##member), offsetof(S, member), type, scale}
+
+// The names match the ones the MQTT JSON uses for single samples. Only ever append, the index is part of the format.
+static const Field environmentFields[] = {
+    FIELD(meshtastic_EnvironmentMetrics, temperature, "temperature", F32, 100),
+    FIELD(meshtastic_EnvironmentMetrics, relative_humidity, "relative_humidity", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, barometric_pressure, "barometric_pressure", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, gas_resistance, "gas_resistance", F32, 1000),
+    FIELD(meshtastic_EnvironmentMetrics, voltage, "voltage", F32, 1000),
+    FIELD(meshtastic_EnvironmentMetrics, current, "current", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, iaq, "iaq", U16, 1),
+    FIELD(meshtastic_EnvironmentMetrics, distance, "distance", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, lux, "lux", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, white_lux, "white_lux", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, ir_lux, "ir_lux", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, uv_lux, "uv_lux", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, wind_direction, "wind_direction", U16, 1),
+    FIELD(meshtastic_EnvironmentMetrics, wind_speed, "wind_speed", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, weight, "weight", F32, 100),
+    FIELD(meshtastic_EnvironmentMetrics, wind_gust, "wind_gust", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, wind_lull, "wind_lull", F32, 10),
+    FIELD(meshtastic_EnvironmentMetrics, radiation, "radiation", F32, 100),
+    FIELD(meshtastic_EnvironmentMetrics, rainfall_1h, "rainfall_1h", F32, 100),
+    FIELD(meshtastic_EnvironmentMetrics, rainfall_24h, "rainfall_24h", F32, 100),
+    FIELD(meshtastic_EnvironmentMetrics, soil_moisture, "soil_moisture", U8, 1),
+    FIELD(meshtastic_EnvironmentMetrics, soil_temperature, "soil_temperature", F32, 100),
+};
+
+static const Field powerFields[] = {
+    FIELD(meshtastic_PowerMetrics, ch1_voltage, "voltage_ch1", F32, 1000),
+    FIELD(meshtastic_PowerMetrics, ch1_current, "current_ch1", F32, 10),
+    FIELD(meshtastic_PowerMetrics, ch2_voltage, "voltage_ch2", F32, 1000),
+    FIELD(meshtastic_PowerMetrics, ch2_current, "current_ch2", F32, 10),
+    FIELD(meshtastic_PowerMetrics, ch3_voltage, "voltage_ch3", F32, 1000),
+    FIELD(meshtastic_PowerMetrics, ch3_current, "current_ch3", F32, 10),
+};
+
+static const Field airQualityFields[] = {
+    FIELD(meshtastic_AirQualityMetrics, pm10_standard, "pm10", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, pm25_standard, "pm25", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, pm100_standard, "pm100", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, pm10_environmental, "pm10_e", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, pm25_environmental, "pm25_e", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, pm100_environmental, "pm100_e", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, particles_03um, "particles_03um", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, particles_05um, "particles_05um", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, particles_10um, "particles_10um", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, particles_25um, "particles_25um", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, particles_50um, "particles_50um", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, particles_100um, "particles_100um", U32, 1),
+    FIELD(meshtastic_AirQualityMetrics, co2, "co2", U32, 1),
+};
+
+static const Field healthFields[] = {
+    FIELD(meshtastic_HealthMetrics, heart_bpm, "heart_bpm", U8, 1),
+    FIELD(meshtastic_HealthMetrics, spO2, "spO2", U8, 1),
+    FIELD(meshtastic_HealthMetrics, temperature, "temperature", F32, 100),
+};
+
+#undef FIELD
+
+static const Field *getFields(pb_size_t variant, uint8_t &count)
+{
+    switch (variant) {
+    case meshtastic_Telemetry_environment_metrics_tag:
+        count = sizeof(environmentFields) / sizeof(environmentFields[0]);
+        return environmentFields;
+    case meshtastic_Telemetry_power_metrics_tag:
+        count = sizeof(powerFields) / sizeof(powerFields[0]);
+        return powerFields;
+    case meshtastic_Telemetry_air_quality_metrics_tag:
+        count = sizeof(airQualityFields) / sizeof(airQualityFields[0]);
+        return airQualityFields;
+    case meshtastic_Telemetry_health_metrics_tag:
+        count = sizeof(healthFields) / sizeof(healthFields[0]);
+        return healthFields;
+    default:
+        count = 0;
+        return nullptr;
+    }
+}
+
+/// The field of a sample in fixed point, false if the sample doesn't have it
+static bool readField(const meshtastic_Telemetry &m, const Field &f, int32_t &value)
+{
+    const uint8_t *metrics = (const uint8_t *)&m.variant;
+    if (!metrics[f.hasOffset])
+        return false;
+    const uint8_t *p = metrics + f.valueOffset;
+    switch (f.type) {
+    case F32: {
+        float v;
+        memcpy(&v, p, sizeof(v));
+        double fixed = round((double)v * f.scale);
+        if (isnan(fixed))
+            return false;
+        value = fixed > INT32_MAX ? INT32_MAX : fixed < INT32_MIN ? INT32_MIN : (int32_t)fixed;
+        return true;
+    }
+    case U8:
+        value = *p;
+        return true;
+    case U16: {
+        uint16_t v;
+        memcpy(&v, p, sizeof(v));
+        value = v;
+        return true;
+    }
+    case U32: {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        value = v > INT32_MAX ? INT32_MAX : v;
+        return true;
+    }
+    }
+    return false;
+}
+
+static void writeField(meshtastic_Telemetry &m, const Field &f, int32_t value)
+{
+    uint8_t *metrics = (uint8_t *)&m.variant;
+    metrics[f.hasOffset] = true;
+    uint8_t *p = metrics + f.valueOffset;
+    switch (f.type) {
+    case F32: {
+        float v = (float)value / f.scale;
+        memcpy(p, &v, sizeof(v));
+        break;
+    }
+    case U8:
+        *p = value < 0 ? 0 : value > UINT8_MAX ? UINT8_MAX : value;
+        break;
+    case U16: {
+        uint16_t v = value < 0 ? 0 : value > UINT16_MAX ? UINT16_MAX : value;
+        memcpy(p, &v, sizeof(v));
+        break;
+    }
+    case U32: {
+        uint32_t v = value < 0 ? 0 : value;
+        memcpy(p, &v, sizeof(v));
+        break;
+    }
+    }
+}
+
+static bool putVarint(uint8_t *buf, size_t len, size_t &pos, uint32_t v)
+{
+    do {
+        if (pos >= len)
+            return false;
+        buf[pos++] = (v & 0x7F) | (v > 0x7F ? 0x80 : 0);
+        v >>= 7;
+    } while (v);
+    return true;
+}
+
+static bool getVarint(const uint8_t *buf, size_t len, size_t &pos, uint32_t &v)
+{
+    v = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (pos >= len)
+            return false;
+        uint8_t b = buf[pos++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+bool isBatch(const meshtastic_MeshPacket &mp)
+{
+    return mp.which_payload_variant == meshtastic_MeshPacket_decoded_tag && mp.decoded.portnum == TELEMETRY_BATCH_PORTNUM;
+}
+
+bool decode(const uint8_t *buf, size_t len, Batch &batch)
+{
+    size_t pos = 0;
+    uint32_t version, variant, count, fields;
+    if (!getVarint(buf, len, pos, version) || version != VERSION ||
+        !getVarint(buf, len, pos, variant) || !getVarint(buf, len, pos, batch.time) ||
+        !getVarint(buf, len, pos, batch.windowSecs) || !getVarint(buf, len, pos, count) || count > MAX_WINDOWS ||
+        !getVarint(buf, len, pos, fields))
+        return false;
+
+    uint8_t numFields;
+    if (!getFields(variant, numFields) || (numFields < 32 && (fields >> numFields)))
+        return false;
+    batch.variant = variant;
+    batch.count = count;
+    batch.entries.clear();
+
+    for (uint8_t f = 0; f < numFields; f++) {
+        if (!(fields & (1UL << f)))
+            continue;
+        if (pos >= len)
+            return false;
+        uint8_t present = buf[pos++];
+        int32_t mean = 0;
+        for (uint8_t w = 0; w < count; w++) {
+            if (!(present & (1 << w)))
+                continue;
+            uint32_t delta, below, above;
+            if (!getVarint(buf, len, pos, delta) || !getVarint(buf, len, pos, below) || !getVarint(buf, len, pos, above))
+                return false;
+            mean += unzigzag(delta);
+            batch.entries.push_back({w, f, (int32_t)(mean - below), mean, (int32_t)(mean + above)});
+        }
+    }
+    return pos == len;
+}
+
+uint8_t numFields(pb_size_t variant)
+{
+    uint8_t count;
+    getFields(variant, count);
+    return count;
+}
+
+const char *fieldName(pb_size_t variant, uint8_t field)
+{
+    uint8_t count;
+    const Field *fields = getFields(variant, count);
+    return field < count ? fields[field].name : nullptr;
+}
+
+bool getStats(const Batch &batch, uint8_t window, uint8_t field, Stats &stats)
+{
+    uint8_t count;
+    const Field *fields = getFields(batch.variant, count);
+    if (field >= count)
+        return false;
+    for (const Batch::Entry &e : batch.entries) {
+        if (e.window == window && e.field == field) {
+            float scale = fields[field].scale;
+            stats = {e.min / scale, e.mean / scale, e.max / scale};
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t windowEnd(const Batch &batch, uint8_t window)
+{
+    return batch.time ? batch.time - (batch.count - 1 - window) * batch.windowSecs : 0;
+}
+
+void getMeans(const Batch &batch, uint8_t window, meshtastic_Telemetry &m)
+{
+    m = meshtastic_Telemetry_init_zero;
+    m.time = windowEnd(batch, window);
+    m.which_variant = batch.variant;
+    uint8_t count;
+    const Field *fields = getFields(batch.variant, count);
+    for (const Batch::Entry &e : batch.entries)
+        if (e.window == window && e.field < count)
+            writeField(m, fields[e.field], e.mean);
+}
+
+} // namespace TelemetryBatch
+
+using namespace TelemetryBatch;
+
+TelemetryAggregator::TelemetryAggregator(pb_size_t variant) : variant(variant), current(TelemetryBatch::numFields(variant)) {}
+
+void TelemetryAggregator::add(const meshtastic_Telemetry &sample, uint32_t nowMs)
+{
+    sampled = true;
+    lastSampleMs = nowMs;
+    if (sample.which_variant != variant)
+        return;
+    uint8_t count;
+    const Field *fields = getFields(variant, count);
+    for (uint8_t f = 0; f < count; f++) {
+        int32_t v;
+        if (!readField(sample, fields[f], v))
+            continue;
+        Accumulator &a = current[f];
+        if (!a.count || v < a.min)
+            a.min = v;
+        if (!a.count || v > a.max)
+            a.max = v;
+        a.sum += v;
+        a.count++;
+    }
+}
+
+bool TelemetryAggregator::closeWindow(uint32_t now)
+{
+    Window w = {windowStart ? windowStart : now, now, 0, {}};
+    for (uint8_t f = 0; f < current.size(); f++) {
+        if (current[f].count) {
+            w.fields |= 1UL << f;
+            w.stats.push_back(current[f]);
+        }
+        current[f] = Accumulator();
+    }
+    windowStart = now;
+
+    // Nobody took the last batch, keep the newest windows
+    if (windows.size() == MAX_WINDOWS)
+        windows.erase(windows.begin());
+    windows.push_back(w);
+    return windows.size() >= TELEMETRY_BATCH_WINDOWS;
+}
+
+size_t TelemetryAggregator::encodeFrom(size_t first, uint8_t *buf, size_t len) const
+{
+    size_t pos = 0;
+    uint8_t count = windows.size() - first;
+    uint32_t end = windows.back().end;
+    // The first window after boot only starts with its first sample, so go by the spacing of the ends where possible
+    uint32_t windowSecs = count > 1 ? (end - windows[first].end) / (count - 1) : end - windows[first].start;
+    uint32_t fields = 0;
+    for (size_t i = first; i < windows.size(); i++)
+        fields |= windows[i].fields;
+
+    if (!putVarint(buf, len, pos, VERSION) || !putVarint(buf, len, pos, variant) ||
+        !putVarint(buf, len, pos, end) || !putVarint(buf, len, pos, windowSecs) || !putVarint(buf, len, pos, count) ||
+        !putVarint(buf, len, pos, fields))
+        return 0;
+
+    for (uint8_t f = 0; f < current.size(); f++) {
+        if (!(fields & (1UL << f)))
+            continue;
+        uint8_t present = 0;
+        for (uint8_t w = 0; w < count; w++)
+            if (windows[first + w].fields & (1UL << f))
+                present |= 1 << w;
+        if (pos >= len)
+            return 0;
+        buf[pos++] = present;
+
+        int32_t prevMean = 0;
+        for (uint8_t w = 0; w < count; w++) {
+            const Window &window = windows[first + w];
+            if (!(window.fields & (1UL << f)))
+                continue;
+            // The stats only hold the fields with samples, in order
+            uint8_t index = 0;
+            for (uint8_t k = 0; k < f; k++)
+                if (window.fields & (1UL << k))
+                    index++;
+            const Accumulator &a = window.stats[index];
+            int32_t mean = (int32_t)llround((double)a.sum / a.count);
+            if (!putVarint(buf, len, pos, zigzag(mean - prevMean)) || !putVarint(buf, len, pos, mean - a.min) ||
+                !putVarint(buf, len, pos, a.max - mean))
+                return 0;
+            prevMean = mean;
+        }
+    }
+    return pos;
+}
+
+size_t TelemetryAggregator::encode(uint8_t *buf, size_t len)
+{
+    size_t written = 0;
+    for (size_t first = 0; first < windows.size() && !written; first++)
+        written = encodeFrom(first, buf, len);
+    windows.clear();
+    return written;
+}
+
+namespace TelemetryBatch
+{
+
+uint8_t expand(const meshtastic_MeshPacket &mp, void (*deliver)(meshtastic_MeshPacket *p, RxSource src), RxSource src)
+{
+    Batch batch;
+    if (!decode(mp.decoded.payload.bytes, mp.decoded.payload.size, batch)) {
+        LOG_WARN("Invalid telemetry batch from 0x%x", getFrom(&mp));
+        return 0;
+    }
+    LOG_DEBUG("Expand telemetry batch from 0x%x: %u windows of %u s, variant %u", getFrom(&mp), batch.count, batch.windowSecs,
+              batch.variant);
+
+    for (uint8_t w = 0; w < batch.count; w++) {
+        meshtastic_Telemetry m;
+        getMeans(batch, w, m);
+        meshtastic_MeshPacket *p = packetPool.allocCopy(mp);
+        p->id = generatePacketId();
+        if (m.time)
+            p->rx_time = m.time;
+        p->decoded.portnum = meshtastic_PortNum_TELEMETRY_APP;
+        p->decoded.payload.size =
+            pb_encode_to_bytes(p->decoded.payload.bytes, sizeof(p->decoded.payload.bytes), &meshtastic_Telemetry_msg, &m);
+
+        // Keep hops away intact, but make sure nobody relays the window on its own
+        p->hop_start = p->hop_start > p->hop_limit ? p->hop_start - p->hop_limit : 0;
+        p->hop_limit = 0;
+
+        deliver(p, src);
+    }
+    return batch.count;
+}
+
+bool send(TelemetryAggregator &aggregator)
+{
+    meshtastic_MeshPacket *p = router->allocForSending();
+    p->decoded.portnum = TELEMETRY_BATCH_PORTNUM;
+    p->decoded.payload.size = aggregator.encode(p->decoded.payload.bytes, sizeof(p->decoded.payload.bytes));
+    if (!p->decoded.payload.size) {
+        packetPool.release(p);
+        return false;
+    }
+    p->to = NODENUM_BROADCAST;
+    p->decoded.want_response = false;
+    if (config.device.role == meshtastic_Config_DeviceConfig_Role_SENSOR)
+        p->priority = meshtastic_MeshPacket_Priority_RELIABLE;
+    else
+        p->priority = meshtastic_MeshPacket_Priority_BACKGROUND;
+    LOG_INFO("Send telemetry batch, %u bytes", p->decoded.payload.size);
+    // The phone can't read the batch itself, and our own packets don't loop back through the router, so hand it the windows
+    expand(*p, [](meshtastic_MeshPacket *w, RxSource) { service->sendToPhone(w); }, RX_SRC_LOCAL);
+    service->sendToMesh(p, RX_SRC_LOCAL, false);
+    return true;
+}
+
+} // namespace TelemetryBatch
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "mesh/generated/meshtastic/telemetry.pb.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Send environment, power, air quality and health telemetry as batches of min/mean/max windows instead of single samples.
+// Only firmware that knows the batch format can read them (others still relay them), so this is off by default.
+#ifndef TELEMETRY_BATCHING
+#define TELEMETRY_BATCHING 0
+#endif
+
+// Windows in a batch, each one covers one telemetry update interval
+#ifndef TELEMETRY_BATCH_WINDOWS
+#define TELEMETRY_BATCH_WINDOWS 4
+#endif
+
+// How often the sensors are sampled into the current window
+#ifndef TELEMETRY_BATCH_SAMPLE_SECS
+#define TELEMETRY_BATCH_SAMPLE_SECS 60
+#endif
+
+/// Unassigned portnum of the core range for batches, next to AGGREGATE_PORTNUM, until an official one is assigned.
+/// Not TELEMETRY_APP: nodes without support would fail to decode a batch there and stop it from being relayed.
+#define TELEMETRY_BATCH_PORTNUM ((meshtastic_PortNum)62)
+
+/**
+ * A compact encoding for several windows of telemetry, sent on TELEMETRY_BATCH_PORTNUM in place of Telemetry protobufs.
+ *
+ * Layout, with all numbers as varints:
+ *   version
+ *   variant       which_variant of the Telemetry the samples came from
+ *   time          end of the last window, seconds since 1970 (0 if unknown)
+ *   window        length of a window in seconds
+ *   count         number of windows, oldest first
+ *   fields        bit i set if field i of the variant (see fieldName()) is in the batch
+ * and then for each of those fields a byte with a bit per window that has samples of it, followed for each such window
+ * by the change of the mean since the field's previous window (zigzag), mean - min and max - mean. Values are fixed point
+ * with a precision that depends on the field.
+ */
+namespace TelemetryBatch
+{
+
+static const uint8_t VERSION = 1;
+static const uint8_t MAX_WINDOWS = 8;
+static_assert(TELEMETRY_BATCH_WINDOWS >= 1 && TELEMETRY_BATCH_WINDOWS <= MAX_WINDOWS,
+              "TELEMETRY_BATCH_WINDOWS must be between 1 and TelemetryBatch::MAX_WINDOWS");
+
+struct Stats {
+    float min, mean, max;
+};
+
+struct Batch {
+    pb_size_t variant = 0;
+    uint32_t time = 0;
+    uint32_t windowSecs = 0;
+    uint8_t count = 0;
+
+    struct Entry {
+        uint8_t window, field;
+        int32_t min, mean, max;
+    };
+    std::vector<Entry> entries;
+};
+
+/// True if the packet carries a batch rather than a single Telemetry
+bool isBatch(const meshtastic_MeshPacket &mp);
+
+bool decode(const uint8_t *buf, size_t len, Batch &batch);
+
+/// Number of fields of a Telemetry variant that a batch can carry, 0 if the variant can't be batched
+uint8_t numFields(pb_size_t variant);
+
+/// Name of a field as used in the MQTT JSON
+const char *fieldName(pb_size_t variant, uint8_t field);
+
+/// Stats of one field in one window, false if the window had no samples of it
+bool getStats(const Batch &batch, uint8_t window, uint8_t field, Stats &stats);
+
+/// End of a window, seconds since 1970
+uint32_t windowEnd(const Batch &batch, uint8_t window);
+
+/// A Telemetry with the mean of every field of one window, for receivers that only know single samples
+void getMeans(const Batch &batch, uint8_t window, meshtastic_Telemetry &m);
+
+/**
+ * Pass a freshly allocated TELEMETRY_APP packet per window of a batch to deliver(), which must release them, so that the
+ * telemetry modules (screen) and phone apps which only know single samples still get them.
+ * Like the records of an aggregate container they have their hop_limit zeroed, so only the batch itself is ever relayed.
+ * @return number of windows delivered
+ */
+uint8_t expand(const meshtastic_MeshPacket &mp, void (*deliver)(meshtastic_MeshPacket *p, RxSource src), RxSource src);
+
+} // namespace TelemetryBatch
+
+/**
+ * Collects the samples of one Telemetry variant into windows and encodes them as a batch.
+ */
+class TelemetryAggregator
+{
+  public:
+    explicit TelemetryAggregator(pb_size_t variant);
+
+    /// Add a sample to the current window, 'nowMs' as from millis()
+    void add(const meshtastic_Telemetry &sample, uint32_t nowMs);
+
+    /// True if TELEMETRY_BATCH_SAMPLE_SECS have passed since the last sample was added
+    bool isSampleDue(uint32_t nowMs) const { return !sampled || nowMs - lastSampleMs >= TELEMETRY_BATCH_SAMPLE_SECS * 1000UL; }
+
+    /**
+     * End the current window at 'now' (seconds since 1970) and start the next one.
+     * @return true once TELEMETRY_BATCH_WINDOWS windows are waiting to be sent
+     */
+    bool closeWindow(uint32_t now);
+
+    /**
+     * Encode the finished windows and forget them. If they don't all fit, the oldest are left out.
+     * @return length of the batch, 0 if there was nothing to send
+     */
+    size_t encode(uint8_t *buf, size_t len);
+
+    uint8_t windowCount() const { return windows.size(); }
+
+  private:
+    struct Accumulator {
+        int64_t sum;
+        int32_t min, max;
+        uint16_t count;
+    };
+
+    struct Window {
+        uint32_t start, end;
+        uint32_t fields; // Bit per field with samples
+        std::vector<Accumulator> stats;
+    };
+
+    pb_size_t variant;
+    bool sampled = false;
+    uint32_t lastSampleMs = 0;
+    uint32_t windowStart = 0;
+    std::vector<Accumulator> current;
+    std::vector<Window> windows;
+
+    size_t encodeFrom(size_t first, uint8_t *buf, size_t len) const;
+};
+
+namespace TelemetryBatch
+{
+
+/// Encode the windows waiting in 'aggregator' and broadcast them
+bool send(TelemetryAggregator &aggregator);
+
+} // namespace TelemetryBatch
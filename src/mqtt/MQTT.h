@@ -59,6 +59,7 @@ class MQTT : private concurrency::OSThread
     void start() { setIntervalFromNow(0); };
 
     bool isUsingDefaultServer() { return isConfiguredForDefaultServer; }
+    int getQueueDepth() { return mqttQueue.numUsed(); }
     bool isUsingDefaultRootTopic() { return isConfiguredForDefaultRootTopic; }
 
     /// Validate the meshtastic_ModuleConfig_MQTTConfig.
@@ -0,0 +1,91 @@
+#include "PacketReplay.h"
+#include "PacketTrace.h"
+#include "configuration.h"
+#include "main.h"
+#include "mesh/PacketProfiler.h"
+#include "mesh/Router.h"
+#include "mesh/mesh-pb-constants.h"
+
+#include <cstring>
+
+PacketReplay *packetReplay;
+
+PacketReplay::PacketReplay(const char *path, float speed) : concurrency::OSThread("PacketReplay"), speed(speed)
+{
+    file = fopen(path, "rb");
+    if (!file) {
+        LOG_ERROR("Unable to open packet trace %s for replay", path);
+        disable();
+        return;
+    }
+    LOG_INFO("Replay packets from %s at %s", path, speed > 0 ? "recorded pace" : "full speed");
+    haveNext = readNext();
+}
+
+PacketReplay::~PacketReplay()
+{
+    if (file)
+        fclose(file);
+}
+
+bool PacketReplay::readNext()
+{
+    uint8_t buf[PACKET_TRACE_HEADER_LEN + meshtastic_MeshPacket_size];
+    uint8_t lenBytes[2];
+
+    while (fread(lenBytes, 1, sizeof(lenBytes), file) == sizeof(lenBytes)) {
+        // Every time meshtasticd opens a trace it appends the magic again
+        if (memcmp(lenBytes, PACKET_TRACE_MAGIC, sizeof(lenBytes)) == 0) {
+            fseek(file, strlen(PACKET_TRACE_MAGIC) - sizeof(lenBytes), SEEK_CUR);
+            continue;
+        }
+        uint16_t len = lenBytes[0] | (lenBytes[1] << 8);
+        if (len < PACKET_TRACE_HEADER_LEN || len > sizeof(buf) || fread(buf, 1, len, file) != len) {
+            LOG_WARN("Truncated or corrupt packet trace, stop replay");
+            return false;
+        }
+        if ((TraceEvent)buf[0] != TraceEvent::ENQUEUE)
+            continue;
+
+        nextUsec = 0;
+        for (uint8_t i = 0; i < 8; i++)
+            nextUsec |= (uint64_t)buf[2 + i] << (8 * i);
+        next = meshtastic_MeshPacket_init_zero;
+        if (pb_decode_from_bytes(buf + PACKET_TRACE_HEADER_LEN, len - PACKET_TRACE_HEADER_LEN, &meshtastic_MeshPacket_msg,
+                                 &next))
+            return true;
+    }
+    return false;
+}
+
+int32_t PacketReplay::runOnce()
+{
+    if (!router)
+        return 1000; // Not up yet
+
+    if (!haveNext) {
+        LOG_INFO("Replay done, injected %u packets in %u ms", injected, millis() - startMsec);
+        PacketProfiler::log();
+        return disable();
+    }
+
+    if (!injected) {
+        firstUsec = nextUsec;
+        startMsec = millis();
+        PacketProfiler::reset();
+    }
+
+    if (speed > 0) {
+        uint32_t dueMsec = (nextUsec - firstUsec) / 1000 / speed;
+        uint32_t elapsed = millis() - startMsec;
+        if (elapsed < dueMsec)
+            return dueMsec - elapsed;
+    }
+
+    router->enqueueReceivedMessage(packetPool.allocCopy(next));
+    injected++;
+    haveNext = readNext();
+
+    // One packet per run, so the router gets to handle it before the small fromRadioQueue overflows
+    return 0;
+}
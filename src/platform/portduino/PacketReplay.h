@@ -0,0 +1,41 @@
+#pragma once
+
+#include "concurrency/OSThread.h"
+#include "mesh/generated/meshtastic/mesh.pb.h"
+
+#include <cstdio>
+
+/**
+ * Feeds the packets captured in a binary packet trace (see PacketTrace.h) back into the router, to reproduce field problems
+ * and profile meshtasticd on real traffic. Only TraceEvent::ENQUEUE records are replayed, which is every packet that was
+ * handed to Router::enqueueReceivedMessage, whatever interface it came from.
+ *
+ * With a speed of 0 packets are injected as fast as the router takes them, otherwise the recorded spacing is kept, divided
+ * by the speed. When done the per-stage timings of PacketProfiler are logged.
+ */
+class PacketReplay : private concurrency::OSThread
+{
+  public:
+    PacketReplay(const char *path, float speed);
+    ~PacketReplay();
+
+  protected:
+    virtual int32_t runOnce() override;
+
+  private:
+    FILE *file;
+    float speed;
+
+    meshtastic_MeshPacket next;
+    uint64_t nextUsec = 0;
+    bool haveNext = false;
+
+    uint64_t firstUsec = 0;
+    uint32_t startMsec = 0;
+    uint32_t injected = 0;
+
+    /// Read up to the next replayable record into 'next'
+    bool readNext();
+};
+
+extern PacketReplay *packetReplay;
@@ -0,0 +1,105 @@
+#include "PacketTrace.h"
+#include "RTC.h"
+#include "configuration.h"
+#include "mesh/mesh-pb-constants.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+PacketTrace *packetTrace;
+
+PacketTrace::~PacketTrace()
+{
+    close();
+}
+
+bool PacketTrace::open(const std::string &path)
+{
+    file = fopen(path.c_str(), "ab");
+    if (!file)
+        return false;
+
+    // A new file, or a file we append to, gets the magic so traces can be concatenated
+    fwrite(PACKET_TRACE_MAGIC, 1, strlen(PACKET_TRACE_MAGIC), file);
+    fflush(file);
+
+    filling.reserve(PACKET_TRACE_BUFFER_SIZE);
+    draining.reserve(PACKET_TRACE_BUFFER_SIZE);
+    writer = std::thread(&PacketTrace::writerLoop, this);
+    return true;
+}
+
+void PacketTrace::close()
+{
+    if (!file)
+        return;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    fclose(file);
+    file = nullptr;
+}
+
+void PacketTrace::record(TraceEvent event, const meshtastic_MeshPacket *p, TraceDropReason reason)
+{
+    if (!file)
+        return;
+
+    uint8_t rec[2 + PACKET_TRACE_HEADER_LEN + meshtastic_MeshPacket_size];
+    size_t len = pb_encode_to_bytes(rec + 2 + PACKET_TRACE_HEADER_LEN, meshtastic_MeshPacket_size, &meshtastic_MeshPacket_msg, p);
+    if (!len)
+        return;
+
+    uint64_t usec =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    uint32_t now = getValidTime(RTCQualityNone, false);
+    uint16_t recLen = PACKET_TRACE_HEADER_LEN + len;
+
+    uint8_t *h = rec;
+    *h++ = recLen & 0xff;
+    *h++ = recLen >> 8;
+    *h++ = (uint8_t)event;
+    *h++ = (uint8_t)reason;
+    for (uint8_t i = 0; i < 8; i++)
+        *h++ = (usec >> (8 * i)) & 0xff;
+    for (uint8_t i = 0; i < 4; i++)
+        *h++ = (now >> (8 * i)) & 0xff;
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (filling.size() + 2 + recLen > PACKET_TRACE_BUFFER_SIZE) {
+        dropped++;
+        return;
+    }
+    filling.insert(filling.end(), rec, rec + 2 + recLen);
+}
+
+void PacketTrace::writerLoop()
+{
+    uint32_t reportedDropped = 0;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wake.wait_for(guard, std::chrono::milliseconds(PACKET_TRACE_FLUSH_MSEC));
+        bool stop = stopping;
+        filling.swap(draining);
+        uint32_t newlyDropped = dropped - reportedDropped;
+        reportedDropped = dropped;
+
+        // Write without holding the lock, so record() never waits for the disk
+        guard.unlock();
+        if (!draining.empty()) {
+            fwrite(draining.data(), 1, draining.size(), file);
+            fflush(file);
+            draining.clear();
+        }
+        if (newlyDropped) // Not LOG_WARN, this isn't one of our OSThreads
+            std::cerr << "*** Packet trace fell behind, dropped " << newlyDropped << " records" << std::endl;
+        guard.lock();
+
+        if (stop && filling.empty())
+            break;
+    }
+}
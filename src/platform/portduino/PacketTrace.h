@@ -0,0 +1,108 @@
+#pragma once
+
+#include "configuration.h"
+
+#if ARCH_PORTDUINO
+#include "mesh/generated/meshtastic/mesh.pb.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Binary packet trace for meshtasticd, a compact alternative to the JSON trace for long running captures.
+ *
+ * The file starts with the 8 byte magic PACKET_TRACE_MAGIC, followed by records of (all integers little endian):
+ *
+ *   [u16 length of the rest of the record][u8 event][u8 reason][u64 monotonic usec][u32 unix time][MeshPacket protobuf]
+ *
+ * The MeshPacket is the packet as we had it at the time of the event, so encrypted for rx and tx, decoded for decode.
+ * bin/meshtastic-trace.py converts traces to JSON or CSV, PacketReplay feeds them back into meshtasticd.
+ */
+
+#define PACKET_TRACE_MAGIC "MTTRACE1"
+#define PACKET_TRACE_HEADER_LEN 14 // Everything after the length field, before the packet
+
+/// Flush to disk at least this often, so a crash loses little
+#define PACKET_TRACE_FLUSH_MSEC 1000
+
+/// Records are dropped (and counted) rather than block the mesh if the disk falls this far behind
+#define PACKET_TRACE_BUFFER_SIZE (256 * 1024)
+
+enum class TraceEvent : uint8_t {
+    RX = 1,      // Received from the radio (or UDP/MQTT), before any filtering
+    DECODE = 2,  // Successfully decrypted and decoded
+    ROUTE = 3,   // Relayed on behalf of another node
+    TX = 4,      // Originated by us, handed to the radio
+    DROP = 5,    // Dropped, see TraceDropReason
+    RADIO = 6,   // Captured in RadioLibInterface::handleReceiveInterrupt, with the receive metadata
+    ENQUEUE = 7, // Handed to Router::enqueueReceivedMessage by any interface, this is what PacketReplay replays
+};
+
+enum class TraceDropReason : uint8_t {
+    NONE = 0,
+    IGNORE_LIST = 1,     // Sender is in config.lora.ignore_incoming
+    IGNORED_NODE = 2,    // Sender is marked as ignored in the NodeDB
+    FROM_BROADCAST = 3,  // Invalid sender
+    IGNORE_MQTT = 4,     // Came via MQTT while config.lora.ignore_mqtt is set
+    FILTERED = 5,        // Router::shouldFilterReceived, e.g. a duplicate
+    DECODE_FAILURE = 6,  // No channel could decrypt it
+};
+
+class PacketTrace
+{
+  public:
+    ~PacketTrace();
+
+    /// Open (append to) the trace file and start the writer thread
+    bool open(const std::string &path);
+
+    /// Flush everything and stop the writer thread
+    void close();
+
+    /// Append a record, never blocks on disk I/O
+    void record(TraceEvent event, const meshtastic_MeshPacket *p, TraceDropReason reason = TraceDropReason::NONE);
+
+    /// Number of records lost because the writer fell behind
+    uint32_t getDropped() const { return dropped; }
+
+  private:
+    FILE *file = nullptr;
+    std::thread writer;
+    std::mutex lock;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    // Records are appended to 'filling', the writer thread swaps it with 'draining' and writes it out
+    std::vector<uint8_t> filling;
+    std::vector<uint8_t> draining;
+    uint32_t dropped = 0;
+
+    void writerLoop();
+};
+
+extern PacketTrace *packetTrace;
+
+// Record a packet in the binary trace, if one is being written
+#define TRACE_PACKET(event, p)                                                                                                   \
+    do {                                                                                                                         \
+        if (packetTrace)                                                                                                         \
+            packetTrace->record(event, p);                                                                                       \
+    } while (0)
+#define TRACE_DROP(reason, p)                                                                                                    \
+    do {                                                                                                                         \
+        if (packetTrace)                                                                                                         \
+            packetTrace->record(TraceEvent::DROP, p, TraceDropReason::reason);                                                   \
+    } while (0)
+#else
+// Statements rather than nothing, so they can be the body of an if
+#define TRACE_PACKET(event, p)                                                                                                   \
+    do {                                                                                                                         \
+    } while (0)
+#define TRACE_DROP(reason, p)                                                                                                    \
+    do {                                                                                                                         \
+    } while (0)
+#endif
@@ -5,6 +5,7 @@
 #include "sleep.h"
 #include "target_specific.h"
 
+#include "PacketTrace.h"
 #include "PortduinoGlue.h"
 #include "api/ServerAPI.h"
 #include "linux/gpio/LinuxGPIOPin.h"
@@ -34,6 +35,8 @@ Ch341Hal *ch341Hal = nullptr;
 char *configPath = nullptr;
 char *optionMac = nullptr;
 bool forceSimulated = false;
+char *replayPath = nullptr;
+float replaySpeed = 1;
 
 // FIXME - move setBluetoothEnable into a HALPlatform class
 void setBluetoothEnable(bool enable)
@@ -68,6 +71,13 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state)
     case 'h':
         optionMac = arg;
         break;
+    case 'r':
+        replayPath = arg;
+        break;
+    case 0x100:
+        if (sscanf(arg, "%f", &replaySpeed) < 1)
+            return ARGP_ERR_UNKNOWN;
+        break;
 
     case ARGP_KEY_ARG:
         return 0;
@@ -83,6 +93,8 @@ void portduinoCustomInit()
                                            {"config", 'c', "CONFIG_PATH", 0, "Full path of the .yaml config file to use."},
                                            {"hwid", 'h', "HWID", 0, "The mac address to assign to this virtual machine"},
                                            {"sim", 's', 0, 0, "Run in Simulated radio mode"},
+                                           {"replay", 'r', "TRACE", 0, "Replay received packets from a binary packet trace"},
+                                           {"replay-speed", 0x100, "FACTOR", 0, "Replay speed, 0 for as fast as possible"},
                                            {0}};
     static void *childArguments;
     static char doc[] = "Meshtastic native build.";
@@ -369,6 +381,14 @@ void portduinoSetup()
             exit(EXIT_FAILURE);
         }
     }
+    if (settingsStrings[binaryTraceFilename] != "") {
+        packetTrace = new PacketTrace();
+        if (!packetTrace->open(settingsStrings[binaryTraceFilename])) {
+            std::cout << "*** Unable to open binary trace file " << settingsStrings[binaryTraceFilename] << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        atexit([] { packetTrace->close(); });
+    }
 
     return;
 }
@@ -411,6 +431,7 @@ bool loadConfig(const char *configPath)
                 settingsMap[logoutputlevel] = level_error;
             }
             settingsStrings[traceFilename] = yamlConfig["Logging"]["TraceFile"].as<std::string>("");
+            settingsStrings[binaryTraceFilename] = yamlConfig["Logging"]["BinaryTraceFile"].as<std::string>("");
             if (yamlConfig["Logging"]["AsciiLogs"]) {
                 // Default is !isatty(1) but can be set explicitly in config.yaml
                 settingsMap[ascii_logs] = yamlConfig["Logging"]["AsciiLogs"].as<bool>();
@@ -90,6 +90,7 @@ enum configNames {
     pointerDevice,
     logoutputlevel,
     traceFilename,
+    binaryTraceFilename,
     webserver,
     webserverport,
     webserverrootpath,
@@ -111,6 +112,8 @@ enum { level_error, level_warn, level_info, level_debug, level_trace };
 extern std::map<configNames, int> settingsMap;
 extern std::map<configNames, std::string> settingsStrings;
 extern std::ofstream traceFile;
+extern char *replayPath;
+extern float replaySpeed;
 extern Ch341Hal *ch341Hal;
 int initGPIOPin(int pinNum, std::string gpioChipname, int line);
 bool loadConfig(const char *configPath);
@@ -183,7 +183,7 @@ void SimRadio::onNotify(uint32_t notification)
                     startSend(txp);
                     // Packet has been sent, count it toward our TX airtime utilization.
                     uint32_t xmitMsec = getPacketTime(txp);
-                    airTime->logAirtime(TX_LOG, xmitMsec);
+                    airTime->logAirtime(TX_LOG, xmitMsec, txp);
 
                     notifyLater(xmitMsec, ISR_TX, false); // Model the time it is busy sending
                 }
@@ -311,7 +311,7 @@ void SimRadio::handleReceiveInterrupt()
 
     printPacket("Lora RX", mp);
 
-    airTime->logAirtime(RX_LOG, getPacketTime(mp));
+    airTime->logAirtime(RX_LOG, getPacketTime(mp), mp);
 
     deliverToReceiver(mp);
 }
@@ -5,6 +5,7 @@
 #include "mesh/generated/meshtastic/mqtt.pb.h"
 #include "mesh/generated/meshtastic/telemetry.pb.h"
 #include "modules/RoutingModule.h"
+#include "modules/Telemetry/TelemetryBatch.h"
 #include <DebugConfiguration.h>
 #include <mesh-pb-constants.h>
 #if defined(ARCH_ESP32)
@@ -15,6 +16,33 @@
 
 static const char *errStr = "Error decoding proto for %s message!";
 
+/// The min/mean/max of every field per window of a telemetry batch
+static JSONObject serializeTelemetryBatch(const TelemetryBatch::Batch &batch)
+{
+    JSONArray windows;
+    uint8_t numFields = TelemetryBatch::numFields(batch.variant);
+    for (uint8_t w = 0; w < batch.count; w++) {
+        JSONObject window;
+        window["time"] = new JSONValue((unsigned int)TelemetryBatch::windowEnd(batch, w));
+        for (uint8_t f = 0; f < numFields; f++) {
+            TelemetryBatch::Stats stats;
+            if (!TelemetryBatch::getStats(batch, w, f, stats))
+                continue;
+            JSONObject field;
+            field["min"] = new JSONValue(stats.min);
+            field["mean"] = new JSONValue(stats.mean);
+            field["max"] = new JSONValue(stats.max);
+            window[TelemetryBatch::fieldName(batch.variant, f)] = new JSONValue(field);
+        }
+        windows.push_back(new JSONValue(window));
+    }
+
+    JSONObject payload;
+    payload["window"] = new JSONValue((unsigned int)batch.windowSecs);
+    payload["batch"] = new JSONValue(windows);
+    return payload;
+}
+
 std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp, bool shouldLog)
 {
     // the created jsonObj is immutable after creation, so
@@ -24,7 +52,7 @@ std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp,
 
     if (mp->which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
         JSONObject msgPayload;
-        switch (mp->decoded.portnum) {
+        switch ((int)mp->decoded.portnum) { // Also unassigned portnums, like TELEMETRY_BATCH_PORTNUM
         case meshtastic_PortNum_TEXT_MESSAGE_APP: {
             msgType = "text";
             // convert bytes to string
@@ -53,6 +81,15 @@ std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp,
             }
             break;
         }
+        case TELEMETRY_BATCH_PORTNUM: {
+            msgType = "telemetry";
+            TelemetryBatch::Batch batch;
+            if (TelemetryBatch::decode(mp->decoded.payload.bytes, mp->decoded.payload.size, batch))
+                jsonObj["payload"] = new JSONValue(serializeTelemetryBatch(batch));
+            else if (shouldLog)
+                LOG_ERROR(errStr, msgType.c_str());
+            break;
+        }
         case meshtastic_PortNum_TELEMETRY_APP: {
             msgType = "telemetry";
             meshtastic_Telemetry scratch;
@@ -8,6 +8,7 @@
 #include "mesh/generated/meshtastic/remote_hardware.pb.h"
 #include "mesh/generated/meshtastic/telemetry.pb.h"
 #include "modules/RoutingModule.h"
+#include "modules/Telemetry/TelemetryBatch.h"
 #include <DebugConfiguration.h>
 #include <mesh-pb-constants.h>
 
@@ -23,7 +24,7 @@ std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp,
     arrayObj.clear();
 
     if (mp->which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
-        switch (mp->decoded.portnum) {
+        switch ((int)mp->decoded.portnum) { // Also unassigned portnums, like TELEMETRY_BATCH_PORTNUM
         case meshtastic_PortNum_TEXT_MESSAGE_APP: {
             msgType = "text";
             // convert bytes to string
@@ -50,6 +51,31 @@ std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp,
             }
             break;
         }
+        case TELEMETRY_BATCH_PORTNUM: {
+            msgType = "telemetry";
+            TelemetryBatch::Batch batch;
+            if (TelemetryBatch::decode(mp->decoded.payload.bytes, mp->decoded.payload.size, batch)) {
+                uint8_t numFields = TelemetryBatch::numFields(batch.variant);
+                jsonObj["payload"]["window"] = (unsigned int)batch.windowSecs;
+                JsonArray windows = jsonObj["payload"].createNestedArray("batch");
+                for (uint8_t w = 0; w < batch.count; w++) {
+                    JsonObject window = windows.createNestedObject();
+                    window["time"] = (unsigned int)TelemetryBatch::windowEnd(batch, w);
+                    for (uint8_t f = 0; f < numFields; f++) {
+                        TelemetryBatch::Stats stats;
+                        if (!TelemetryBatch::getStats(batch, w, f, stats))
+                            continue;
+                        JsonObject field = window.createNestedObject(TelemetryBatch::fieldName(batch.variant, f));
+                        field["min"] = stats.min;
+                        field["mean"] = stats.mean;
+                        field["max"] = stats.max;
+                    }
+                }
+            } else if (shouldLog) {
+                LOG_ERROR("Error decoding proto for telemetry message!");
+            }
+            break;
+        }
         case meshtastic_PortNum_TELEMETRY_APP: {
             msgType = "telemetry";
             meshtastic_Telemetry scratch;
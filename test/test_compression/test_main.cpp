@@ -0,0 +1,190 @@
+#include "mesh/compression/TextCompression.h"
+#include "mesh/compression/unishox2.h"
+
+#include "TestUtil.h"
+#include <chrono>
+#include <unity.h>
+
+// Typical mesh chat, the dictionary was picked on these
+static const char *corpus[] = {
+    "Hello, is anyone out there?",
+    "Good morning everyone!",
+    "Heading to the trailhead now, should be there in 20 minutes",
+    "Are you on the summit yet?",
+    "Copy that, see you at the parking lot",
+    "Testing Meshtastic range from the ridge",
+    "Signal is great tonight",
+    "Anyone hearing me from downtown?",
+    "I'm going to check the repeater on the hill",
+    "Battery at 45%, switching to power saving",
+    "Thanks for the relay!",
+    "Where are you right now?",
+    "Meeting at the cafe at 3pm",
+    "Got your message, all good here",
+    "Weather is getting worse, heading back",
+    "ok",
+    "👍",
+    "Can anyone confirm they received this?",
+    "Just set up a new node on the roof",
+    "Is the Meshtastic meetup still happening tonight?",
+};
+
+// Chat the dictionary wasn't picked on, to compare it fairly against the stock unishox2 one
+static const char *heldOut[] = {
+    "Is the node on the water tower still up?",
+    "Just got home, thanks for the relay tonight",
+    "Anyone want to meet for the hike on Saturday?",
+    "The solar node is running low after three cloudy days",
+    "Can you hear me from the north side of the lake?",
+    "Turning off my radio for the night, talk tomorrow",
+    "I'm at the trailhead, waiting for you",
+    "Is anyone monitoring the emergency channel right now?",
+    "New antenna works great, getting much better signal",
+    "Thanks everyone for testing the mesh with me",
+    "Where should we put the next repeater?",
+    "Leaving the campsite in ten minutes",
+    "Nice, I can see your node on the map",
+    "Good evening from the valley",
+    "Did you get my last message?",
+    "Roads are icy, drive safe everyone",
+    "The router on the hill is back online",
+    "How many hops did that take?",
+    "yes",
+    "See you at the meeting tonight",
+};
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_roundtrip(void)
+{
+    for (auto msg : corpus) {
+        char compressed[meshtastic_Constants_DATA_PAYLOAD_LEN];
+        char decompressed[meshtastic_Constants_DATA_PAYLOAD_LEN + 1] = {};
+        int len = strlen(msg);
+
+        int compressedLen = TextCompression::compress(msg, len, compressed, sizeof(compressed));
+        TEST_ASSERT_GREATER_THAN(0, compressedLen);
+        int decompressedLen = TextCompression::decompress(compressed, compressedLen, decompressed, sizeof(decompressed) - 1);
+        TEST_ASSERT_EQUAL(len, decompressedLen);
+        TEST_ASSERT_EQUAL_MEMORY(msg, decompressed, len);
+    }
+}
+
+void test_never_larger(void)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+
+    // Receiving compressed text from a node makes it a peer we compress DMs for
+    const char *hello = "Hello from a node that supports compression";
+    p.from = 0x1234;
+    p.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP;
+    p.decoded.payload.size = TextCompression::compress(hello, strlen(hello), (char *)p.decoded.payload.bytes,
+                                                       sizeof(p.decoded.payload.bytes));
+    TEST_ASSERT_TRUE(TextCompression::perhapsDecompress(&p));
+
+    p.from = 0;
+    p.to = 0x1234;
+    for (auto msg : corpus) {
+        p.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+        p.decoded.payload.size = strlen(msg);
+        memcpy(p.decoded.payload.bytes, msg, p.decoded.payload.size);
+
+        size_t before = p.decoded.payload.size;
+        bool compressed = TextCompression::perhapsCompress(&p);
+        TEST_ASSERT_TRUE(p.decoded.payload.size <= before);
+        TEST_ASSERT_EQUAL(compressed, p.decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP);
+
+        TextCompression::perhapsDecompress(&p);
+        TEST_ASSERT_EQUAL(meshtastic_PortNum_TEXT_MESSAGE_APP, p.decoded.portnum);
+        TEST_ASSERT_EQUAL(before, p.decoded.payload.size);
+        TEST_ASSERT_EQUAL_MEMORY(msg, p.decoded.payload.bytes, before);
+    }
+}
+
+void test_relay_stays_compressed(void)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.from = 0x5678;
+    p.to = NODENUM_BROADCAST;
+    p.id = 0x1111;
+
+    // Text from another node that arrived compressed goes out compressed again when we relay it
+    const char *msg = "Is anyone monitoring the emergency channel right now?";
+    p.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP;
+    p.decoded.payload.size =
+        TextCompression::compress(msg, strlen(msg), (char *)p.decoded.payload.bytes, sizeof(p.decoded.payload.bytes));
+    size_t compressedLen = p.decoded.payload.size;
+    TEST_ASSERT_TRUE(TextCompression::perhapsDecompress(&p));
+    TEST_ASSERT_TRUE(TextCompression::perhapsCompress(&p));
+    TEST_ASSERT_EQUAL(meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP, p.decoded.portnum);
+    TEST_ASSERT_EQUAL(compressedLen, p.decoded.payload.size);
+
+    // Plain text from another node is relayed as it came
+    p.id = 0x2222;
+    p.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    p.decoded.payload.size = strlen(msg);
+    memcpy(p.decoded.payload.bytes, msg, p.decoded.payload.size);
+    TEST_ASSERT_FALSE(TextCompression::perhapsCompress(&p));
+    TEST_ASSERT_EQUAL(meshtastic_PortNum_TEXT_MESSAGE_APP, p.decoded.portnum);
+}
+
+void test_ratio_and_speed(void)
+{
+    size_t original = 0, mesh = 0, stock = 0;
+    char out[meshtastic_Constants_DATA_PAYLOAD_LEN];
+    char back[meshtastic_Constants_DATA_PAYLOAD_LEN];
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto msg : heldOut) {
+        int len = strlen(msg);
+        original += len;
+        mesh += min(len, TextCompression::compress(msg, len, out, sizeof(out)));
+    }
+    auto encoded = std::chrono::steady_clock::now();
+    for (auto msg : heldOut) {
+        int len = TextCompression::compress(msg, strlen(msg), out, sizeof(out));
+        TextCompression::decompress(out, len, back, sizeof(back));
+    }
+    auto decoded = std::chrono::steady_clock::now();
+    for (auto msg : heldOut) {
+        int len = strlen(msg);
+        stock += min(len, unishox2_compress_simple(msg, len, out));
+    }
+
+    size_t n = sizeof(heldOut) / sizeof(heldOut[0]);
+    auto encodeUs = std::chrono::duration_cast<std::chrono::microseconds>(encoded - start).count();
+    auto decodeUs = std::chrono::duration_cast<std::chrono::microseconds>(decoded - encoded).count() - encodeUs;
+    printf("Compressed %zu bytes of text to %zu (ratio %.3f), stock dictionary %zu (ratio %.3f)\n", original, mesh,
+           (float)mesh / original, stock, (float)stock / original);
+    printf("Encode %.1f us/msg, decode %.1f us/msg\n", (float)encodeUs / n, (float)max(decodeUs, (decltype(decodeUs))0) / n);
+
+    TEST_ASSERT_TRUE(mesh <= stock);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_roundtrip);
+    RUN_TEST(test_never_larger);
+    RUN_TEST(test_relay_stays_compressed);
+    RUN_TEST(test_ratio_and_speed);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,249 @@
+#include "gps/GPSStreamParser.h"
+
+#include "TestUtil.h"
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+// Not a capture from a receiver: the NMEA sentences are the examples of the u-blox M8 protocol specification, the
+// UBX-ACK/NAK frames are built by hand and the UBX-MON-VER answer is synthesized below with makeUbx()
+static const char *exampleNmea[] = {
+    "$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50\r\n",
+    "$GNRMC,083559.00,A,4717.11437,N,00833.91522,E,0.004,77.52,091202,,,A*49\r\n",
+    "$GNVTG,77.52,T,,M,0.004,N,0.008,K,A*18\r\n",
+    "$GNGGA,092725.00,4717.11399,N,00833.91590,E,1,08,1.01,499.6,M,48.0,M,,*45\r\n",
+    "$GNGSA,A,3,23,29,07,08,09,18,26,28,,,,,1.94,1.18,1.54*13\r\n",
+    "$GPGSV,3,1,10,23,38,230,44,29,71,156,47,07,29,116,41,08,09,081,36*7F\r\n",
+    "$GNGLL,4717.11364,N,00833.91565,E,092321.00,A,A*7E\r\n",
+};
+static const uint8_t ackCfgRate[] = {0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x06, 0x08, 0x16, 0x3F};
+static const uint8_t nakCfgGnss[] = {0xB5, 0x62, 0x05, 0x00, 0x02, 0x00, 0x06, 0x3E, 0x4B, 0x70};
+
+struct SeenFrame {
+    GPSStreamParser::FrameType type;
+    bool valid;
+    std::string data;
+};
+
+static void append(std::vector<uint8_t> &log, const char *s)
+{
+    log.insert(log.end(), s, s + strlen(s));
+}
+
+static void append(std::vector<uint8_t> &log, const uint8_t *b, size_t len)
+{
+    log.insert(log.end(), b, b + len);
+}
+
+static std::vector<uint8_t> makeUbx(uint8_t cls, uint8_t id, const std::vector<uint8_t> &payload)
+{
+    std::vector<uint8_t> f = {0xB5, 0x62, cls, id, (uint8_t)(payload.size() & 0xFF), (uint8_t)(payload.size() >> 8)};
+    f.insert(f.end(), payload.begin(), payload.end());
+    uint8_t a = 0, b = 0;
+    for (size_t i = 2; i < f.size(); i++) {
+        a += f[i];
+        b += a;
+    }
+    f.push_back(a);
+    f.push_back(b);
+    return f;
+}
+
+static std::vector<uint8_t> monVerPayload()
+{
+    std::vector<uint8_t> p(30 + 10 + 3 * 30, 0);
+    memcpy(&p[0], "ROM CORE 3.01 (107888)", 22);
+    memcpy(&p[30], "00080000", 8);
+    memcpy(&p[40], "FWVER=SPG 3.01", 14);
+    memcpy(&p[70], "PROTVER=18.00", 13);
+    memcpy(&p[100], "MOD=NEO-M8N-0", 13);
+    return p;
+}
+
+static std::vector<uint8_t> sampleLog()
+{
+    std::vector<uint8_t> log;
+    for (const char *s : exampleNmea)
+        append(log, s);
+    append(log, ackCfgRate, sizeof(ackCfgRate));
+    append(log, exampleNmea[1]);
+    append(log, nakCfgGnss, sizeof(nakCfgGnss));
+    std::vector<uint8_t> monVer = makeUbx(0x0A, 0x04, monVerPayload());
+    append(log, monVer.data(), monVer.size());
+    append(log, exampleNmea[3]);
+    return log;
+}
+
+// Feed the log in chunks of 'chunk' bytes and collect every frame
+static std::vector<SeenFrame> parse(GPSStreamParser &parser, const std::vector<uint8_t> &log, size_t chunk)
+{
+    std::vector<SeenFrame> seen;
+    for (size_t off = 0; off < log.size(); off += chunk) {
+        size_t len = std::min(chunk, log.size() - off);
+        const uint8_t *p = log.data() + off;
+        while (len) {
+            size_t n = parser.feed(p, len);
+            p += n;
+            len -= n;
+            const GPSStreamParser::Frame &f = parser.frame();
+            if (f.type != GPSStreamParser::FRAME_NONE)
+                seen.push_back({f.type, f.valid, std::string((const char *)f.data, f.len)});
+        }
+    }
+    return seen;
+}
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_sample_log(void)
+{
+    GPSStreamParser parser;
+    std::vector<SeenFrame> seen = parse(parser, sampleLog(), 4096);
+
+    TEST_ASSERT_EQUAL(12, seen.size());
+    for (const SeenFrame &f : seen)
+        TEST_ASSERT_TRUE(f.valid);
+    TEST_ASSERT_EQUAL(GPSStreamParser::FRAME_NMEA, seen[0].type);
+    TEST_ASSERT_EQUAL_STRING("$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50", seen[0].data.c_str());
+    TEST_ASSERT_EQUAL(GPSStreamParser::FRAME_UBX, seen[7].type);
+    TEST_ASSERT_EQUAL(GPSStreamParser::FRAME_UBX, seen[9].type);
+    TEST_ASSERT_EQUAL(GPSStreamParser::FRAME_UBX, seen[10].type);
+    TEST_ASSERT_EQUAL(9, parser.getNmeaPassed());
+    TEST_ASSERT_EQUAL(3, parser.getUbxPassed());
+    TEST_ASSERT_EQUAL(0, parser.getNmeaFailed());
+    TEST_ASSERT_EQUAL(0, parser.getUbxFailed());
+}
+
+void test_ubx_frames(void)
+{
+    GPSStreamParser parser;
+    std::vector<uint8_t> log;
+    append(log, ackCfgRate, sizeof(ackCfgRate));
+    std::vector<uint8_t> monVer = makeUbx(0x0A, 0x04, monVerPayload());
+    append(log, monVer.data(), monVer.size());
+
+    size_t n = parser.feed(log.data(), log.size());
+    TEST_ASSERT_EQUAL(sizeof(ackCfgRate), n);
+    const GPSStreamParser::Frame &ack = parser.frame();
+    TEST_ASSERT_EQUAL(0x05, ack.ubxClass);
+    TEST_ASSERT_EQUAL(0x01, ack.ubxId);
+    TEST_ASSERT_EQUAL(2, ack.payloadLen());
+    TEST_ASSERT_EQUAL(0x06, ack.payload()[0]);
+    TEST_ASSERT_EQUAL(0x08, ack.payload()[1]);
+
+    parser.feed(log.data() + n, log.size() - n);
+    const GPSStreamParser::Frame &ver = parser.frame();
+    TEST_ASSERT_TRUE(ver.valid);
+    TEST_ASSERT_EQUAL(0x0A, ver.ubxClass);
+    TEST_ASSERT_EQUAL(0x04, ver.ubxId);
+    TEST_ASSERT_EQUAL(130, ver.payloadLen());
+    TEST_ASSERT_EQUAL_STRING("00080000", (const char *)ver.payload() + 30);
+}
+
+// However the UART hands the bytes over, the same frames come out
+void test_split_feeding(void)
+{
+    std::vector<uint8_t> log = sampleLog();
+    GPSStreamParser whole;
+    std::vector<SeenFrame> expected = parse(whole, log, log.size());
+
+    for (size_t chunk : {1, 2, 3, 7, 16, 63, 64}) {
+        GPSStreamParser parser;
+        std::vector<SeenFrame> seen = parse(parser, log, chunk);
+        TEST_ASSERT_EQUAL(expected.size(), seen.size());
+        for (size_t i = 0; i < seen.size(); i++) {
+            TEST_ASSERT_EQUAL(expected[i].type, seen[i].type);
+            TEST_ASSERT_EQUAL(expected[i].valid, seen[i].valid);
+            TEST_ASSERT_TRUE(expected[i].data == seen[i].data);
+        }
+    }
+}
+
+void test_corrupted_input(void)
+{
+    GPSStreamParser parser;
+    std::vector<uint8_t> log;
+    // Flipped bit in a sentence
+    std::string gga = exampleNmea[3];
+    gga[20] ^= 0x01;
+    append(log, gga.c_str());
+    // Sentence cut off by the next one, which still has to be parsed
+    append(log, "$GNRMC,083559.00,A,4717");
+    append(log, exampleNmea[2]);
+    // No checksum
+    append(log, "$PDTINFO\r\n");
+    // UBX with a broken checksum, then line noise
+    std::vector<uint8_t> bad(ackCfgRate, ackCfgRate + sizeof(ackCfgRate));
+    bad[9] ^= 0xFF;
+    append(log, bad.data(), bad.size());
+    static const uint8_t noise[] = {0xB5, 0x00, 'x', 0x62, '\r', '\n'};
+    append(log, noise, sizeof(noise));
+    append(log, exampleNmea[6]);
+
+    std::vector<SeenFrame> seen = parse(parser, log, 5);
+    TEST_ASSERT_EQUAL(5, seen.size());
+    TEST_ASSERT_FALSE(seen[0].valid);
+    TEST_ASSERT_TRUE(seen[1].valid);
+    TEST_ASSERT_EQUAL_STRING("$GNVTG,77.52,T,,M,0.004,N,0.008,K,A*18", seen[1].data.c_str());
+    TEST_ASSERT_FALSE(seen[2].valid);
+    TEST_ASSERT_EQUAL(GPSStreamParser::FRAME_UBX, seen[3].type);
+    TEST_ASSERT_FALSE(seen[3].valid);
+    TEST_ASSERT_TRUE(seen[4].valid);
+    TEST_ASSERT_EQUAL(2, parser.getNmeaPassed());
+    TEST_ASSERT_EQUAL(3, parser.getNmeaFailed());
+    TEST_ASSERT_EQUAL(1, parser.getUbxFailed());
+}
+
+void test_oversized_ubx_is_skipped(void)
+{
+    GPSStreamParser parser;
+    std::vector<uint8_t> log = makeUbx(0x01, 0x35, std::vector<uint8_t>(GPS_PARSER_FRAME_SIZE, '$'));
+    append(log, exampleNmea[1]);
+
+    std::vector<SeenFrame> seen = parse(parser, log, 32);
+    TEST_ASSERT_EQUAL(1, seen.size());
+    TEST_ASSERT_EQUAL(GPSStreamParser::FRAME_NMEA, seen[0].type);
+    TEST_ASSERT_TRUE(seen[0].valid);
+    TEST_ASSERT_EQUAL(1, parser.getOverflows());
+}
+
+void test_nmea_checksum(void)
+{
+    const char *s = exampleNmea[5];
+    for (size_t len = 0; len < strlen(s); len++) {
+        uint8_t expected = 0;
+        for (size_t i = 0; i < len; i++)
+            expected ^= s[i];
+        TEST_ASSERT_EQUAL(expected, GPSStreamParser::nmeaChecksum((const uint8_t *)s, len));
+    }
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_log);
+    RUN_TEST(test_ubx_frames);
+    RUN_TEST(test_split_feeding);
+    RUN_TEST(test_corrupted_input);
+    RUN_TEST(test_oversized_ubx_is_skipped);
+    RUN_TEST(test_nmea_checksum);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
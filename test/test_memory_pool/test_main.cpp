@@ -0,0 +1,170 @@
+#include "mesh/MemoryPool.h"
+#include "mesh/generated/meshtastic/mesh.pb.h"
+
+#include "TestUtil.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unity.h>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#define SLAB_CAPACITY 64
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_alloc_release(void)
+{
+    MemorySlab<meshtastic_MeshPacket> slab(SLAB_CAPACITY);
+    meshtastic_MeshPacket *p[SLAB_CAPACITY];
+
+    for (int i = 0; i < SLAB_CAPACITY; i++) {
+        p[i] = slab.allocZeroed();
+        TEST_ASSERT_EQUAL(0, (uintptr_t)p[i] % SLAB_ALIGN);
+        TEST_ASSERT_EQUAL(0, p[i]->id);
+        p[i]->id = i; // Must not overlap with any other slot
+    }
+    for (int i = 0; i < SLAB_CAPACITY; i++)
+        TEST_ASSERT_EQUAL(i, p[i]->id);
+    TEST_ASSERT_EQUAL(0, slab.getExhausted());
+
+    for (int i = 0; i < SLAB_CAPACITY; i++)
+        slab.release(p[i]);
+}
+
+void test_exhaustion(void)
+{
+    MemorySlab<meshtastic_MeshPacket> slab(SLAB_CAPACITY);
+    std::vector<meshtastic_MeshPacket *> held;
+
+    // More than we have slots, plus whatever the thread cache holds
+    for (int i = 0; i < 2 * SLAB_CAPACITY; i++)
+        held.push_back(slab.allocZeroed());
+    TEST_ASSERT_EQUAL(SLAB_CAPACITY, slab.getHighWater());
+    TEST_ASSERT_EQUAL(SLAB_CAPACITY, slab.getExhausted());
+
+    for (auto p : held)
+        slab.release(p);
+    TEST_ASSERT_TRUE(slab.getInUse() <= SLAB_THREAD_CACHE);
+
+    // The released slots are all usable again
+    held.clear();
+    for (int i = 0; i < SLAB_CAPACITY; i++)
+        held.push_back(slab.allocZeroed());
+    TEST_ASSERT_EQUAL(SLAB_CAPACITY, slab.getExhausted());
+    for (auto p : held)
+        slab.release(p);
+}
+
+void test_threads(void)
+{
+    static MemorySlab<meshtastic_MeshPacket> slab(SLAB_CAPACITY);
+    static std::atomic<uint32_t> corrupted;
+    std::vector<std::thread> threads;
+
+    // Packets are allocated on one thread and released on another all the time (e.g. the phone API)
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t] {
+            std::vector<meshtastic_MeshPacket *> held;
+            for (int i = 0; i < 10000; i++) {
+                meshtastic_MeshPacket *p = slab.allocZeroed();
+                p->id = t;
+                held.push_back(p);
+                if (held.size() == 8) {
+                    for (auto h : held) {
+                        if (h->id != (uint32_t)t)
+                            corrupted++;
+                        slab.release(h);
+                    }
+                    held.clear();
+                }
+            }
+            for (auto h : held)
+                slab.release(h);
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    TEST_ASSERT_EQUAL(0, corrupted.load());
+    TEST_ASSERT_TRUE(slab.getHighWater() <= SLAB_CAPACITY);
+}
+
+// Flood load: a queue that is mostly full, with packets released out of order, interleaved with allocations of other sizes
+static double flood(Allocator<meshtastic_MeshPacket> &pool, size_t &heapInUse, size_t &heapTotal)
+{
+    const int rounds = 200000;
+    std::vector<meshtastic_MeshPacket *> held(SLAB_CAPACITY, nullptr);
+    std::vector<void *> other(16, nullptr);
+    uint32_t rnd = 1;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        rnd = rnd * 1664525 + 1013904223;
+        auto &slot = held[rnd % held.size()];
+        if (slot)
+            pool.release(slot);
+        slot = pool.allocZeroed();
+
+        auto &o = other[(rnd >> 8) % other.size()];
+        free(o);
+        o = malloc(16 + (rnd >> 16) % 512);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+#ifdef __GLIBC__
+    struct mallinfo2 mi = mallinfo2();
+    heapInUse = mi.uordblks;
+    heapTotal = mi.arena;
+#else
+    heapInUse = heapTotal = 0;
+#endif
+    for (auto p : held)
+        if (p)
+            pool.release(p);
+    for (auto o : other)
+        free(o);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)rounds;
+}
+
+void test_benchmark(void)
+{
+    MemoryDynamic<meshtastic_MeshPacket> dynamic;
+    MemorySlab<meshtastic_MeshPacket> slab(SLAB_CAPACITY);
+    size_t dynamicInUse, dynamicTotal, slabInUse, slabTotal;
+
+    double dynamicNs = flood(dynamic, dynamicInUse, dynamicTotal);
+    double slabNs = flood(slab, slabInUse, slabTotal);
+
+    printf("malloc: %.1f ns per release+alloc, heap %zu in use of %zu\n", dynamicNs, dynamicInUse, dynamicTotal);
+    printf("slab:   %.1f ns per release+alloc, heap %zu in use of %zu, high water %u, exhausted %u\n", slabNs, slabInUse,
+           slabTotal, slab.getHighWater(), slab.getExhausted());
+    TEST_ASSERT_EQUAL(0, slab.getExhausted());
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_alloc_release);
+    RUN_TEST(test_exhaustion);
+    RUN_TEST(test_threads);
+    RUN_TEST(test_benchmark);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,110 @@
+#include "mesh/NeighborTable.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+#include <vector>
+
+static const uint32_t NOW = 1700000000;
+static const uint32_t INTERVAL = 900;
+
+static NeighborTable table;
+
+static std::vector<NodeNum> listNeighbors()
+{
+    std::vector<NodeNum> nodes;
+    table.forEach([&nodes](const NeighborTable::Neighbor &n) { nodes.push_back(n.node); });
+    return nodes;
+}
+
+void setUp(void)
+{
+    table.clear();
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_update_and_smoothing(void)
+{
+    table.update(0x1234, -8, NOW, 0, INTERVAL);
+    TEST_ASSERT_EQUAL(1, table.size());
+    const NeighborTable::Neighbor *n = table.find(0x1234, NOW);
+    TEST_ASSERT_NOT_NULL(n);
+    TEST_ASSERT_EQUAL_FLOAT(-8, n->snr);
+    TEST_ASSERT_EQUAL(INTERVAL, n->broadcastIntervalSecs);
+
+    // A single outlier only moves the average part of the way
+    table.update(0x1234, 4, NOW + 10, 0, INTERVAL);
+    TEST_ASSERT_EQUAL(1, table.size());
+    TEST_ASSERT_EQUAL_FLOAT(-8 + 12.0f / NEIGHBOR_SNR_SMOOTHING, n->snr);
+    TEST_ASSERT_EQUAL(NOW + 10, n->lastRxTime);
+
+    // The interval the neighbor tells us about wins over the assumed one
+    table.update(0x1234, 4, NOW + 20, 300, INTERVAL);
+    TEST_ASSERT_EQUAL(300, n->broadcastIntervalSecs);
+    TEST_ASSERT_NULL(table.find(0x5678, NOW));
+}
+
+void test_expiry(void)
+{
+    table.update(1, 0, NOW, 100, INTERVAL);
+    table.update(2, 0, NOW, 0, INTERVAL);
+    table.update(3, 0, NOW + 50, 100, INTERVAL);
+
+    // Ordered by when they expire, the last to go first
+    std::vector<NodeNum> expected = {2, 3, 1};
+    TEST_ASSERT_TRUE(listNeighbors() == expected);
+
+    TEST_ASSERT_NOT_NULL(table.find(1, NOW + 200));
+    TEST_ASSERT_NULL(table.find(1, NOW + 201));
+
+    table.removeExpired(NOW + 300, 3);
+    expected = {2, 3};
+    TEST_ASSERT_TRUE(listNeighbors() == expected);
+    TEST_ASSERT_EQUAL(2, table.size());
+
+    // Hearing a neighbor again moves it to the back of the expiry list
+    table.update(3, 0, NOW + 2 * INTERVAL, 0, INTERVAL);
+    expected = {3, 2};
+    TEST_ASSERT_TRUE(listNeighbors() == expected);
+}
+
+void test_full_table(void)
+{
+    // Colliding hashes don't matter, every node gets its own slot
+    for (uint32_t i = 0; i < NEIGHBOR_TABLE_SIZE; i++)
+        table.update(0x1000 + i * NEIGHBOR_TABLE_SIZE, 0, NOW + i, 0, INTERVAL);
+    TEST_ASSERT_EQUAL(NEIGHBOR_TABLE_SIZE, table.size());
+    for (uint32_t i = 0; i < NEIGHBOR_TABLE_SIZE; i++)
+        TEST_ASSERT_NOT_NULL(table.find(0x1000 + i * NEIGHBOR_TABLE_SIZE, NOW));
+
+    // The one closest to expiry makes room
+    table.update(0x9999, 0, NOW + NEIGHBOR_TABLE_SIZE, 0, INTERVAL);
+    TEST_ASSERT_EQUAL(NEIGHBOR_TABLE_SIZE, table.size());
+    TEST_ASSERT_NULL(table.find(0x1000, NOW));
+    TEST_ASSERT_NOT_NULL(table.find(0x9999, NOW));
+    TEST_ASSERT_NOT_NULL(table.find(0x1000 + NEIGHBOR_TABLE_SIZE, NOW));
+
+    table.removeExpired(NOW + 10 * INTERVAL, 0);
+    TEST_ASSERT_EQUAL(0, table.size());
+    TEST_ASSERT_TRUE(listNeighbors().empty());
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_update_and_smoothing);
+    RUN_TEST(test_expiry);
+    RUN_TEST(test_full_table);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
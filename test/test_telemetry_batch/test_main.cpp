@@ -0,0 +1,153 @@
+#include "modules/Telemetry/TelemetryBatch.h"
+
+#include "TestUtil.h"
+#include <unity.h>
+
+static const uint32_t START = 1700000000;
+static const uint32_t WINDOW = 900;
+
+static meshtastic_Telemetry environment(float temperature, float humidity)
+{
+    meshtastic_Telemetry m = meshtastic_Telemetry_init_zero;
+    m.which_variant = meshtastic_Telemetry_environment_metrics_tag;
+    m.variant.environment_metrics.has_temperature = true;
+    m.variant.environment_metrics.temperature = temperature;
+    if (humidity >= 0) {
+        m.variant.environment_metrics.has_relative_humidity = true;
+        m.variant.environment_metrics.relative_humidity = humidity;
+    }
+    return m;
+}
+
+// Four windows of three samples each, the third one without humidity
+static void fill(TelemetryAggregator &aggregator)
+{
+    for (uint8_t w = 0; w < 4; w++) {
+        for (uint8_t i = 0; i < 3; i++)
+            aggregator.add(environment(20 + w + i * 0.5f, w == 2 ? -1 : 60 - w * 2 + i), (w * 3 + i) * 60000);
+        TEST_ASSERT_EQUAL(w == 3, aggregator.closeWindow(START + w * WINDOW));
+    }
+}
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+void test_roundtrip(void)
+{
+    TelemetryAggregator aggregator(meshtastic_Telemetry_environment_metrics_tag);
+    fill(aggregator);
+    TEST_ASSERT_EQUAL(4, aggregator.windowCount());
+
+    uint8_t buf[meshtastic_Constants_DATA_PAYLOAD_LEN];
+    size_t len = aggregator.encode(buf, sizeof(buf));
+    TEST_ASSERT_GREATER_THAN(0, len);
+    TEST_ASSERT_EQUAL(TelemetryBatch::VERSION, buf[0]);
+    TEST_ASSERT_EQUAL(0, aggregator.windowCount());
+
+    TelemetryBatch::Batch batch;
+    TEST_ASSERT_TRUE(TelemetryBatch::decode(buf, len, batch));
+    TEST_ASSERT_EQUAL(meshtastic_Telemetry_environment_metrics_tag, batch.variant);
+    TEST_ASSERT_EQUAL(START + 3 * WINDOW, batch.time);
+    TEST_ASSERT_EQUAL(WINDOW, batch.windowSecs);
+    TEST_ASSERT_EQUAL(4, batch.count);
+
+    for (uint8_t w = 0; w < 4; w++) {
+        TelemetryBatch::Stats stats;
+        TEST_ASSERT_EQUAL(START + w * WINDOW, TelemetryBatch::windowEnd(batch, w));
+        TEST_ASSERT_TRUE(TelemetryBatch::getStats(batch, w, 0, stats));
+        TEST_ASSERT_FLOAT_WITHIN(0.01, 20 + w, stats.min);
+        TEST_ASSERT_FLOAT_WITHIN(0.01, 20.5 + w, stats.mean);
+        TEST_ASSERT_FLOAT_WITHIN(0.01, 21 + w, stats.max);
+
+        bool hasHumidity = TelemetryBatch::getStats(batch, w, 1, stats);
+        TEST_ASSERT_EQUAL(w != 2, hasHumidity);
+        if (hasHumidity)
+            TEST_ASSERT_FLOAT_WITHIN(0.1, 61 - w * 2, stats.mean);
+    }
+    TEST_ASSERT_EQUAL_STRING("relative_humidity", TelemetryBatch::fieldName(batch.variant, 1));
+
+    meshtastic_Telemetry m;
+    TelemetryBatch::getMeans(batch, 3, m);
+    TEST_ASSERT_EQUAL(START + 3 * WINDOW, m.time);
+    TEST_ASSERT_TRUE(m.variant.environment_metrics.has_temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 23.5, m.variant.environment_metrics.temperature);
+    TEST_ASSERT_FALSE(m.variant.environment_metrics.has_lux);
+}
+
+void test_drops_oldest(void)
+{
+    TelemetryAggregator aggregator(meshtastic_Telemetry_environment_metrics_tag);
+    fill(aggregator);
+
+    uint8_t buf[32];
+    size_t len = aggregator.encode(buf, sizeof(buf));
+    TEST_ASSERT_GREATER_THAN(0, len);
+
+    TelemetryBatch::Batch batch;
+    TEST_ASSERT_TRUE(TelemetryBatch::decode(buf, len, batch));
+    TEST_ASSERT_LESS_THAN(4, batch.count);
+    TEST_ASSERT_EQUAL(START + 3 * WINDOW, batch.time);
+
+    // The newest window is always the last one
+    TelemetryBatch::Stats stats;
+    TEST_ASSERT_TRUE(TelemetryBatch::getStats(batch, batch.count - 1, 0, stats));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 23.5, stats.mean);
+}
+
+void test_not_a_batch(void)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.decoded.portnum = meshtastic_PortNum_TELEMETRY_APP;
+    p.decoded.payload.size = 2;
+    TEST_ASSERT_FALSE(TelemetryBatch::isBatch(p));
+    p.decoded.portnum = TELEMETRY_BATCH_PORTNUM;
+    TEST_ASSERT_TRUE(TelemetryBatch::isBatch(p));
+    p.which_payload_variant = meshtastic_MeshPacket_encrypted_tag;
+    TEST_ASSERT_FALSE(TelemetryBatch::isBatch(p));
+
+    TelemetryAggregator aggregator(meshtastic_Telemetry_power_metrics_tag);
+    aggregator.add(environment(20, 50), 0);
+    aggregator.closeWindow(START);
+    uint8_t buf[64];
+    size_t len = aggregator.encode(buf, sizeof(buf));
+    TelemetryBatch::Batch batch;
+    TEST_ASSERT_TRUE(TelemetryBatch::decode(buf, len, batch));
+    TEST_ASSERT_TRUE(batch.entries.empty());
+    TEST_ASSERT_FALSE(TelemetryBatch::decode(buf, len - 1, batch));
+}
+
+void test_sample_due(void)
+{
+    TelemetryAggregator aggregator(meshtastic_Telemetry_environment_metrics_tag);
+    TEST_ASSERT_TRUE(aggregator.isSampleDue(0));
+    aggregator.add(environment(20, 50), UINT32_MAX - 1000);
+    TEST_ASSERT_FALSE(aggregator.isSampleDue(UINT32_MAX));
+    TEST_ASSERT_FALSE(aggregator.isSampleDue(TELEMETRY_BATCH_SAMPLE_SECS * 1000UL - 1002));
+    TEST_ASSERT_TRUE(aggregator.isSampleDue(TELEMETRY_BATCH_SAMPLE_SECS * 1000UL - 1001));
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_roundtrip);
+    RUN_TEST(test_drops_oldest);
+    RUN_TEST(test_sample_due);
+    RUN_TEST(test_not_a_batch);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}